@@ -13,10 +13,34 @@
 #include "ES_Types.h"     /* gets bool type for returns */
 #include "ES_Events.h" 
 
+// what a command waits for before the next one may start, sent as the
+// EventParam of MOTION_DONE
+typedef enum {
+	DONE_NOT_WAITING = 0,
+	DONE_ON_RAMP,    /* motion profile reached the target duty */
+	DONE_ON_TURN,    /* measured turn or its one-shot backup ended */
+	DONE_ON_BEACON,  /* IR capture found the beacon */
+	DONE_ON_TAPE     /* tape sensor fired */
+} MotionDone_t;
+
+// idle gaps between one motion finishing and the next one starting
+typedef struct {
+	uint32_t Motions;     /* commands started */
+	uint32_t Gaps;        /* gaps measured, the first command has none */
+	uint32_t BackToBack;  /* next command was already prefetched */
+	uint32_t LastGapUS;
+	uint32_t MaxGapUS;
+	uint32_t TotalGapUS;
+} PipelineStats_t;
+
 // Public Function Prototypes
 bool InitializeActionService(uint8_t Priority);
 bool PostActionService(ES_Event ThisEvent);
 ES_Event RunActionService(ES_Event ThisEvent);	
+uint16_t GetUnknownCommandCount(void);
+void PostMotionDone(MotionDone_t Source);
+void GetPipelineStats(PipelineStats_t *pStats);
+void ClearPipelineStats(void);
 void OneShotISR(void);
 void InputCaptureForIRDetectionResponse(void);
 void EnableIRInterrupt(void);
@@ -0,0 +1,23 @@
+/****************************************************************************
+
+  Header file for Beacon Bearing Module
+ ****************************************************************************/
+
+#ifndef BeaconBearingModule_H
+#define BeaconBearingModule_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// strength is logged in this many heading bins over the turn
+#define BEARING_BINS 64
+
+// Public Function Prototypes
+void StartBearingSweep(void);
+bool LogBeaconBlock(uint32_t BlockEndUS, uint16_t Strength);
+bool AddBearingSample(uint32_t Heading, uint16_t Strength);
+bool EstimateBearing(uint32_t *pHeading);
+int16_t BearingTurnDegrees(uint32_t Bearing);
+
+#endif
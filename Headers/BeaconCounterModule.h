@@ -0,0 +1,39 @@
+/****************************************************************************
+
+  Header file for Beacon Counter Module
+ ****************************************************************************/
+
+#ifndef BeaconCounterModule_H
+#define BeaconCounterModule_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// gate window, one interrupt per window whatever the beacon frequency.
+// The count is good to an edge, so the frequency to 1000/BEACON_GATE_MS Hz
+#define BEACON_GATE_MS 20
+// windows in a row a new band must be seen in before it is reported
+#define BEACON_CONFIRM_WINDOWS 2
+
+// entries in the beacon band table, BEACON_NONE for no beacon
+typedef enum {
+	BEACON_LAB,
+	BEACON_909,
+	BEACON_1250,
+	BEACON_3333,
+	NUM_BEACONS,
+	BEACON_NONE = 0xff
+} Beacon_t;
+
+// Public Function Prototypes
+void InitBeaconCounter(void);
+void StartBeaconCounter(Beacon_t Target);
+void StopBeaconCounter(void);
+Beacon_t ClassifyBeacon(uint32_t Hz);
+char const *GetBeaconName(Beacon_t Beacon);
+Beacon_t QueryBeacon(void);
+uint32_t QueryBeaconHz(void);
+void BeaconGateISR(void);
+
+#endif
@@ -0,0 +1,35 @@
+/****************************************************************************
+
+  Header file for Clock Config
+	The system clock, and the timer tick rates every module derives its
+	timing constants from. Change CPU_CLOCK_HZ here and nowhere else
+ ****************************************************************************/
+
+#ifndef ClockConfig_H
+#define ClockConfig_H
+
+// system clock from the 400 MHz PLL (16 MHz crystal), divided by 2 and
+// then by the SYSDIV that goes with it below
+#define CPU_CLOCK_HZ 80000000UL
+
+// what main and the test harnesses pass SysCtlClockSet, needs
+// driverlib/sysctl.h
+#if CPU_CLOCK_HZ == 80000000UL
+#define CPU_CLOCK_SYSDIV SYSCTL_SYSDIV_2_5
+#elif CPU_CLOCK_HZ == 50000000UL
+#define CPU_CLOCK_SYSDIV SYSCTL_SYSDIV_4
+#elif CPU_CLOCK_HZ == 40000000UL
+#define CPU_CLOCK_SYSDIV SYSCTL_SYSDIV_5
+#elif CPU_CLOCK_HZ == 20000000UL
+#define CPU_CLOCK_SYSDIV SYSCTL_SYSDIV_10
+#else
+#error CPU_CLOCK_HZ has no SYSDIV, use 80, 50, 40 or 20 MHz
+#endif
+#define CPU_CLOCK_SYSCTL (CPU_CLOCK_SYSDIV | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | \
+                          SYSCTL_XTAL_16MHZ)
+
+// the wide timers, SysTick and the DWT count the system clock
+#define TicksPerUS (CPU_CLOCK_HZ/1000000UL)
+#define TicksPerMS (CPU_CLOCK_HZ/1000UL)
+
+#endif
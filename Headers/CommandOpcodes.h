@@ -0,0 +1,36 @@
+/****************************************************************************
+ 
+  Header file for the command opcodes
+  The one list of the command bytes the command generator sends over SPI,
+  plus the internal commands the sensors post to ActionService
+ ****************************************************************************/
+
+#ifndef CommandOpcodes_H
+#define CommandOpcodes_H
+
+// X(Name, Value) for every opcode ActionService knows. To add a command,
+// add it here and give it an entry in ActionService's CommandTable
+#define COMMAND_OPCODES(X) \
+	X(STOP,               0x00) \
+	X(CW_90,              0x02) \
+	X(CW_45,              0x03) \
+	X(CCW_90,             0x04) \
+	X(CCW_45,             0x05) \
+	X(END_RUN_CMD,        0x06) /* internal, posted when tape is sensed */ \
+	X(FORWARD_HALF_SPEED, 0x08) \
+	X(FORWARD_FULL_SPEED, 0x09) \
+	X(REVERSE_HALF_SPEED, 0x10) \
+	X(REVERSE_FULL_SPEED, 0x11) \
+	X(ALIGN_BEACON,       0x20) \
+	X(DRIVE2TAPE,         0x40)
+
+#define OPCODE_ENUM_ENTRY(Name, Value) Name = Value,
+typedef enum { COMMAND_OPCODES(OPCODE_ENUM_ENTRY) } CommandOpcode_t;
+
+// sent before every command, only the byte after it is acted on
+#define READY4NEXTCOMMAND 0xff
+
+// one entry per possible SPI byte
+#define NUM_OPCODES 256
+
+#endif
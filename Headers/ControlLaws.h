@@ -0,0 +1,47 @@
+/****************************************************************************
+
+  Header file for Control Laws
+ ****************************************************************************/
+
+#ifndef ControlLaws_H
+#define ControlLaws_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// PID in floating point. Ki and Kd are per call, the sample time folded in.
+// The integral is clamped to the output range so it cannot wind up
+typedef struct {
+	float Kp, Ki, Kd;
+	float OutMin, OutMax;
+	float Integral;
+	float LastError;
+} PIDFloat_t;
+
+// the same in fixed point: gains in Q16, error and output integers
+typedef struct {
+	int32_t Kp, Ki, Kd;
+	int16_t OutMin, OutMax;
+	int32_t Integral;      // Q16
+	int32_t LastError;
+} PIDFixed_t;
+
+// biquad, y = b0 x + b1 x1 + b2 x2 + a1 y1 + a2 y2, as BiquadQ15
+typedef struct {
+	float Coeffs[5];       // b0, b1, b2, a1, a2
+	float X1, X2, Y1, Y2;
+} BiquadFloat_t;
+
+// Q16 from a non-negative float gain, for constants only
+#define PID_GAIN_Q16(Gain) ((int32_t)((Gain)*65536.0f + 0.5f))
+
+// Public Function Prototypes
+void PIDInitFloat(PIDFloat_t *pPID, float Kp, float Ki, float Kd, float OutMin, float OutMax);
+float PIDFloat(PIDFloat_t *pPID, float Error);
+void PIDInitFixed(PIDFixed_t *pPID, int32_t Kp, int32_t Ki, int32_t Kd, int16_t OutMin, int16_t OutMax);
+int16_t PIDFixed(PIDFixed_t *pPID, int32_t Error);
+void BiquadInitFloat(BiquadFloat_t *pBiquad, float const *pCoeffs);
+void BiquadFloat(BiquadFloat_t *pBiquad, float const *pIn, float *pOut, uint16_t NumSamples);
+
+#endif
@@ -0,0 +1,27 @@
+/****************************************************************************
+ 
+  Header file for DMA Manager
+ ****************************************************************************/
+
+#ifndef DMAManager_H
+#define DMAManager_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+#define NUM_DMA_CHANNELS 32
+// most items one ArmDMAFromRegister can move
+#define MAX_DMA_TRANSFER 1024
+
+// Public Function Prototypes
+bool ClaimDMAChannel(uint32_t Assignment, char const *Owner);
+void ArmDMAFromRegister(uint8_t Channel, bool Alternate, uint32_t Register,
+                        uint32_t *pDest, uint16_t Count);
+bool IsDMAHalfDone(uint8_t Channel, bool Alternate);
+void EnableDMAChannel(uint8_t Channel);
+void DisableDMAChannel(uint8_t Channel);
+uint8_t GetDMAConflicts(void);
+void PrintDMAAllocations(void);
+
+#endif
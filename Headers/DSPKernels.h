@@ -0,0 +1,109 @@
+/****************************************************************************
+
+  Header file for DSP Kernels
+ ****************************************************************************/
+
+#ifndef DSPKernels_H
+#define DSPKernels_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// The Cortex-M4 DSP instructions through the armcc intrinsics on the
+// target, and C that gives the same bits everywhere else, so the kernels
+// can be checked on the host
+#if defined(__ARMCC_VERSION) && defined(__TARGET_FEATURE_DSPMUL)
+#define DSP_SSUB16(a, b)          __ssub16((a), (b))
+#define DSP_QADD16(a, b)          __qadd16((a), (b))
+#define DSP_SMLAD(a, b, Acc)      __smlad((a), (b), (Acc))
+#define DSP_SMLALD(a, b, Acc)     __smlald((a), (b), (Acc))
+#define DSP_SSAT(x, Bits)         __ssat((x), (Bits))
+// a pair from any halfword, LDR takes unaligned addresses on the M4
+#define DSP_READ_PAIR(p)          (*(__packed int32_t const *)(p))
+#else
+#define DSP_SSUB16(a, b)          DSPSsub16((a), (b))
+#define DSP_QADD16(a, b)          DSPQadd16((a), (b))
+#define DSP_SMLAD(a, b, Acc)      DSPSmlad((a), (b), (Acc))
+#define DSP_SMLALD(a, b, Acc)     DSPSmlald((a), (b), (Acc))
+#define DSP_SSAT(x, Bits)         DSPSsat((x), (Bits))
+#define DSP_READ_PAIR(p)          DSPReadPair(p)
+int32_t DSPSsub16(int32_t a, int32_t b);
+int32_t DSPQadd16(int32_t a, int32_t b);
+int32_t DSPSmlad(int32_t a, int32_t b, int32_t Acc);
+int64_t DSPSmlald(int32_t a, int32_t b, int64_t Acc);
+int32_t DSPSsat(int32_t x, uint8_t Bits);
+int32_t DSPReadPair(int16_t const *p);
+#endif
+
+// the compilers turn these into a single PKHBT and SMMULR
+#define DSP_PKHBT(Lo, Hi) (((uint32_t)(Lo) & 0xffff) | ((uint32_t)(Hi) << 16))
+#define DSP_SMMULR(a, b)  ((int32_t)(((int64_t)(a)*(b) + 0x80000000LL) >> 32))
+
+// FIR filters keep the last NumTaps - 1 inputs ahead of the block in
+// their state, so it is this long for the longest block
+#define FIR_STATE_LEN(NumTaps, Block) ((NumTaps) - 1 + (Block))
+
+// Q15 FIR: an even number of taps, oldest first (h[NumTaps - 1] first),
+// summing in magnitude to under 2.0 so SMLAD's 32 bit sum cannot wrap
+typedef struct {
+	int16_t const *pCoeffs;
+	int16_t *pState;
+	uint16_t NumTaps;
+} FirQ15_t;
+
+// Q31 FIR: any number of taps, oldest first
+typedef struct {
+	int32_t const *pCoeffs;
+	int32_t *pState;
+	uint16_t NumTaps;
+} FirQ31_t;
+
+// biquad, y = b0 x + b1 x1 + b2 x2 + a1 y1 + a2 y2 (the feedback
+// coefficients are added), in Q15 - PostShift so they can reach 2^PostShift
+typedef struct {
+	int16_t B0;
+	int32_t B12;        // b1, b2 packed
+	int32_t A12;        // a1, a2 packed
+	int32_t X12;        // x[n-1], x[n-2] packed
+	int32_t Y12;        // y[n-1], y[n-2] packed
+	uint8_t PostShift;
+} BiquadQ15_t;
+
+// the same in Q31 - PostShift
+typedef struct {
+	int32_t Coeffs[5];  // b0, b1, b2, a1, a2
+	int32_t X1, X2, Y1, Y2;
+	uint8_t PostShift;
+} BiquadQ31_t;
+
+// average of the last 2^Shift samples, a running sum and a shift
+typedef struct {
+	int16_t *pWindow;   // 2^Shift samples
+	int32_t Sum;
+	uint16_t Index;
+	uint8_t Shift;
+} MovingAverageQ15_t;
+
+// Public Function Prototypes
+int32_t PackRemoveMean(uint32_t const *pSamples, int32_t *pPairs, uint16_t NumSamples);
+uint64_t PairEnergy(int32_t const *pPairs, uint16_t NumPairs);
+int32_t GoertzelCoefficient(uint32_t FreqHz, uint32_t SampleHz);
+uint64_t GoertzelPower(int32_t CosQ31, int32_t const *pPairs, uint16_t NumPairs);
+uint32_t Sqrt64(uint64_t Value);
+bool FirInitQ15(FirQ15_t *pFir, int16_t const *pCoeffs, uint16_t NumTaps, int16_t *pState);
+void FirQ15(FirQ15_t *pFir, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples);
+void DecimateQ15(FirQ15_t *pFir, uint8_t Factor, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples);
+void FirInitQ31(FirQ31_t *pFir, int32_t const *pCoeffs, uint16_t NumTaps, int32_t *pState);
+void FirQ31(FirQ31_t *pFir, int32_t const *pIn, int32_t *pOut, uint16_t NumSamples);
+void BiquadInitQ15(BiquadQ15_t *pBiquad, int16_t const *pCoeffs, uint8_t PostShift);
+void BiquadQ15(BiquadQ15_t *pBiquad, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples);
+void BiquadInitQ31(BiquadQ31_t *pBiquad, int32_t const *pCoeffs, uint8_t PostShift);
+void BiquadQ31(BiquadQ31_t *pBiquad, int32_t const *pIn, int32_t *pOut, uint16_t NumSamples);
+void MovingAverageInitQ15(MovingAverageQ15_t *pAverage, int16_t *pWindow, uint8_t Shift);
+void MovingAverageQ15(MovingAverageQ15_t *pAverage, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples);
+int64_t DotQ15(int32_t const *pA, int32_t const *pB, uint16_t NumPairs);
+int64_t DotQ31(int32_t const *pA, int32_t const *pB, uint16_t Num);
+void AddQ15(int32_t const *pA, int32_t const *pB, int32_t *pOut, uint16_t NumPairs);
+
+#endif
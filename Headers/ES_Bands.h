@@ -0,0 +1,39 @@
+/****************************************************************************
+ Module
+     ES_Bands.h
+ Description
+     header file for the preemptive priority bands of the ES scheduler
+ Notes
+     Band 0 is ES_Run in the main loop. Each band above it is a software
+     triggered interrupt at a priority below the hardware ISRs, so a post
+     to a band 1 service runs it as soon as the poster (and any ISR above
+     band 1) is done, even while a band 0 service is in the middle of a
+     long run function. Services in one band never preempt each other.
+     A service in a higher band must not share data with a lower band
+     service without a critical section.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 22:00 t16      started coding
+*****************************************************************************/
+#ifndef ES_Bands_H
+#define ES_Bands_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+// post to run start, in CPU cycles from the DWT cycle counter. Only the
+// oldest waiting post is timed each time the band starts on its queues
+typedef struct {
+  uint32_t Runs;        // run functions called from the band
+  uint32_t LastCycles;
+  uint32_t MaxCycles;
+} ES_BandStats_t;
+
+void ES_BandsInit( void );
+void ES_BandTrigger( uint8_t Band );
+void ES_Band1Handler( void );
+void ES_Band2Handler( void );
+
+#endif /* ES_Bands_H */
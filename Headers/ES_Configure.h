@@ -1,337 +1,475 @@
-/****************************************************************************
- Module
-     ES_Configure.h
- Description
-     This file contains macro definitions that are edited by the user to
-     adapt the Events and Services framework to a particular application.
- Notes
-     
- History
- When           Who     What/Why
- -------------- ---     --------
-  10/11/15 18:00 jec      added new event type ES_SHORT_TIMEOUT
-  10/21/13 20:54 jec      lots of added entries to bring the number of timers
-                         and services up to 16 each
- 08/06/13 14:10 jec      removed PostKeyFunc stuff since we are moving that
-                         functionality out of the framework and putting it
-                         explicitly into the event checking functions
- 01/15/12 10:03 jec      started coding
-*****************************************************************************/
-
-#ifndef CONFIGURE_H
-#define CONFIGURE_H
-
-/****************************************************************************/
-// The maximum number of services sets an upper bound on the number of 
-// services that the framework will handle. Reasonable values are 8 and 16
-// corresponding to an 8-bit(uint8_t) and 16-bit(uint16_t) Ready variable size
-#define MAX_NUM_SERVICES 16
-
-/****************************************************************************/
-// This macro determines that nuber of services that are *actually* used in
-// a particular application. It will vary in value from 1 to MAX_NUM_SERVICES
-#define NUM_SERVICES 2
-
-/****************************************************************************/
-// These are the definitions for Service 0, the lowest priority service.
-// Every Events and Services application must have a Service 0. Further 
-// services are added in numeric sequence (1,2,3,...) with increasing 
-// priorities
-// the header file with the public function prototypes
-#define SERV_0_HEADER "ActionService.h"
-// the name of the Init function
-#define SERV_0_INIT InitializeActionService
-// the name of the run function
-#define SERV_0_RUN RunActionService
-// How big should this services Queue be?
-#define SERV_0_QUEUE_SIZE 5
-
-/****************************************************************************/
-// The following sections are used to define the parameters for each of the
-// services. You only need to fill out as many as the number of services 
-// defined by NUM_SERVICES
-/****************************************************************************/
-// These are the definitions for Service 1
-#if NUM_SERVICES > 1
-// the header file with the public function prototypes
-#define SERV_1_HEADER "SPIService.h"
-// the name of the Init function
-#define SERV_1_INIT InitSPIService
-// the name of the run function
-#define SERV_1_RUN RunSPIService
-// How big should this services Queue be?
-#define SERV_1_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 2
-#if NUM_SERVICES > 2
-// the header file with the public function prototypes
-#define SERV_2_HEADER "TestHarnessService2.h"
-// the name of the Init function
-#define SERV_2_INIT InitTestHarnessService2
-// the name of the run function
-#define SERV_2_RUN RunTestHarnessService2
-// How big should this services Queue be?
-#define SERV_2_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 3
-#if NUM_SERVICES > 3
-// the header file with the public function prototypes
-#define SERV_3_HEADER "TestHarnessService3.h"
-// the name of the Init function
-#define SERV_3_INIT InitTestHarnessService3
-// the name of the run function
-#define SERV_3_RUN RunTestHarnessService3
-// How big should this services Queue be?
-#define SERV_3_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 4
-#if NUM_SERVICES > 4
-// the header file with the public function prototypes
-#define SERV_4_HEADER "TestHarnessService4.h"
-// the name of the Init function
-#define SERV_4_INIT InitTestHarnessService4
-// the name of the run function
-#define SERV_4_RUN RunTestHarnessService4
-// How big should this services Queue be?
-#define SERV_4_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 5
-#if NUM_SERVICES > 5
-// the header file with the public function prototypes
-#define SERV_5_HEADER "TestHarnessService5.h"
-// the name of the Init function
-#define SERV_5_INIT InitTestHarnessService5
-// the name of the run function
-#define SERV_5_RUN RunTestHarnessService5
-// How big should this services Queue be?
-#define SERV_5_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 6
-#if NUM_SERVICES > 6
-// the header file with the public function prototypes
-#define SERV_6_HEADER "TestHarnessService6.h"
-// the name of the Init function
-#define SERV_6_INIT InitTestHarnessService6
-// the name of the run function
-#define SERV_6_RUN RunTestHarnessService6
-// How big should this services Queue be?
-#define SERV_6_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 7
-#if NUM_SERVICES > 7
-// the header file with the public function prototypes
-#define SERV_7_HEADER "TestHarnessService7.h"
-// the name of the Init function
-#define SERV_7_INIT InitTestHarnessService7
-// the name of the run function
-#define SERV_7_RUN RunTestHarnessService7
-// How big should this services Queue be?
-#define SERV_7_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 8
-#if NUM_SERVICES > 8
-// the header file with the public function prototypes
-#define SERV_8_HEADER "TestHarnessService8.h"
-// the name of the Init function
-#define SERV_8_INIT InitTestHarnessService8
-// the name of the run function
-#define SERV_8_RUN RunTestHarnessService8
-// How big should this services Queue be?
-#define SERV_8_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 9
-#if NUM_SERVICES > 9
-// the header file with the public function prototypes
-#define SERV_9_HEADER "TestHarnessService9.h"
-// the name of the Init function
-#define SERV_9_INIT InitTestHarnessService9
-// the name of the run function
-#define SERV_9_RUN RunTestHarnessService9
-// How big should this services Queue be?
-#define SERV_9_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 10
-#if NUM_SERVICES > 10
-// the header file with the public function prototypes
-#define SERV_10_HEADER "TestHarnessService10.h"
-// the name of the Init function
-#define SERV_10_INIT InitTestHarnessService10
-// the name of the run function
-#define SERV_10_RUN RunTestHarnessService10
-// How big should this services Queue be?
-#define SERV_10_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 11
-#if NUM_SERVICES > 11
-// the header file with the public function prototypes
-#define SERV_11_HEADER "TestHarnessService11.h"
-// the name of the Init function
-#define SERV_11_INIT InitTestHarnessService11
-// the name of the run function
-#define SERV_11_RUN RunTestHarnessService11
-// How big should this services Queue be?
-#define SERV_11_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 12
-#if NUM_SERVICES > 12
-// the header file with the public function prototypes
-#define SERV_12_HEADER "TestHarnessService12.h"
-// the name of the Init function
-#define SERV_12_INIT InitTestHarnessService12
-// the name of the run function
-#define SERV_12_RUN RunTestHarnessService12
-// How big should this services Queue be?
-#define SERV_12_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 13
-#if NUM_SERVICES > 13
-// the header file with the public function prototypes
-#define SERV_13_HEADER "TestHarnessService13.h"
-// the name of the Init function
-#define SERV_13_INIT InitTestHarnessService13
-// the name of the run function
-#define SERV_13_RUN RunTestHarnessService13
-// How big should this services Queue be?
-#define SERV_13_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 14
-#if NUM_SERVICES > 14
-// the header file with the public function prototypes
-#define SERV_14_HEADER "TestHarnessService14.h"
-// the name of the Init function
-#define SERV_14_INIT InitTestHarnessService14
-// the name of the run function
-#define SERV_14_RUN RunTestHarnessService14
-// How big should this services Queue be?
-#define SERV_14_QUEUE_SIZE 3
-#endif
-
-/****************************************************************************/
-// These are the definitions for Service 15
-#if NUM_SERVICES > 15
-// the header file with the public function prototypes
-#define SERV_15_HEADER "TestHarnessService15.h"
-// the name of the Init function
-#define SERV_15_INIT InitTestHarnessService15
-// the name of the run function
-#define SERV_15_RUN RunTestHarnessService15
-// How big should this services Queue be?
-#define SERV_15_QUEUE_SIZE 3
-#endif
-
-
-/****************************************************************************/
-// Name/define the events of interest
-// Universal events occupy the lowest entries, followed by user-defined events
-typedef enum {  ES_NO_EVENT = 0,
-                ES_ERROR,  /* used to indicate an error from the service */
-                ES_INIT,   /* used to transition from initial pseudo-state */
-                ES_TIMEOUT, /* signals that the timer has expired */
-                ES_SHORT_TIMEOUT, /* signals that a short timer has expired */
-                /* User-defined events start here */
-								ISR_COMMAND,
-								END_RUN,
-								NEXT_COMMAND,
-                ES_NEW_KEY, /* signals a new key received from terminal */
-								TapeSensed,
-								IRBeaconSensed
-                } ES_EventTyp_t ;
-
-/****************************************************************************/
-// These are the definitions for the Distribution lists. Each definition
-// should be a comma separated list of post functions to indicate which
-// services are on that distribution list.
-#define NUM_DIST_LISTS 0
-#if NUM_DIST_LISTS > 0 
-#define DIST_LIST0 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 1 
-#define DIST_LIST1 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 2 
-#define DIST_LIST2 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 3 
-#define DIST_LIST3 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 4 
-#define DIST_LIST4 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 5 
-#define DIST_LIST5 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 6 
-#define DIST_LIST6 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 7 
-#define DIST_LIST7 PostTemplateFSM
-#endif
-
-/****************************************************************************/
-// This are the name of the Event checking funcion header file. 
-#define EVENT_CHECK_HEADER "EventCheckers.h"
-
-/****************************************************************************/
-// This is the list of event checking functions 
-#define EVENT_CHECK_LIST Check4Keystroke
-
-/****************************************************************************/
-// These are the definitions for the post functions to be executed when the
-// corresponding timer expires. All 16 must be defined. If you are not using
-// a timer, then you should use TIMER_UNUSED
-// Unlike services, any combination of timers may be used and there is no
-// priority in servicing them
-#define TIMER_UNUSED ((pPostFunc)0)
-#define TIMER0_RESP_FUNC PostSPIService
-#define TIMER1_RESP_FUNC TIMER_UNUSED
-#define TIMER2_RESP_FUNC TIMER_UNUSED
-#define TIMER3_RESP_FUNC TIMER_UNUSED
-#define TIMER4_RESP_FUNC TIMER_UNUSED
-#define TIMER5_RESP_FUNC TIMER_UNUSED
-#define TIMER6_RESP_FUNC TIMER_UNUSED
-#define TIMER7_RESP_FUNC TIMER_UNUSED
-#define TIMER8_RESP_FUNC TIMER_UNUSED
-#define TIMER9_RESP_FUNC TIMER_UNUSED
-#define TIMER10_RESP_FUNC TIMER_UNUSED
-#define TIMER11_RESP_FUNC TIMER_UNUSED
-#define TIMER12_RESP_FUNC TIMER_UNUSED
-#define TIMER13_RESP_FUNC TIMER_UNUSED
-#define TIMER14_RESP_FUNC TIMER_UNUSED
-#define TIMER15_RESP_FUNC TIMER_UNUSED
-
-/****************************************************************************/
-// Give the timer numbers symbolc names to make it easier to move them
-// to different timers if the need arises. Keep these definitions close to the
-// definitions for the response functions to make it easier to check that
-// the timer number matches where the timer event will be routed
-// These symbolic names should be changed to be relevant to your application 
-
-#define SPI_TIMER 0
-
-#endif /* CONFIGURE_H */
+/****************************************************************************
+ Module
+     ES_Configure.h
+ Description
+     This file contains macro definitions that are edited by the user to
+     adapt the Events and Services framework to a particular application.
+ Notes
+     
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+  10/11/15 18:00 jec      added new event type ES_SHORT_TIMEOUT
+  10/21/13 20:54 jec      lots of added entries to bring the number of timers
+                         and services up to 16 each
+ 08/06/13 14:10 jec      removed PostKeyFunc stuff since we are moving that
+                         functionality out of the framework and putting it
+                         explicitly into the event checking functions
+ 01/15/12 10:03 jec      started coding
+*****************************************************************************/
+
+#ifndef CONFIGURE_H
+#define CONFIGURE_H
+
+/****************************************************************************/
+// The maximum number of services sets an upper bound on the number of 
+// services that the framework will handle. Reasonable values are 8 and 16
+// corresponding to an 8-bit(uint8_t) and 16-bit(uint16_t) Ready variable size
+#define MAX_NUM_SERVICES 16
+
+/****************************************************************************/
+// This macro determines that nuber of services that are *actually* used in
+// a particular application. It will vary in value from 1 to MAX_NUM_SERVICES
+#define NUM_SERVICES 2
+
+/****************************************************************************/
+// These are the definitions for Service 0, the lowest priority service.
+// Every Events and Services application must have a Service 0. Further 
+// services are added in numeric sequence (1,2,3,...) with increasing 
+// priorities
+// the header file with the public function prototypes
+#define SERV_0_HEADER "ActionService.h"
+// the name of the Init function
+#define SERV_0_INIT InitializeActionService
+// the name of the run function
+#define SERV_0_RUN RunActionService
+// How big should this services Queue be?
+#define SERV_0_QUEUE_SIZE 5
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_0_BAND 0
+
+/****************************************************************************/
+// The following sections are used to define the parameters for each of the
+// services. You only need to fill out as many as the number of services 
+// defined by NUM_SERVICES
+/****************************************************************************/
+// These are the definitions for Service 1
+#if NUM_SERVICES > 1
+// the header file with the public function prototypes
+#define SERV_1_HEADER "SPIService.h"
+// the name of the Init function
+#define SERV_1_INIT InitSPIService
+// the name of the run function
+#define SERV_1_RUN RunSPIService
+// How big should this services Queue be?
+#define SERV_1_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_1_BAND 1
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 2
+#if NUM_SERVICES > 2
+// the header file with the public function prototypes
+#define SERV_2_HEADER "TestHarnessService2.h"
+// the name of the Init function
+#define SERV_2_INIT InitTestHarnessService2
+// the name of the run function
+#define SERV_2_RUN RunTestHarnessService2
+// How big should this services Queue be?
+#define SERV_2_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_2_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 3
+#if NUM_SERVICES > 3
+// the header file with the public function prototypes
+#define SERV_3_HEADER "TestHarnessService3.h"
+// the name of the Init function
+#define SERV_3_INIT InitTestHarnessService3
+// the name of the run function
+#define SERV_3_RUN RunTestHarnessService3
+// How big should this services Queue be?
+#define SERV_3_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_3_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 4
+#if NUM_SERVICES > 4
+// the header file with the public function prototypes
+#define SERV_4_HEADER "TestHarnessService4.h"
+// the name of the Init function
+#define SERV_4_INIT InitTestHarnessService4
+// the name of the run function
+#define SERV_4_RUN RunTestHarnessService4
+// How big should this services Queue be?
+#define SERV_4_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_4_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 5
+#if NUM_SERVICES > 5
+// the header file with the public function prototypes
+#define SERV_5_HEADER "TestHarnessService5.h"
+// the name of the Init function
+#define SERV_5_INIT InitTestHarnessService5
+// the name of the run function
+#define SERV_5_RUN RunTestHarnessService5
+// How big should this services Queue be?
+#define SERV_5_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_5_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 6
+#if NUM_SERVICES > 6
+// the header file with the public function prototypes
+#define SERV_6_HEADER "TestHarnessService6.h"
+// the name of the Init function
+#define SERV_6_INIT InitTestHarnessService6
+// the name of the run function
+#define SERV_6_RUN RunTestHarnessService6
+// How big should this services Queue be?
+#define SERV_6_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_6_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 7
+#if NUM_SERVICES > 7
+// the header file with the public function prototypes
+#define SERV_7_HEADER "TestHarnessService7.h"
+// the name of the Init function
+#define SERV_7_INIT InitTestHarnessService7
+// the name of the run function
+#define SERV_7_RUN RunTestHarnessService7
+// How big should this services Queue be?
+#define SERV_7_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_7_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 8
+#if NUM_SERVICES > 8
+// the header file with the public function prototypes
+#define SERV_8_HEADER "TestHarnessService8.h"
+// the name of the Init function
+#define SERV_8_INIT InitTestHarnessService8
+// the name of the run function
+#define SERV_8_RUN RunTestHarnessService8
+// How big should this services Queue be?
+#define SERV_8_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_8_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 9
+#if NUM_SERVICES > 9
+// the header file with the public function prototypes
+#define SERV_9_HEADER "TestHarnessService9.h"
+// the name of the Init function
+#define SERV_9_INIT InitTestHarnessService9
+// the name of the run function
+#define SERV_9_RUN RunTestHarnessService9
+// How big should this services Queue be?
+#define SERV_9_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_9_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 10
+#if NUM_SERVICES > 10
+// the header file with the public function prototypes
+#define SERV_10_HEADER "TestHarnessService10.h"
+// the name of the Init function
+#define SERV_10_INIT InitTestHarnessService10
+// the name of the run function
+#define SERV_10_RUN RunTestHarnessService10
+// How big should this services Queue be?
+#define SERV_10_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_10_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 11
+#if NUM_SERVICES > 11
+// the header file with the public function prototypes
+#define SERV_11_HEADER "TestHarnessService11.h"
+// the name of the Init function
+#define SERV_11_INIT InitTestHarnessService11
+// the name of the run function
+#define SERV_11_RUN RunTestHarnessService11
+// How big should this services Queue be?
+#define SERV_11_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_11_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 12
+#if NUM_SERVICES > 12
+// the header file with the public function prototypes
+#define SERV_12_HEADER "TestHarnessService12.h"
+// the name of the Init function
+#define SERV_12_INIT InitTestHarnessService12
+// the name of the run function
+#define SERV_12_RUN RunTestHarnessService12
+// How big should this services Queue be?
+#define SERV_12_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_12_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 13
+#if NUM_SERVICES > 13
+// the header file with the public function prototypes
+#define SERV_13_HEADER "TestHarnessService13.h"
+// the name of the Init function
+#define SERV_13_INIT InitTestHarnessService13
+// the name of the run function
+#define SERV_13_RUN RunTestHarnessService13
+// How big should this services Queue be?
+#define SERV_13_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_13_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 14
+#if NUM_SERVICES > 14
+// the header file with the public function prototypes
+#define SERV_14_HEADER "TestHarnessService14.h"
+// the name of the Init function
+#define SERV_14_INIT InitTestHarnessService14
+// the name of the run function
+#define SERV_14_RUN RunTestHarnessService14
+// How big should this services Queue be?
+#define SERV_14_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_14_BAND 0
+#endif
+
+/****************************************************************************/
+// These are the definitions for Service 15
+#if NUM_SERVICES > 15
+// the header file with the public function prototypes
+#define SERV_15_HEADER "TestHarnessService15.h"
+// the name of the Init function
+#define SERV_15_INIT InitTestHarnessService15
+// the name of the run function
+#define SERV_15_RUN RunTestHarnessService15
+// How big should this services Queue be?
+#define SERV_15_QUEUE_SIZE 3
+// Which band does it run in when ES_PREEMPTIVE is set?
+#define SERV_15_BAND 0
+#endif
+
+
+/****************************************************************************/
+// Urgent actions, handlers are registered with ES_UrgentRegister and run
+// straight from an ISR (ES_UrgentRun) or from PendSV (ES_UrgentPend)
+typedef enum {  URGENT_STOP,  /* motors off at once */
+                URGENT_TURN_TIMEOUT, /* finish a timed out turn below the ceiling */
+                NUM_URGENT_ACTIONS
+                } ES_UrgentAction_t;
+
+/****************************************************************************/
+// ISRs timed with ES_ISR_ENTRY/ES_ISR_EXIT, see ES_IsrProfile.h. With
+// ES_ISR_PROFILE set to 0 the macros compile to nothing
+typedef enum {  ISR_TAPE,            /* tape capture, WT0A */
+                ISR_TURN_ONESHOT,    /* turn timeout, WT0B */
+                ISR_SPI,             /* SSI0 response */
+                ISR_IR_CAPTURE,      /* IR beacon capture, WT1A */
+                ISR_LEFT_ENCODER,    /* WT2A */
+                ISR_RIGHT_ENCODER,   /* WT2B */
+                ISR_MOTION_PROFILE,  /* ramp tick, WT3A */
+                ISR_BEACON_GATE,     /* IR edge count window, WT4A */
+                ISR_IR_ADC,          /* IR sample block, ADC1 SS3 uDMA done */
+                ISR_SHORT_TIMER,     /* TIMER5A match */
+                ISR_SYSTICK,         /* framework tick */
+                NUM_ES_ISRS
+                } ES_IsrId_t;
+#define ES_ISR_PROFILE 1
+
+/****************************************************************************/
+// Preemptive bands. With ES_PREEMPTIVE set to 1 each service runs in the band
+// named by its SERV_n_BAND. Band 0 runs from ES_Run in the main loop, bands
+// 1 and 2 run from the software triggered GPIO Port G and H interrupts (the
+// 64 pin part has neither port) and preempt the bands below them. Services
+// in the same band still run to completion in priority order. With
+// ES_PREEMPTIVE set to 0 every service runs from ES_Run, as before
+#define ES_PREEMPTIVE 1
+#define ES_NUM_BANDS 3
+
+/****************************************************************************/
+// Interrupt priorities, 0 is the highest and 7 the lowest. Framework
+// critical regions (ES_EnterCritical) raise BASEPRI to ES_CRITICAL_CEILING,
+// which holds off every interrupt at the ceiling or below but leaves the
+// safety ISRs above it live. A safety ISR must not call the framework
+// except through ES_UrgentRun and ES_UrgentPublish. Set the ceiling to 0 to
+// go back to turning every interrupt off. The table that applies these is
+// in InterruptPriorities.c
+#define ES_SAFETY_PRIORITY 0
+#define ES_CRITICAL_CEILING 1
+#define ES_ISR_PRIORITY 2
+#define ES_BAND_2_PRIORITY 5
+#define ES_BAND_1_PRIORITY 6
+// time the longest critical region of each kind with the DWT cycle counter
+#define ES_CRITICAL_PROFILE 1
+
+/****************************************************************************/
+// Hot code in SRAM. With ES_RAM_CODE set to 1 the functions marked ES_RAMFUNC
+// (the scheduler loop, the queue and timer tick, SysTick and the capture
+// ISRs) run from SRAM without flash wait states, and ES_Initialize moves the
+// vector table to SRAM. LaunchPad.sct has the regions. Set it to 0
+// to run everything from flash, as before
+#define ES_RAM_CODE 1
+
+/****************************************************************************/
+// IR beacon detector. The photodiode has one owner, picked here:
+// IR_DETECT_CAPTURE      edge captures on PC6/WT1A, an interrupt per edge
+// IR_DETECT_CAPTURE_DMA  the same captures moved a block at a time by uDMA
+//                        (both IRBeaconModule)
+// IR_DETECT_EDGE_COUNT   edges on PC6/WT1A counted over a gate window
+//                        (BeaconCounterModule)
+// IR_DETECT_GOERTZEL     Goertzel filters on ADC samples (IRDemodModule)
+// A host test build may pick its own with -DIR_DETECTOR=...
+#define IR_DETECT_CAPTURE 0
+#define IR_DETECT_CAPTURE_DMA 1
+#define IR_DETECT_EDGE_COUNT 2
+#define IR_DETECT_GOERTZEL 3
+#ifndef IR_DETECTOR
+#define IR_DETECTOR IR_DETECT_GOERTZEL
+#endif
+
+#if (IR_DETECTOR != IR_DETECT_CAPTURE) && (IR_DETECTOR != IR_DETECT_CAPTURE_DMA) && \
+    (IR_DETECTOR != IR_DETECT_EDGE_COUNT) && (IR_DETECTOR != IR_DETECT_GOERTZEL)
+#error IR_DETECTOR must be one of the IR_DETECT_ values
+#endif
+
+/****************************************************************************/
+// Fixed block pool for payloads bigger than an EventParam, see ES_Pool.h
+#define ES_POOL_BLOCK_SIZE 32
+#define ES_POOL_NUM_BLOCKS 8
+
+/****************************************************************************/
+// Event layout: ES_EVENT_COMPACT (16 bit EventParam), ES_EVENT_WIDE (32 bit)
+// or ES_EVENT_STAMPED (32 bit plus a uS capture timestamp). The capture
+// modules send their raw capture and edge time in the event
+#define ES_EVENT_FORMAT ES_EVENT_STAMPED
+
+/****************************************************************************/
+// Name/define the events of interest
+// Universal events occupy the lowest entries, followed by user-defined events
+typedef enum {  ES_NO_EVENT = 0,
+                ES_ERROR,  /* used to indicate an error from the service */
+                ES_INIT,   /* used to transition from initial pseudo-state */
+                ES_TIMEOUT, /* signals that the timer has expired */
+                ES_SHORT_TIMEOUT, /* signals that a short timer has expired */
+                /* User-defined events start here */
+								ISR_COMMAND,
+								END_RUN,
+								NEXT_COMMAND,
+                ES_NEW_KEY, /* signals a new key received from terminal */
+								TapeSensed,
+								IRBeaconSensed,
+								IRBlockReady, /* a half of the IR capture buffer filled, param is the half */
+								IRBeaconClassified, /* the beacon in view changed, param is the Beacon_t */
+								IRSamplesReady, /* a half of the IR ADC buffer filled, param is the half */
+								SPI_RESPONSE, /* the command generator answered a query */
+								MOTION_DONE, /* param says which completion source fired */
+                NUM_ES_EVENT_TYPES /* must stay last, sizes the ES_HSM tables */
+                } ES_EventTyp_t ;
+
+/****************************************************************************/
+// These are the definitions for the Distribution lists. Each definition
+// should be a comma separated list of post functions to indicate which
+// services are on that distribution list.
+// New code should use ES_Subscribe/ES_Publish instead, which needs no
+// list here and posts to all subscribers in one pass.
+#define NUM_DIST_LISTS 0
+#if NUM_DIST_LISTS > 0 
+#define DIST_LIST0 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 1 
+#define DIST_LIST1 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 2 
+#define DIST_LIST2 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 3 
+#define DIST_LIST3 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 4 
+#define DIST_LIST4 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 5 
+#define DIST_LIST5 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 6 
+#define DIST_LIST6 PostTemplateFSM
+#endif
+#if NUM_DIST_LISTS > 7 
+#define DIST_LIST7 PostTemplateFSM
+#endif
+
+/****************************************************************************/
+// This are the name of the Event checking funcion header file. 
+#define EVENT_CHECK_HEADER "EventCheckers.h"
+
+/****************************************************************************/
+// This is the list of event checking functions 
+#define EVENT_CHECK_LIST Check4Keystroke
+
+/****************************************************************************/
+// These are the definitions for the post functions to be executed when the
+// corresponding timer expires. All 16 must be defined. If you are not using
+// a timer, then you should use TIMER_UNUSED
+// Unlike services, any combination of timers may be used and there is no
+// priority in servicing them
+#define TIMER_UNUSED ((pPostFunc)0)
+#define TIMER0_RESP_FUNC PostSPIService
+#define TIMER1_RESP_FUNC TIMER_UNUSED
+#define TIMER2_RESP_FUNC TIMER_UNUSED
+#define TIMER3_RESP_FUNC TIMER_UNUSED
+#define TIMER4_RESP_FUNC TIMER_UNUSED
+#define TIMER5_RESP_FUNC TIMER_UNUSED
+#define TIMER6_RESP_FUNC TIMER_UNUSED
+#define TIMER7_RESP_FUNC TIMER_UNUSED
+#define TIMER8_RESP_FUNC TIMER_UNUSED
+#define TIMER9_RESP_FUNC TIMER_UNUSED
+#define TIMER10_RESP_FUNC TIMER_UNUSED
+#define TIMER11_RESP_FUNC TIMER_UNUSED
+#define TIMER12_RESP_FUNC TIMER_UNUSED
+#define TIMER13_RESP_FUNC TIMER_UNUSED
+#define TIMER14_RESP_FUNC TIMER_UNUSED
+#define TIMER15_RESP_FUNC TIMER_UNUSED
+
+/****************************************************************************/
+// Give the timer numbers symbolc names to make it easier to move them
+// to different timers if the need arises. Keep these definitions close to the
+// definitions for the response functions to make it easier to check that
+// the timer number matches where the timer event will be routed
+// These symbolic names should be changed to be relevant to your application 
+
+#define SPI_TIMER 0
+
+/****************************************************************************/
+// The number of microsecond short timers that ES_ShortTimer multiplexes onto
+// Timer 5. Timers 0 & 1 are the ones behind the original TIMER_A & TIMER_B
+#define NUM_SHORT_TIMERS 4
+
+#endif /* CONFIGURE_H */
@@ -1,29 +1,75 @@
-/****************************************************************************
- Module
-     ES_Events.h
- Description
-     header file with definitions for the event structure 
- Notes
-
- History
- When           Who     What/Why
- -------------- ---     --------
- 08/05/13 15:19 jec      modifications to suit new portable type definitions
- 01/15/12 11:46 jec      moved event enum to config file, changed prefixes to ES
- 10/23/11 22:01 jec      customized for Remote Lock problem
- 10/17/11 08:47 jec      changed event prefixes to EF_ to match new framework
- 08/09/06 14:30 jec      started coding
-*****************************************************************************/
-
-#ifndef ES_Events_H
-#define ES_Events_H
-
-#include "ES_Types.h"
-
-typedef struct ES_Event_t {
-    ES_EventTyp_t EventType;    // what kind of event?
-    uint16_t   EventParam;      // parameter value for use w/ this event
-}ES_Event;
-
-
-#endif /* ES_Events_H */
+/****************************************************************************
+ Module
+     ES_Events.h
+ Description
+     header file with definitions for the event structure 
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 19:40 t16      compile time choice of 16/32 bit param and timestamp
+ 08/05/13 15:19 jec      modifications to suit new portable type definitions
+ 01/15/12 11:46 jec      moved event enum to config file, changed prefixes to ES
+ 10/23/11 22:01 jec      customized for Remote Lock problem
+ 10/17/11 08:47 jec      changed event prefixes to EF_ to match new framework
+ 08/09/06 14:30 jec      started coding
+*****************************************************************************/
+
+#ifndef ES_Events_H
+#define ES_Events_H
+
+#include "ES_Types.h"
+
+// event layouts, pick one with ES_EVENT_FORMAT in ES_Configure.h
+// COMPACT: the original 16 bit parameter
+// WIDE:    32 bit parameter, room for a raw timer capture
+// STAMPED: 32 bit parameter plus EventTime, uS on the framework clock
+#define ES_EVENT_COMPACT 0
+#define ES_EVENT_WIDE    1
+#define ES_EVENT_STAMPED 2
+
+#ifndef ES_EVENT_FORMAT
+#define ES_EVENT_FORMAT ES_EVENT_COMPACT
+#endif
+
+#if ES_EVENT_FORMAT == ES_EVENT_COMPACT
+
+typedef uint16_t ES_EventParam_t;
+
+typedef struct ES_Event_t {
+    ES_EventTyp_t EventType;    // what kind of event?
+    uint16_t   EventParam;      // parameter value for use w/ this event
+}ES_Event;
+
+#else
+
+typedef uint32_t ES_EventParam_t;
+
+// packed so a queue entry costs 5 (WIDE) or 9 (STAMPED) bytes instead of
+// 8 or 12; armcc sizes the enum to 1 byte. The M4 handles the unaligned
+// words, don't take the address of a member
+#pragma pack(push, 1)
+typedef struct ES_Event_t {
+    ES_EventTyp_t EventType;    // what kind of event?
+    uint32_t   EventParam;      // parameter value for use w/ this event
+#if ES_EVENT_FORMAT == ES_EVENT_STAMPED
+    uint32_t   EventTime;       // when it happened, see ES_Timer_GetTimeUS32
+#endif
+}ES_Event;
+#pragma pack(pop)
+
+#endif
+
+// EventTime only means something when the poster set it. These compile
+// away in the formats without a timestamp, which read as time 0
+#if ES_EVENT_FORMAT == ES_EVENT_STAMPED
+#define ES_EventSetTime(pEvent, TimeUS) ((pEvent)->EventTime = (TimeUS))
+#define ES_EventGetTime(Event) ((Event).EventTime)
+#else
+#define ES_EventSetTime(pEvent, TimeUS) ((void)0)
+#define ES_EventGetTime(Event) ((uint32_t)0)
+#endif
+
+
+#endif /* ES_Events_H */
@@ -1,42 +1,59 @@
-/****************************************************************************
- Module
-     EF_Framework.h
- Description
-     header file for use with the top level functions of the EF Event Framework
- Notes
-
- History
- When           Who     What/Why
- -------------- ---     --------
- 11/02/13 17:06 jec      added ES_PostToServiceLIFO prototype
- 08/05/13 15:00 jec      added #include for ES_Port.h to get portability stuff
- 10/17/06 07:41 jec      started coding
-*****************************************************************************/
-
-#ifndef ES_Framework_H
-#define ES_Framework_H
-
-#include "ES_Port.h"
-#include "ES_Types.h"
-#include "ES_General.h"
-#include "ES_CheckEvents.h"
-#include "ES_PostList.h"
-#include "ES_Events.h"
-#include "ES_Timers.h"
-
-typedef enum {
-              Success = 0,
-              FailedPost = 1,
-              FailedRun,
-              FailedPointer,
-              FailedIndex,
-              FailedInit
-} ES_Return_t;
-
-ES_Return_t ES_Initialize( TimerRate_t NewRate  );
-ES_Return_t ES_Run( void );
-bool ES_PostAll( ES_Event ThisEvent );
-bool ES_PostToService( uint8_t WhichService, ES_Event ThisEvent);
-bool ES_PostToServiceLIFO( uint8_t WhichService, ES_Event TheEvent);
-
-#endif   // ES_Framework_H
+/****************************************************************************
+ Module
+     EF_Framework.h
+ Description
+     header file for use with the top level functions of the EF Event Framework
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16      ES_PostAll returns bool again, added ES_PostAllMask
+ 10/19/26 22:30 t16      added ES_SpliceToService
+ 10/19/26 22:00 t16      band runner and band latency stats
+ 10/19/26 21:05 t16      ES_PostAll returns the mask of failed services
+ 10/19/26 20:40 t16      added publish/subscribe and ES_PostToMask
+ 11/02/13 17:06 jec      added ES_PostToServiceLIFO prototype
+ 08/05/13 15:00 jec      added #include for ES_Port.h to get portability stuff
+ 10/17/06 07:41 jec      started coding
+*****************************************************************************/
+
+#ifndef ES_Framework_H
+#define ES_Framework_H
+
+#include "ES_Port.h"
+#include "ES_Types.h"
+#include "ES_General.h"
+#include "ES_CheckEvents.h"
+#include "ES_PostList.h"
+#include "ES_Events.h"
+#include "ES_Timers.h"
+#include "ES_Bands.h"
+#include "ES_IsrProfile.h"
+
+typedef enum {
+              Success = 0,
+              FailedPost = 1,
+              FailedRun,
+              FailedPointer,
+              FailedIndex,
+              FailedInit
+} ES_Return_t;
+
+ES_Return_t ES_Initialize( TimerRate_t NewRate  );
+ES_Return_t ES_Run( void );
+bool ES_PostAll( ES_Event ThisEvent );
+uint16_t ES_PostAllMask( ES_Event ThisEvent );
+bool ES_PostToService( uint8_t WhichService, ES_Event ThisEvent);
+bool ES_PostToServiceLIFO( uint8_t WhichService, ES_Event TheEvent);
+uint8_t ES_SpliceToService( uint8_t WhichService, ES_Event * pBlock);
+uint16_t ES_GetQueueRAM( void );
+bool ES_Subscribe( uint8_t WhichService, ES_EventTyp_t EventType);
+bool ES_Unsubscribe( uint8_t WhichService, ES_EventTyp_t EventType);
+uint16_t ES_Publish( ES_Event ThisEvent);
+uint16_t ES_PostToMask( uint16_t ServiceMask, ES_Event ThisEvent);
+void ES_RunBand( uint8_t Band );
+bool ES_GetBandStats( uint8_t Band, ES_BandStats_t *pStats );
+void ES_ClearBandStats( void );
+
+#endif   // ES_Framework_H
@@ -0,0 +1,96 @@
+/****************************************************************************
+ Module
+     ES_HSM.h
+ Description
+     header file for the table driven hierarchical state machine engine
+ Notes
+     A machine is written as two X-macro lists, one of states and one of
+     transitions, and the macros below turn them into const tables at
+     compile time:
+
+       #define MY_STATES(STATE) \
+         STATE(MyTop,   ES_HSM_NO_PARENT, 0,        0) \
+         STATE(MyIdle,  MyTop,            IdleEntry, 0) \
+         STATE(MyBusy,  MyTop,            0,        BusyExit)
+
+       #define MY_TRANSITIONS(TRANS) \
+         TRANS(MyIdle, ES_TIMEOUT, StartWork, MyBusy) \
+         TRANS(MyBusy, WORK_DONE,  0,         MyIdle) \
+         TRANS(MyTop,  ES_TIMEOUT, Restart,   ES_HSM_INTERNAL)
+
+       ES_HSM_STATES(My, MY_STATES)
+       ES_HSM_TABLES(My, MY_STATES, MY_TRANSITIONS)
+       static ES_HSM_t MyHSM = ES_HSM_INIT(My);
+
+     The transition table is indexed [state][event type], so dispatch is a
+     lookup per level of the hierarchy. An event a state does not handle
+     falls through to its parent. Transitions should target leaf states.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 16:40 t16      started coding
+*****************************************************************************/
+#ifndef ES_HSM_H
+#define ES_HSM_H
+
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// the parent of a top level state
+#define ES_HSM_NO_PARENT 0xff
+// as the next state: run the action but stay put, no exit or entry
+#define ES_HSM_INTERNAL 0xff
+// deepest nesting the engine will walk
+#define ES_HSM_MAX_DEPTH 8
+
+typedef void ES_HSMAction_t( ES_Event ThisEvent );
+typedef void ES_HSMEntryExit_t( void );
+
+typedef struct {
+  uint8_t Parent;
+  ES_HSMEntryExit_t *pEntry;
+  ES_HSMEntryExit_t *pExit;
+} ES_HSMState_t;
+
+typedef struct {
+  ES_HSMAction_t *pAction;
+  uint8_t Next;
+  bool Handled;
+} ES_HSMTransition_t;
+
+typedef struct {
+  ES_HSMState_t const *pStates;
+  ES_HSMTransition_t const *pTable; // NumStates rows of NUM_ES_EVENT_TYPES
+  uint8_t NumStates;
+  uint8_t Current;
+} ES_HSM_t;
+
+// expansions of the STATE and TRANS entries of a spec
+#define ES_HSM_ENUM_ENTRY(Name, Parent, Entry, Exit)     Name,
+#define ES_HSM_STATE_ENTRY(Name, Parent, Entry, Exit)    { Parent, Entry, Exit },
+#define ES_HSM_TRANS_ENTRY(State, Event, Action, Next)   [State][Event] = { Action, Next, true },
+
+// declares <Prefix>State_t with the states in spec order
+#define ES_HSM_STATES(Prefix, STATES) \
+  typedef enum { STATES(ES_HSM_ENUM_ENTRY) Prefix##_NUM_STATES } Prefix##State_t;
+
+// defines the const state and transition tables, anything left out of
+// the transition list is zero, so not handled
+#define ES_HSM_TABLES(Prefix, STATES, TRANSITIONS) \
+  static ES_HSMState_t const Prefix##States[Prefix##_NUM_STATES] = { \
+    STATES(ES_HSM_STATE_ENTRY) }; \
+  static ES_HSMTransition_t const \
+    Prefix##Table[Prefix##_NUM_STATES][NUM_ES_EVENT_TYPES] = { \
+    TRANSITIONS(ES_HSM_TRANS_ENTRY) };
+
+// initializer for the ES_HSM_t that runs the tables
+#define ES_HSM_INIT(Prefix) \
+  { Prefix##States, &Prefix##Table[0][0], Prefix##_NUM_STATES, ES_HSM_NO_PARENT }
+
+void ES_HSM_Start( ES_HSM_t *pHSM, uint8_t Initial );
+bool ES_HSM_Dispatch( ES_HSM_t *pHSM, ES_Event ThisEvent );
+uint8_t ES_HSM_GetState( ES_HSM_t const *pHSM );
+bool ES_HSM_IsIn( ES_HSM_t const *pHSM, uint8_t State );
+
+#endif /* ES_HSM_H */
@@ -0,0 +1,53 @@
+/****************************************************************************
+ Module
+     ES_IsrProfile.h
+ Description
+     header file for the per ISR timing, entry to exit and hardware event
+     to entry, with the DWT cycle counter
+ Notes
+     An ISR in the ES_IsrId_t list in ES_Configure.h starts its body with
+     ES_ISR_ENTRY(Id) and ends it with ES_ISR_EXIT(Id). An ISR whose
+     hardware keeps the time of its event (a capture register, or a
+     counter that restarted on the timeout) also reports how many CPU
+     clocks ago that was with ES_ISR_LATENCY(Id, SinceEvent). The time in
+     an ISR includes any ISR that preempted it.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:40 t16      started coding
+*****************************************************************************/
+#ifndef ES_IsrProfile_H
+#define ES_IsrProfile_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+// all in CPU cycles
+typedef struct {
+  uint32_t Count;
+  uint64_t TotalCycles;   // entry to exit, summed for the average
+  uint32_t MaxCycles;
+  uint32_t Latencies;     // entries that reported their hardware event
+  uint32_t MaxLatency;    // hardware event to ES_ISR_ENTRY
+} ES_IsrStats_t;
+
+#if ES_ISR_PROFILE
+#define ES_ISR_ENTRY(Id)              ES_IsrEntry(Id)
+#define ES_ISR_LATENCY(Id, SinceEvent) ES_IsrLatency((Id), (SinceEvent))
+#define ES_ISR_EXIT(Id)               ES_IsrExit(Id)
+#else
+#define ES_ISR_ENTRY(Id)
+#define ES_ISR_LATENCY(Id, SinceEvent)
+#define ES_ISR_EXIT(Id)
+#endif
+
+void ES_IsrProfileInit( void );
+void ES_IsrEntry( ES_IsrId_t Id );
+void ES_IsrLatency( ES_IsrId_t Id, uint32_t SinceEvent );
+void ES_IsrExit( ES_IsrId_t Id );
+void ES_GetIsrStats( ES_IsrId_t Id, ES_IsrStats_t *pStats );
+uint32_t ES_IsrAverageCycles( ES_IsrStats_t const *pStats );
+void ES_ClearIsrStats( void );
+
+#endif /* ES_IsrProfile_H */
@@ -0,0 +1,51 @@
+/****************************************************************************
+ Module
+     ES_Pool.h
+ Description
+     header file for the fixed block memory pool used to pass payloads
+     bigger than an EventParam between services
+ Notes
+     A block is named by a handle that fits in EventParam. Posting it with
+     ES_PostBlock hands it to the receiving service, and ES_Run frees it
+     when that service's run function returns, unless the service called
+     ES_PoolRetain, in which case the service frees it with ES_PoolFree.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 20:10 t16      started coding
+*****************************************************************************/
+#ifndef ES_Pool_H
+#define ES_Pool_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// low byte is the block number + 1, high byte counts reuses of the block
+// so a stale handle is not mistaken for the block's new contents
+typedef uint16_t ES_PoolHandle_t;
+
+#define ES_POOL_NO_BLOCK ((ES_PoolHandle_t)0)
+
+typedef struct {
+  uint32_t Allocs;
+  uint32_t Frees;
+  uint32_t Exhausted;   // allocs that found no free block
+  uint32_t BadHandles;  // frees/retains of a handle that is not live
+  uint8_t  InUse;
+  uint8_t  HighWater;   // most blocks ever in use at once
+} ES_PoolStats_t;
+
+void ES_PoolInit( void );
+ES_PoolHandle_t ES_PoolAlloc( void );
+void * ES_PoolData( ES_PoolHandle_t Handle );
+bool ES_PoolFree( ES_PoolHandle_t Handle );
+bool ES_PoolRetain( ES_PoolHandle_t Handle );
+bool ES_PostBlock( uint8_t WhichService, ES_EventTyp_t Type,
+                   ES_PoolHandle_t Handle );
+void ES_PoolRunDone( uint8_t WhichService, ES_Event ThisEvent );
+void ES_PoolGetStats( ES_PoolStats_t *pStats );
+void ES_PoolClearStats( void );
+
+#endif /* ES_Pool_H */
@@ -1,105 +1,174 @@
-/****************************************************************************
- Module
-     ES_Port.h
- Description
-     header file to collect all of the hardware/platform dependent info for
-     a particular port of the ES framework
- Notes
-
- History
- When           Who     What/Why
- -------------- ---     --------
- 10/14/15 21:50 jec     added prototype for ES_Timer_GetTime
- 01/18/15 13:24 jec     clean up and adapt to use TI driver lib functions
-                        for implementing EnterCritical & ExitCritical
- 03/13/14		joa		      Updated files to use with Cortex M4 processor core.
- 	 	 	 	 	 	            Specifically, this was tested on a TI TM4C123G mcu.
- 08/13/13 12:12 jec     moved the timer rate constants from ES_Timers.h here
- 08/05/13 14:24 jec     new version replacing port.h and adding define to
-                        capture the C99 compliant behavior of the compiler
-*****************************************************************************/
-#ifndef ES_PORT_H
-#define ES_PORT_H
-
-// pull in the hardware header files that we need
-
-#include <stdio.h>
-#include <stdint.h>
-#include "termio.h"
-#include "bitdefs.h"       /* generic bit defs (BIT0HI, BIT0LO,...) */
-#include "Bin_Const.h"     /* macros to specify binary constants in C */
-#include "ES_Types.h"
-
-// macro to control the use of C99 data types (or simulations in case you don't
-// have a C99 compiler).
-
-// Codewarrior V5, is not C99 so keep this commented out for C32 & E128
-#define COMPILER_IS_C99
-
-// The macro 'ES_FLASH' is needed on some compilers to allocate const data to 
-// ROM. The macro must be defined, even if it evaluates to nothing.
-// for the 'C32 & E128 this is not needed so it evaluates to nothing
-#define ES_FLASH 
-
-// the macro 'ES_READ_FLASH_BYTE' is needed on some Harvard machines to generate
-// code to read a byte from the program space (Flash)
-// The macro must be defined, even if it evaluates to nothing.
-// for the 'C32 & E128 we don't need special instructions so it evaluates to a
-// simple reference to the variable
-#define ES_READ_FLASH_BYTE(_flash_var_)    (_flash_var_)                  
-
-// these macros provide the wrappers for critical regions, where ints will be off
-// but the state of the interrupt enable prior to entry will be restored.
-// allocation of temp var for saving interrupt enable status should be defined
-// in ES_Port.c
-
-// Cortex M-series processors 
-// The Interrupt Program Status Register (IPSR) contains the exception type number
-// of the current interrupt service routine (ISR)
-// Using TivaWare, CPUcpsid() - IntMasterDisable() calls this. Equivalent to __diable_irq()?
-extern uint32_t _PRIMASK_temp;
-uint32_t CPUgetPRIMASK_cpsid(void);
-void CPUsetPRIMASK(uint32_t newPRIMASK);
-
-
-#define EnterCritical()	{ _PRIMASK_temp = CPUgetPRIMASK_cpsid(); }
-#define ExitCritical() { CPUsetPRIMASK(_PRIMASK_temp); }
-
-
-/* Rate constants for programming the SysTick Period to generate tick interrupts.
-   These assume an 40MHz configuration, they are the values to be used to program
-   the SysTick Reload Value (STRELOAD) register. STRELOAD is 24-bits wide and so
-   the highest value is 0xFFFFFF (16,777,216) which equates to
-   16777216*1000/40000000 = 419.4 mS.
-   They are all listed as -1 because the actual cycle time includes 1 cycle to 
-   reset from the max count back to zero, so, for example, to achieve a 4000 
-   count cycle time, you load the register with 4000-1
- */
-typedef enum {	ES_Timer_RATE_OFF  	=   (0),
-				ES_Timer_RATE_100uS = 4000-1,
-				ES_Timer_RATE_500uS = 20000-1,
-				ES_Timer_RATE_1mS	= 40000-1,
-				ES_Timer_RATE_2mS	= 80000-1,
-				ES_Timer_RATE_4mS	= 160000-1,
-				ES_Timer_RATE_5mS	= 200000-1,
-				ES_Timer_RATE_8mS	= 320000-1,
-				ES_Timer_RATE_10mS	= 400000-1,
-				ES_Timer_RATE_16mS	= 640000-1,
-				ES_Timer_RATE_32mS	= 1280000-1
-} TimerRate_t;
-
-// map the generic functions for testing the serial port to actual functions 
-// for this platform. If the C compiler does not provide functions to test
-// and retrieve serial characters, you should write them in ES_Port.c
-#define IsNewKeyReady()  ( kbhit() != 0 )
-#define GetNewKey()      getchar()
-
-// prototypes for the hardware specific routines
-void _HW_Timer_Init(TimerRate_t Rate);
-bool _HW_Process_Pending_Ints( void );
-uint16_t _HW_GetTickCount(void);
-void ConsoleInit(void);
-// and the one Framework function that we define here
-uint16_t ES_Timer_GetTime(void);
-
-#endif
+/****************************************************************************
+ Module
+     ES_Port.h
+ Description
+     header file to collect all of the hardware/platform dependent info for
+     a particular port of the ES framework
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:55 t16     ES_RAMFUNC and the vector table in SRAM
+ 10/19/26 23:50 t16     timer rates derived from CPU_CLOCK_HZ (ClockConfig.h)
+ 10/19/26 23:45 t16     FPU access and context control registers
+ 10/19/26 23:40 t16     DWT cycle counter registers collected here
+ 10/19/26 23:00 t16     nestable critical regions with a saved state per
+                        call, BASEPRI ceiling instead of all ints off
+ 10/19/26 15:05 t16     added prototypes for the microsecond clock
+ 10/14/15 21:50 jec     added prototype for ES_Timer_GetTime
+ 01/18/15 13:24 jec     clean up and adapt to use TI driver lib functions
+                        for implementing EnterCritical & ExitCritical
+ 03/13/14		joa		      Updated files to use with Cortex M4 processor core.
+ 	 	 	 	 	 	            Specifically, this was tested on a TI TM4C123G mcu.
+ 08/13/13 12:12 jec     moved the timer rate constants from ES_Timers.h here
+ 08/05/13 14:24 jec     new version replacing port.h and adding define to
+                        capture the C99 compliant behavior of the compiler
+*****************************************************************************/
+#ifndef ES_PORT_H
+#define ES_PORT_H
+
+// pull in the hardware header files that we need
+
+#include <stdio.h>
+#include <stdint.h>
+#include "termio.h"
+#include "bitdefs.h"       /* generic bit defs (BIT0HI, BIT0LO,...) */
+#include "Bin_Const.h"     /* macros to specify binary constants in C */
+#include "ES_Types.h"
+#include "ES_Configure.h"   /* ES_RAM_CODE */
+#include "ClockConfig.h"
+
+// macro to control the use of C99 data types (or simulations in case you don't
+// have a C99 compiler).
+
+// Codewarrior V5, is not C99 so keep this commented out for C32 & E128
+#define COMPILER_IS_C99
+
+// The macro 'ES_FLASH' is needed on some compilers to allocate const data to 
+// ROM. The macro must be defined, even if it evaluates to nothing.
+// for the 'C32 & E128 this is not needed so it evaluates to nothing
+#define ES_FLASH 
+
+// the macro 'ES_READ_FLASH_BYTE' is needed on some Harvard machines to generate
+// code to read a byte from the program space (Flash)
+// The macro must be defined, even if it evaluates to nothing.
+// for the 'C32 & E128 we don't need special instructions so it evaluates to a
+// simple reference to the variable
+#define ES_READ_FLASH_BYTE(_flash_var_)    (_flash_var_)                  
+
+// the macro 'ES_RAMFUNC' goes in front of a function definition to run it
+// from SRAM when ES_RAM_CODE is set. The scatter file gathers the section
+// into ER_IRAM_CODE and the C library startup copies it there from flash.
+// Calls between flash and SRAM go through linker veneers, a few cycles
+// each, so it is for code run on every tick, event or capture
+#if ES_RAM_CODE && defined(__ARMCC_VERSION)
+#define ES_RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define ES_RAMFUNC
+#endif
+
+// critical regions. The caller keeps what the enter function returns and
+// hands it back to the exit function, so regions nest and may be used from
+// any ISR:
+//   Saved = ES_EnterCritical(); ... ES_ExitCritical(Saved);
+// ES_EnterCritical raises BASEPRI to ES_CRITICAL_CEILING, holding off the
+// framework's interrupts but not the safety ISRs above the ceiling. Use it
+// for anything shared with the framework. ES_EnterCriticalAll turns every
+// interrupt off, for the few registers and variables a safety ISR shares.
+
+// Cortex M-series processors 
+// The Interrupt Program Status Register (IPSR) contains the exception type number
+// of the current interrupt service routine (ISR)
+// Using TivaWare, CPUcpsid() - IntMasterDisable() calls this. Equivalent to __diable_irq()?
+uint32_t CPUgetPRIMASK_cpsid(void);
+void CPUsetPRIMASK(uint32_t newPRIMASK);
+// BASEPRI_MAX only ever raises the masking level, so a region entered from
+// an ISR above the ceiling leaves it where it was
+uint32_t CPUraiseBASEPRI(uint32_t newBASEPRI);
+void CPUsetBASEPRI(uint32_t newBASEPRI);
+
+uint32_t ES_EnterCritical(void);
+void ES_ExitCritical(uint32_t Saved);
+uint32_t ES_EnterCriticalAll(void);
+void ES_ExitCriticalAll(uint32_t Saved);
+
+// outermost regions only, timed with the DWT cycle counter when
+// ES_CRITICAL_PROFILE is set
+typedef struct {
+  uint32_t Count;
+  uint32_t MaxCycles;
+} ES_CriticalWindow_t;
+
+typedef struct {
+  ES_CriticalWindow_t Ceiling;  // ES_EnterCritical, masks the framework ISRs
+  ES_CriticalWindow_t All;      // ES_EnterCriticalAll, masks the safety ISRs too
+} ES_CriticalStats_t;
+
+void ES_GetCriticalStats(ES_CriticalStats_t *pStats);
+void ES_ClearCriticalStats(void);
+
+// the DWT cycle counter, which counts CPU clocks once ES_CycleCounterStart
+// has run (ES_Initialize calls it). Read it with HWREG(DWT_CYCCNT)
+#define DEMCR        0xE000EDFC
+#define DEMCR_TRCENA 0x01000000
+#define DWT_CTRL     0xE0001000
+#define DWT_CYCCNT   0xE0001004
+
+void ES_CycleCounterStart(void);
+
+// the FPU. Startup gives access to it through CPACR and sets FPCCR for
+// lazy stacking: an exception taken with FP state live reserves room for
+// the FP registers but only saves them if the handler uses the FPU, so
+// ISRs that don't pay nothing for it
+#define CPACR        0xE000ED88
+#define CPACR_CP10_CP11_FULL 0x00F00000
+#define FPCCR        0xE000EF34
+#define FPCCR_ASPEN  0x80000000
+#define FPCCR_LSPEN  0x40000000
+
+
+/* Rate constants for programming the SysTick Period to generate tick interrupts.
+   These are derived from CPU_CLOCK_HZ, they are the values to be used to program
+   the SysTick Reload Value (STRELOAD) register. STRELOAD is 24-bits wide and so
+   the highest value is 0xFFFFFF (16,777,216) which equates to
+   16777216*1000/80000000 = 209.7 mS at 80 MHz.
+   They are all listed as -1 because the actual cycle time includes 1 cycle to 
+   reset from the max count back to zero, so, for example, to achieve a 4000 
+   count cycle time, you load the register with 4000-1
+ */
+typedef enum {	ES_Timer_RATE_OFF  	=   (0),
+				ES_Timer_RATE_100uS = 100*TicksPerUS-1,
+				ES_Timer_RATE_500uS = 500*TicksPerUS-1,
+				ES_Timer_RATE_1mS	= TicksPerMS-1,
+				ES_Timer_RATE_2mS	= 2*TicksPerMS-1,
+				ES_Timer_RATE_4mS	= 4*TicksPerMS-1,
+				ES_Timer_RATE_5mS	= 5*TicksPerMS-1,
+				ES_Timer_RATE_8mS	= 8*TicksPerMS-1,
+				ES_Timer_RATE_10mS	= 10*TicksPerMS-1,
+				ES_Timer_RATE_16mS	= 16*TicksPerMS-1,
+				ES_Timer_RATE_32mS	= 32*TicksPerMS-1
+} TimerRate_t;
+
+#if 32*TicksPerMS-1 > 0xFFFFFF
+#error ES_Timer_RATE_32mS does not fit STRELOAD at this CPU_CLOCK_HZ
+#endif
+
+// map the generic functions for testing the serial port to actual functions 
+// for this platform. If the C compiler does not provide functions to test
+// and retrieve serial characters, you should write them in ES_Port.c
+#define IsNewKeyReady()  ( kbhit() != 0 )
+#define GetNewKey()      getchar()
+
+// prototypes for the hardware specific routines
+void _HW_Timer_Init(TimerRate_t Rate);
+bool _HW_Process_Pending_Ints( void );
+uint16_t _HW_GetTickCount(void);
+uint64_t _HW_GetTimeUS(void);
+uint32_t _HW_GetTimeUS32(void);
+void _HW_RelocateVectors(void);
+void ConsoleInit(void);
+// and the one Framework function that we define here
+uint16_t ES_Timer_GetTime(void);
+
+#endif
@@ -1,14 +1,28 @@
-// header file for the ES_ShortTimer library
-
-#ifndef ES_ShortTimer_H
-#define ES_ShortTimer_H
-#include <stdint.h>
-#include "driverlib/timer.h"
-#include "ES_Configure.h"
-
-#define SHORT_TIMER_UNUSED MAX_NUM_SERVICES
-
-void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio);
-void ES_ShortTimerStart( uint32_t Which, uint16_t TimeoutValue);
-
-#endif //ES_ShortTimer_H
+// header file for the ES_ShortTimer library
+
+#ifndef ES_ShortTimer_H
+#define ES_ShortTimer_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/timer.h"
+#include "ES_Configure.h"
+
+#define SHORT_TIMER_UNUSED MAX_NUM_SERVICES
+
+// how late, in timer ticks, expiries were handled since the last clear
+typedef struct {
+  uint32_t Expired;
+  uint32_t MinLateTicks;
+  uint32_t MaxLateTicks;
+  uint32_t TotalLateTicks;
+} ES_ShortTimerStats_t;
+
+void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio);
+void ES_ShortTimerStart( uint32_t Which, uint16_t TimeoutValue);
+bool ES_ShortTimerStartSlot( uint8_t Slot, uint8_t PostTo, uint32_t TimeoutUS);
+void ES_ShortTimerStop( uint8_t Slot);
+bool ES_ShortTimerIsActive( uint8_t Slot);
+void ES_ShortTimerGetStats( ES_ShortTimerStats_t *pStats);
+void ES_ShortTimerClearStats( void);
+
+#endif //ES_ShortTimer_H
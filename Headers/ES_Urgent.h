@@ -0,0 +1,47 @@
+/****************************************************************************
+ Module
+     ES_Urgent.h
+ Description
+     header file for the urgent action hook, a fast path from an ISR to a
+     registered handler that does not go through the event queues
+ Notes
+     An urgent handler must be short and bounded: a few register writes.
+     It runs either inside the ISR that detected the condition
+     (ES_UrgentRun) or from PendSV right after it (ES_UrgentPend). The
+     detecting code still posts its normal event so the services hear
+     about it, the handler only gets the hardware safe first. A safety
+     ISR, above ES_CRITICAL_CEILING, posts that event with
+     ES_UrgentPublish instead of ES_Publish.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:00 t16      added ES_UrgentPublish
+ 10/19/26 21:30 t16      started coding
+*****************************************************************************/
+#ifndef ES_Urgent_H
+#define ES_Urgent_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+typedef void ES_UrgentFunc_t( void );
+
+// detect to handler done, in CPU cycles from the DWT cycle counter
+typedef struct {
+  uint32_t Count;
+  uint32_t LastCycles;
+  uint32_t MaxCycles;
+} ES_UrgentStats_t;
+
+void ES_UrgentInit( void );
+bool ES_UrgentRegister( ES_UrgentAction_t Action, ES_UrgentFunc_t *pHandler );
+void ES_UrgentRun( ES_UrgentAction_t Action );
+void ES_UrgentPend( ES_UrgentAction_t Action );
+bool ES_UrgentPublish( ES_Event ThisEvent );
+uint32_t ES_UrgentRelayLost( void );
+void ES_UrgentGetStats( ES_UrgentAction_t Action, ES_UrgentStats_t *pStats );
+void ES_UrgentPendSVHandler( void );
+
+#endif /* ES_Urgent_H */
@@ -10,10 +10,18 @@
 #include "ES_Configure.h" /* gets us event definitions */
 #include "ES_Types.h"     /* gets bool type for returns */
 
+// edges per half of the ping-pong buffer
+#define IR_BLOCK_EDGES 32
+
 // Public Function Prototypes
 void InitInputCaptureForIRDetection( void );
 void EnableIRInterrupt(void);
+void DisableIRInterrupt(void);
 void InputCaptureForIRDetectionResponse( void );
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+void ProcessIRBlock(uint8_t Half);
+uint16_t GetIRBlockOverruns(void);
+#endif
 
 #endif 
 
@@ -0,0 +1,28 @@
+/****************************************************************************
+
+  Header file for IR Demodulator Module
+ ****************************************************************************/
+
+#ifndef IRDemodModule_H
+#define IRDemodModule_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+#include "BeaconCounterModule.h" /* the beacons, Beacon_t */
+
+// 200 samples at 10 kHz: a block every 20 ms, filters 50 Hz wide
+#define IR_DEMOD_SAMPLE_HZ 10000
+#define IR_DEMOD_BLOCK 200
+
+// Public Function Prototypes
+void InitIRDemod(void);
+void StartIRDemod(Beacon_t Target);
+void StopIRDemod(void);
+void IRDemodISR(void);
+void ProcessIRSamples(uint8_t Half);
+Beacon_t QueryDemodBeacon(void);
+void GetBeaconAmplitudes(uint16_t *pAmplitudes);
+void PrintIRDemodStats(void);
+
+#endif
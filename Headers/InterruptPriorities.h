@@ -0,0 +1,18 @@
+/****************************************************************************
+ 
+  Header file for Interrupt Priorities
+ ****************************************************************************/
+
+#ifndef InterruptPriorities_H
+#define InterruptPriorities_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// Public Function Prototypes
+void ApplyInterruptPriorities(void);
+void PrintInterruptPriorities(void);
+void PrintInterruptProfile(void);
+
+#endif
@@ -0,0 +1,32 @@
+/****************************************************************************
+ 
+  Header file for Motion Profile Module
+ ****************************************************************************/
+
+#ifndef MotionProfileModule_H
+#define MotionProfileModule_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// profile tick period and how far the duty may move (in %) per tick
+// 2 mS and 4% take 0 to 100% in 50 mS
+#define PROFILE_TICK_MS 2
+#define DUTY_SLEW_PER_TICK 4
+
+// called once a ramp has put its last step on the motors
+typedef void ProfileDoneFunc_t(void);
+
+// Public Function Prototypes
+void InitMotionProfile(void);
+void SetMotionTarget(int8_t LeftDuty, int8_t RightDuty);
+void HaltMotionProfile(void);
+bool IsMotionProfileDone(void);
+int8_t QueryWheelDuty(bool wheelSide);
+void SetProfileDoneHook(ProfileDoneFunc_t *pHook);
+uint8_t BuildDutyProfile(int8_t LeftFrom, int8_t LeftTo, int8_t RightFrom,
+                         int8_t RightTo, int8_t *pLeft, int8_t *pRight);
+void MotionProfileISR(void);
+
+#endif
@@ -0,0 +1,32 @@
+/****************************************************************************
+ 
+  Header file for Odometry Module
+ ****************************************************************************/
+
+#ifndef OdometryModule_H
+#define OdometryModule_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// pose relative to where ResetPose was last called
+typedef struct {
+	int32_t XUM;      // uM along the starting heading
+	int32_t YUM;      // uM to the left of the starting heading
+	uint32_t Heading; // binary angle, 2^32 = one turn, CCW positive
+} Pose_t;
+
+typedef void TurnDoneFunc_t(void);
+
+// Public Function Prototypes
+void InitOdometry(void);
+void ResetPose(void);
+void GetPose(Pose_t *pPose);
+int16_t GetHeadingDeg(void);
+void StartMeasuredTurn(int16_t Degrees, TurnDoneFunc_t *pDone);
+void CancelMeasuredTurn(void);
+void LeftEncoderISR(void);
+void RightEncoderISR(void);
+
+#endif
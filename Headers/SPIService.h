@@ -11,15 +11,15 @@
 #include "ES_Events.h" 
 
 
-// typedefs for the states
-// State definitions for use with the query function
-typedef enum {Idling,Busy} SPIState_t ;
+// the query states (SPIState_t) are generated from the table in SPIService.c
 
 // Public Function Prototypes
 bool InitSPIService ( uint8_t );
 ES_Event RunSPIService( ES_Event );
 bool PostSPIService( ES_Event );
 uint16_t getCommand(void);
+bool GetNextCommand( uint8_t *pOpcode );
+void StopCommandPrefetch( void );
 
 
 #endif /* SPIService_H */
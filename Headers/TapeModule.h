@@ -13,7 +13,6 @@
 // Public Function Prototypes
 void InitTapeInterrupt (void);
 void TapeInterruptResponse(void);
-uint32_t GetTapeSensedTime(void);
 void EnableTapeInterrupt(void);
 
 // Module Function Prototypes
@@ -0,0 +1,41 @@
+/****************************************************************************
+ 
+  Header file for Timer Manager
+ ****************************************************************************/
+
+#ifndef TimerManager_H
+#define TimerManager_H
+
+// Event Definitions
+#include "ES_Configure.h" /* gets us event definitions */
+#include "ES_Types.h"     /* gets bool type for returns */
+
+// one 32 bit half of a 32/64 bit wide timer
+typedef enum {
+	WT0_A, WT0_B,
+	WT1_A, WT1_B,
+	WT2_A, WT2_B,
+	WT3_A, WT3_B,
+	WT4_A, WT4_B,
+	WT5_A, WT5_B,
+	NUM_TIMER_CHANNELS
+} TimerChannel_t;
+
+typedef enum {
+	TIMER_MODE_CAPTURE,   // rising edge time capture, free running up count
+	TIMER_MODE_CAPTURE_DMA, // the same, each edge a uDMA request, no interrupt
+	TIMER_MODE_EDGE_COUNT, // rising edges counted up in TnR, no interrupt
+	TIMER_MODE_ONE_SHOT,  // down count, timeout interrupt, stops itself
+	TIMER_MODE_PERIODIC,  // down count, timeout interrupt, reloads
+	TIMER_MODE_ADC_TRIGGER // periodic, each timeout triggers the ADC, no interrupt
+} TimerMode_t;
+
+// Public Function Prototypes
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner);
+void SetTimerLoad(TimerChannel_t Channel, uint32_t Ticks);
+void StartTimer(TimerChannel_t Channel);
+void StopTimer(TimerChannel_t Channel);
+uint8_t GetTimerConflicts(void);
+void PrintTimerAllocations(void);
+
+#endif
@@ -13,11 +13,21 @@
 #include "ES_Framework.h"
 
 #include "ActionService.h"
+#include "CommandOpcodes.h"
 #include "PWMmodule.h"
 #include "SPIService.h"
 #include "MotorActionsModule.h"
+#include "MotionProfileModule.h"
+#include "OdometryModule.h"
+#include "TimerManager.h"
+#include "DMAManager.h"
 #include "TapeModule.h"
 #include "IRBeaconModule.h"
+#include "BeaconCounterModule.h"
+#include "IRDemodModule.h"
+#include "BeaconBearingModule.h"
+#include "ES_Urgent.h"
+#include "InterruptPriorities.h"
 
 #include <stdio.h>
 #include <termio.h>
@@ -42,24 +52,19 @@
 
 #include "BITDEFS.H"
 #include "inc/hw_timer.h"
+#include "ClockConfig.h"
+
+// IR_DETECTOR (ES_Configure.h) picks the one detector that owns the
+// photodiode. A per module switch left over from before would start a
+// second one on WT1A
+#if defined(IR_CAPTURE_DMA) || defined(IR_EDGE_COUNT) || defined(IR_GOERTZEL)
+#error IR detectors are picked with IR_DETECTOR in ES_Configure.h
+#endif
 
 /*----------------------------- Module Defines ----------------------------*/
 #define ALL_BITS (0xff<<2)
 #define TEST_MODE
 
-#define STOP 0x00
-#define CW_90 0x02 
-#define CW_45 0x03 
-#define CCW_90 0x04 
-#define CCW_45 0x05 
-#define FORWARD_HALF_SPEED 0x08 
-#define FORWARD_FULL_SPEED 0x09 
-#define REVERSE_HALF_SPEED 0x10 
-#define REVERSE_FULL_SPEED 0x11 
-#define ALIGN_BEACON 0x20 
-#define DRIVE2TAPE 0x40 
-#define READY4NEXTCOMMAND 0xff
-
 #define FORWARD 1
 #define BACKWARD 0
 #define CW 1
@@ -70,12 +75,16 @@
 #define DUTY_HALF_SPEED 75 //might need to be changed
 #define DUTY_FULL_SPEED 100
 
-// using 40 MHz clock
-#define TicksPerMS 40000
-
 #define Rotate90Timeout 1050
 #define Rotate45Timeout 550
+// turns end on the measured angle, the one-shot only catches a dead encoder
+#define TurnSafetyFactor 2
 #define AlignWithBeaconTimeout 5000
+// the bearing sweep is a full turn at full speed
+#define SweepTimeout (4*Rotate90Timeout)
+#if SweepTimeout*TurnSafetyFactor*TicksPerMS > 0xFFFFFFFF
+#error the longest one-shot does not fit the 32 bit timer at CPU_CLOCK_HZ
+#endif
 #define Post2SPITimeout 100
 
 #define QueryBits 0xAA
@@ -85,16 +94,74 @@
    relevant to the behavior of this service*/
 static void InitOneShotISR(void);
 static void SetTimeoutAndStartOneShot( uint32_t);
+static void StopOneShot(void);
+static void StartTurn(int16_t Degrees, uint32_t TimeoutMS);
+static uint32_t TurnTimeout(int16_t Degrees);
+static void MeasuredTurnDone(void);
+static void DispatchCommand(uint8_t Opcode);
+static void RunCommand(uint8_t Opcode, bool BackToBack);
+static void StartPrefetched(bool BackToBack);
+static void RecordGap(bool BackToBack);
+static void ProfileDone(void);
+static void EmergencyStop(void);
+static void TurnTimedOut(void);
+static void ReportStopLatency(ES_Event ThisEvent);
+static void DoStop(int16_t Arg);
+static void DoEndRun(int16_t Arg);
+static void DoTurn(int16_t Degrees);
+static void DoDrive(int16_t Duty);
+static void DoAlignBeacon(int16_t Arg);
+static void DoDrive2Tape(int16_t Arg);
+static void DoUnknown(int16_t Arg);
 static void Look4Beacon(uint32_t);
-//static void InitInputCaptureForIRDetection( void );
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+static void LogSweepBlock(ES_Event ThisEvent);
+static void EndAlignment(void);
+#endif
+
+/*---------------------------- Module Types -------------------------------*/
+typedef void CommandHandler_t(int16_t Arg);
+
+typedef struct {
+	CommandHandler_t *pHandler;
+	int16_t Arg;
+	MotionDone_t DoneOn;   /* completion that lets the next command start */
+} CommandEntry_t;
 
 /*---------------------------- Module Variables ---------------------------*/
+// what each SPI byte does, indexed by opcode. Bytes with no entry are
+// unknown commands
+static CommandEntry_t const CommandTable[NUM_OPCODES] = {
+	[STOP]               = { DoStop,        0,                DONE_ON_RAMP },
+	[CW_90]              = { DoTurn,        -90,              DONE_ON_TURN },
+	[CW_45]              = { DoTurn,        -45,              DONE_ON_TURN },
+	[CCW_90]             = { DoTurn,        90,               DONE_ON_TURN },
+	[CCW_45]             = { DoTurn,        45,               DONE_ON_TURN },
+	[END_RUN_CMD]        = { DoEndRun,      0,                DONE_ON_RAMP },
+	[FORWARD_HALF_SPEED] = { DoDrive,       DUTY_HALF_SPEED,  DONE_ON_RAMP },
+	[FORWARD_FULL_SPEED] = { DoDrive,       DUTY_FULL_SPEED,  DONE_ON_RAMP },
+	[REVERSE_HALF_SPEED] = { DoDrive,       -DUTY_HALF_SPEED, DONE_ON_RAMP },
+	[REVERSE_FULL_SPEED] = { DoDrive,       -DUTY_FULL_SPEED, DONE_ON_RAMP },
+	[ALIGN_BEACON]       = { DoAlignBeacon, 0,                DONE_ON_BEACON },
+	[DRIVE2TAPE]         = { DoDrive2Tape,  0,                DONE_ON_TAPE },
+};
+
+static uint16_t UnknownCommands = 0;
+
 // with the introduction of Gen2, we need a module level Priority variable
 static uint8_t MyPriority;
-static bool runActionSwitchFlag = 0;
+// completion the running motion is waiting for, DONE_NOT_WAITING when idle
+static MotionDone_t AwaitedDone = DONE_NOT_WAITING;
+// framework clock when the last motion finished
+static uint32_t IdleSinceUS = 0;
+static PipelineStats_t Stats;
 static uint32_t OneShotTimeoutMS;
 static ES_Event LastEvent;
 static ES_Event SPIEvent;
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+// where ALIGN_BEACON is: sweeping for the bearing or turning to it
+static enum { ALIGN_IDLE, ALIGN_SWEEP, ALIGN_TURN } AlignPhase = ALIGN_IDLE;
+#endif
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -123,12 +190,49 @@ static ES_Event SPIEvent;
 	  
 	// Initialize PWM functionality
 	InitializePWM();
+	InitMotionProfile();
+	InitOdometry();
 	 
 	// Initialize Interrupts
 	InitTapeInterrupt();
-	//InitInputCaptureForIRDetection();
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+	InitIRDemod();
+#elif IR_DETECTOR == IR_DETECT_EDGE_COUNT
+	InitBeaconCounter();
+#else
+	InitInputCaptureForIRDetection();
+#endif
 	InitOneShotISR();
 	
+	// the tape ISR turns the motors off itself through the urgent stop
+	ES_UrgentRegister(URGENT_STOP, EmergencyStop);
+	// the turn one-shot does too, and leaves the rest of the turn to PendSV
+	ES_UrgentRegister(URGENT_TURN_TIMEOUT, TurnTimedOut);
+	
+	// sensor events are published, take the ones that end motions
+	ES_Subscribe(MyPriority, TapeSensed);
+	ES_Subscribe(MyPriority, IRBeaconSensed);
+#if (IR_DETECTOR == IR_DETECT_GOERTZEL) || (IR_DETECTOR == IR_DETECT_EDGE_COUNT)
+	ES_Subscribe(MyPriority, IRBeaconClassified);
+#endif
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+	// blocks of IR samples are filtered here, not in the ADC ISR
+	ES_Subscribe(MyPriority, IRSamplesReady);
+#endif
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+	// blocks of IR edges are analysed here, not in the capture ISR
+	ES_Subscribe(MyPriority, IRBlockReady);
+#endif
+	
+	// ramps report their end so drives and stops can chain
+	AwaitedDone = DONE_NOT_WAITING;
+	ClearPipelineStats();
+	SetProfileDoneHook(ProfileDone);
+	
+	// every wide timer and uDMA user has claimed its channel by now
+	PrintTimerAllocations();
+	PrintDMAAllocations();
+	
 	// Initialize last event parameter to 0
 	LastEvent.EventParam = 0xff;
 
@@ -157,6 +261,60 @@ bool PostActionService(ES_Event ThisEvent)
   return ES_PostToService( MyPriority, ThisEvent);
 }
 
+/****************************************************************************
+ Function
+     GetUnknownCommandCount
+
+ Returns
+     uint16_t number of command bytes with no CommandTable entry so far
+****************************************************************************/
+uint16_t GetUnknownCommandCount(void)
+{
+	return UnknownCommands;
+}
+
+/****************************************************************************
+ Function
+     PostMotionDone
+
+ Parameters
+     MotionDone_t Source : which completion fired
+
+ Description
+     Safe to call from an ISR. Only the completion the running command
+     waits for lets the next command start
+****************************************************************************/
+void PostMotionDone(MotionDone_t Source)
+{
+	ES_Event DoneEvent;
+
+	DoneEvent.EventType = MOTION_DONE;
+	DoneEvent.EventParam = Source;
+	PostActionService(DoneEvent);
+}
+
+/****************************************************************************
+ Function
+     GetPipelineStats
+
+ Parameters
+     PipelineStats_t *pStats : filled with a copy of the idle gap metrics
+****************************************************************************/
+void GetPipelineStats(PipelineStats_t *pStats)
+{
+	*pStats = Stats;
+}
+
+void ClearPipelineStats(void)
+{
+	Stats.Motions = 0;
+	Stats.Gaps = 0;
+	Stats.BackToBack = 0;
+	Stats.LastGapUS = 0;
+	Stats.MaxGapUS = 0;
+	Stats.TotalGapUS = 0;
+}
+
 /****************************************************************************
  Function
     RunActionService
@@ -179,100 +337,99 @@ ES_Event RunActionService(ES_Event ThisEvent)
   ES_Event ReturnEvent;
   ReturnEvent.EventType = ES_NO_EVENT; // assume no errors
 	
-	if (ThisEvent.EventParam == READY4NEXTCOMMAND)
+	switch (ThisEvent.EventType)
 	{
-		printf("FF");
-		runActionSwitchFlag = 1;
-	}
-	
-	if ((runActionSwitchFlag == 1) && (ThisEvent.EventParam != READY4NEXTCOMMAND))
-	{
-		printf("\r\n %x\r\n", ThisEvent.EventParam);
-		runActionSwitchFlag = 0;
-		switch(ThisEvent.EventParam)
-		{
-			//Case 1 
-			case STOP:
-				//printf("\r\n STOP Received\n");
-				stop();
-				break;
-			
-			//Case 2
-			case CW_90:
-			//	printf("\r\n CW_90 Received\n");
-				SetTimeoutAndStartOneShot(Rotate90Timeout);
-				start2rotate(CW);
+		// SPIService prefetched a command, start it unless a motion is running
+		case NEXT_COMMAND:
+			StartPrefetched(false);
+			break;
+		
+		// the running motion finished, chain straight into the next command
+		case MOTION_DONE:
+			// the tape ends the drive to it, and the run with it, whatever
+			// else was running or prefetched
+			if (ThisEvent.EventParam == DONE_ON_TAPE)
+			{
+				RunCommand(END_RUN_CMD, false);
 				break;
-			
-			//Case 3
-			case CW_45:
-				//printf("\r\n CW_45 Received\n");
-				SetTimeoutAndStartOneShot(Rotate45Timeout);
-				start2rotate(CW);			
-				break;
-			
-			//Case 4
-			case CCW_90:
-				//printf("\r\n CCW_90 Received\n");
-				SetTimeoutAndStartOneShot(Rotate90Timeout);
-				start2rotate(CCW);
-				break;
-			
-			//Case 5
-			case CCW_45:
-				//printf("\r\n CCW_45 Received\n");
-				SetTimeoutAndStartOneShot(Rotate45Timeout);
-				start2rotate(CCW);
-				break;
-			
-			//Case 6
-			case FORWARD_HALF_SPEED:
-				//printf("\r\n FORWARD_HALF_SPEED Received\n");
-				drive(DUTY_HALF_SPEED, FORWARD);
-				break;
-			
-			//Case 7
-			case FORWARD_FULL_SPEED:
-				//printf("\r\n FORWARD_FULL_SPEED Received\n");
-				drive(DUTY_FULL_SPEED, FORWARD);
-				break;
-			
-			//Case 8
-			case REVERSE_HALF_SPEED:
-			//	printf("\r\n REVERSE_HALF_SPEED Received\n");
-				drive(DUTY_HALF_SPEED, BACKWARD);
-				break;
-			
-			//Case 9
-			case REVERSE_FULL_SPEED:
-				//printf("\r\n REVERSE_FULL_SPEED Received\n");
-				drive(DUTY_FULL_SPEED, BACKWARD);
-				break;
-			
-			//Case 10
-			case ALIGN_BEACON:
-				rotate2beacon();
-				//EnableIRInterrupt();
+			}
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+			// the bearing turn, or the sweep timing out, ends the alignment
+			if ((AlignPhase != ALIGN_IDLE) && (ThisEvent.EventParam == DONE_ON_TURN))
+			{
+				EndAlignment();
 				break;
-			
-			//Case 11
-			case DRIVE2TAPE:
-				//printf("\r\n DRIVE2TAPE Received\n");
-				EnableTapeInterrupt();
-				drive(DUTY_FULL_SPEED, FORWARD);
-				break;
-			
-			//Case 12
-			case END_RUN:
-				//printf("\r\n END_RUN Received\n");
-				// stop motors and stop posting events
+			}
+#endif
+#if (IR_DETECTOR == IR_DETECT_EDGE_COUNT) || (IR_DETECTOR == IR_DETECT_CAPTURE) || \
+    (IR_DETECTOR == IR_DETECT_CAPTURE_DMA)
+			// these detectors only report the beacon, from an ISR or from
+			// ProcessIRBlock, the stop ramp has to be started from here
+			if (ThisEvent.EventParam == DONE_ON_BEACON)
+			{
 				stop();
-				break;
-		}
+			}
+#endif
+			if ((AwaitedDone != DONE_NOT_WAITING) && (ThisEvent.EventParam == AwaitedDone))
+			{
+				AwaitedDone = DONE_NOT_WAITING;
+				IdleSinceUS = ES_Timer_GetTimeUS32();
+				StartPrefetched(true);
+			}
+			break;
+		
+		// keyboard commands skip the pipeline and replace the current motion
+		case ISR_COMMAND:
+			RunCommand((uint8_t)ThisEvent.EventParam, false);
+			break;
+		
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+		// half of the IR capture buffer is full, look for the beacon in it
+		case IRBlockReady:
+			ProcessIRBlock((uint8_t)ThisEvent.EventParam);
+			break;
+#endif
+		
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+		// half of the IR sample buffer is full, filter it for the beacons
+		case IRSamplesReady:
+			ProcessIRSamples((uint8_t)ThisEvent.EventParam);
+			if (AlignPhase == ALIGN_SWEEP)
+			{
+				LogSweepBlock(ThisEvent);
+			}
+			break;
+#endif
+		
+#if (IR_DETECTOR == IR_DETECT_GOERTZEL) || (IR_DETECTOR == IR_DETECT_EDGE_COUNT)
+		// the beacon in view changed, the detector has already stopped the
+		// motors if it was the one being looked for
+		case IRBeaconClassified:
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+			printf("\r\nbeacon: %s\r\n", GetBeaconName((Beacon_t)ThisEvent.EventParam));
+#else
+			printf("\r\nbeacon: %s (%lu Hz)\r\n",
+			       GetBeaconName((Beacon_t)ThisEvent.EventParam),
+			       (unsigned long)QueryBeaconHz());
+#endif
+			break;
+#endif
+		
+		// tape ends the run whatever else is going on. The motors are
+		// already off, the DONE_ON_TAPE brings the rest of the service in
+		// line
+		case TapeSensed:
+			ReportStopLatency(ThisEvent);
+			PostMotionDone(DONE_ON_TAPE);
+			PrintInterruptProfile();
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+			PrintIRDemodStats();
+#endif
+			break;
+		
+		default:
+			break;
 	}
-	
-	// post to SPI service after each execution of Action Service to get the next command
-	// exception: after END_RUN is executed
 	return ReturnEvent;
 }
 
@@ -280,6 +437,254 @@ ES_Event RunActionService(ES_Event ThisEvent)
  private functions
  ***************************************************************************/
 
+/****************************************************************************
+ Function
+     StartPrefetched
+
+ Parameters
+     bool BackToBack : the command was waiting when the last motion ended
+
+ Description
+			Start prefetched commands until one of them has to wait for its
+			motion to complete. Unknown commands do not wait
+****************************************************************************/
+static void StartPrefetched(bool BackToBack)
+{
+	uint8_t Opcode;
+
+	while ((AwaitedDone == DONE_NOT_WAITING) && GetNextCommand(&Opcode))
+	{
+		RunCommand(Opcode, BackToBack);
+	}
+}
+
+/****************************************************************************
+ Function
+     RunCommand
+
+ Parameters
+     uint8_t Opcode : command byte
+     bool BackToBack : the command was waiting when the last motion ended
+
+ Description
+			A known command replaces the motion in progress and sets what the
+			pipeline waits for next
+****************************************************************************/
+static void RunCommand(uint8_t Opcode, bool BackToBack)
+{
+	if (CommandTable[Opcode].pHandler != 0)
+	{
+		RecordGap(BackToBack);
+		// a new command replaces any turn still in progress
+		CancelMeasuredTurn();
+		StopOneShot();
+		// set before the handler runs, a ramp can finish inside it
+		AwaitedDone = CommandTable[Opcode].DoneOn;
+	}
+	DispatchCommand(Opcode);
+}
+
+/****************************************************************************
+ Function
+     RecordGap
+
+ Description
+			Idle gap metrics: time from the last motion ending to this one
+			starting. A command that replaces a running motion has no gap
+****************************************************************************/
+static void RecordGap(bool BackToBack)
+{
+	uint32_t GapUS;
+
+	if ((AwaitedDone == DONE_NOT_WAITING) && (Stats.Motions > 0))
+	{
+		GapUS = ES_Timer_GetTimeUS32() - IdleSinceUS;
+		Stats.Gaps++;
+		Stats.LastGapUS = GapUS;
+		Stats.TotalGapUS += GapUS;
+		if (GapUS > Stats.MaxGapUS)
+		{
+			Stats.MaxGapUS = GapUS;
+		}
+		if (BackToBack)
+		{
+			Stats.BackToBack++;
+		}
+	}
+	Stats.Motions++;
+}
+
+/****************************************************************************
+ Function
+     ProfileDone
+
+ Description
+			Motion profile hook, runs in the profile ISR
+****************************************************************************/
+static void ProfileDone(void)
+{
+	PostMotionDone(DONE_ON_RAMP);
+}
+
+/****************************************************************************
+ Function
+     EmergencyStop
+
+ Description
+			URGENT_STOP handler, runs in the ISR that detected the condition.
+			Bounded: halt the ramp, then four PWM generator writes
+****************************************************************************/
+static void EmergencyStop(void)
+{
+	HaltMotionProfile();
+	MotorsOff();
+}
+
+/****************************************************************************
+ Function
+     TurnTimedOut
+
+ Description
+			URGENT_TURN_TIMEOUT handler, runs from PendSV once the one-shot
+			has stopped the motors, below the ceiling so it may post
+****************************************************************************/
+static void TurnTimedOut(void)
+{
+	// a turn that timed out is over whether or not the angle was reached
+	CancelMeasuredTurn();
+	PostMotionDone(DONE_ON_TURN);
+}
+
+/****************************************************************************
+ Function
+     ReportStopLatency
+
+ Description
+			Compare the urgent stop, timed from detect to motors off, with
+			the time the stop took to come through the queue to this service,
+			the path it used to take before reaching the motors. Also the
+			longest window interrupts were masked: the all-interrupt regions
+			are what the safety ISRs can be held off by, the ceiling regions
+			what every other ISR can. Build with ES_CRITICAL_CEILING 0 for the
+			old everything-masked numbers
+****************************************************************************/
+static void ReportStopLatency(ES_Event ThisEvent)
+{
+	ES_UrgentStats_t Urgent;
+	ES_CriticalStats_t Critical;
+	
+	ES_UrgentGetStats(URGENT_STOP, &Urgent);
+	ES_GetCriticalStats(&Critical);
+	printf("\r\n stop latency: urgent %lu cycles (max %lu), queued %lu us\r\n",
+	       (unsigned long)Urgent.LastCycles, (unsigned long)Urgent.MaxCycles,
+	       (unsigned long)(ES_Timer_GetTimeUS32() - ES_EventGetTime(ThisEvent)));
+	printf(" masked: safety ISRs max %lu cycles (%lu regions), other ISRs max %lu cycles (%lu regions)\r\n",
+	       (unsigned long)Critical.All.MaxCycles, (unsigned long)Critical.All.Count,
+	       (unsigned long)Critical.Ceiling.MaxCycles, (unsigned long)Critical.Ceiling.Count);
+}
+
+/****************************************************************************
+ Function
+     DispatchCommand
+
+ Parameters
+     uint8_t Opcode : command byte from the command generator
+
+ Description
+			One table lookup per command, anything without an entry goes to
+			DoUnknown
+****************************************************************************/
+static void DispatchCommand(uint8_t Opcode)
+{
+	CommandEntry_t const *pEntry = &CommandTable[Opcode];
+
+	if (pEntry->pHandler == 0)
+	{
+		DoUnknown(Opcode);
+	}
+	else
+	{
+		pEntry->pHandler(pEntry->Arg);
+	}
+}
+
+/****************************************************************************
+ Command handlers, Arg comes from the command's CommandTable entry
+****************************************************************************/
+static void DoStop(int16_t Arg)
+{
+	stop();
+	//A search cut short must not stop a later motion
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+	StopIRDemod();
+	AlignPhase = ALIGN_IDLE;
+#elif IR_DETECTOR == IR_DETECT_EDGE_COUNT
+	StopBeaconCounter();
+#else
+	DisableIRInterrupt();
+#endif
+}
+
+// the run is over: stop, and start nothing SPIService has prefetched
+static void DoEndRun(int16_t Arg)
+{
+	DoStop(Arg);
+	StopCommandPrefetch();
+}
+
+// Degrees CCW positive; the open loop time scales between the 45 and 90
+// degree values
+static void DoTurn(int16_t Degrees)
+{
+	StartTurn(Degrees, TurnTimeout(Degrees));
+	start2rotate((Degrees < 0) ? CW : CCW);
+}
+
+// Duty signed, negative reverses
+static void DoDrive(int16_t Duty)
+{
+	if (Duty < 0)
+	{
+		drive(-Duty, BACKWARD);
+	}
+	else
+	{
+		drive(Duty, FORWARD);
+	}
+}
+
+// With the Goertzel detector one full turn finds the bearing and a measured turn
+// goes to it, see BeaconBearingModule. Otherwise spin until detected
+static void DoAlignBeacon(int16_t Arg)
+{
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+	StartBearingSweep();
+	StartIRDemod(BEACON_NONE);
+	AlignPhase = ALIGN_SWEEP;
+	SetTimeoutAndStartOneShot(SweepTimeout*TurnSafetyFactor);
+	start2rotate(CW);
+#elif IR_DETECTOR == IR_DETECT_EDGE_COUNT
+	rotate2beacon();
+	StartBeaconCounter(BEACON_LAB);
+#else
+	rotate2beacon();
+	EnableIRInterrupt();
+#endif
+}
+
+static void DoDrive2Tape(int16_t Arg)
+{
+	EnableTapeInterrupt();
+	drive(DUTY_FULL_SPEED, FORWARD);
+}
+
+// Arg is the opcode itself
+static void DoUnknown(int16_t Arg)
+{
+	UnknownCommands++;
+	printf("\r\n unknown command %x\r\n", Arg);
+}
+
 /****************************************************************************
  Function
      InitOneShotISR
@@ -301,41 +706,19 @@ ES_Event RunActionService(ES_Event ThisEvent)
 ****************************************************************************/
 static void InitOneShotISR(){
 	
-	// start by enabling the clock to the timer (Wide Timer 0)
-	HWREG(SYSCTL_RCGCWTIMER) |= SYSCTL_RCGCWTIMER_R0;
-
-	// kill a few cycles to let the clock get going
-	while((HWREG(SYSCTL_PRWTIMER) & SYSCTL_PRWTIMER_R0) != SYSCTL_PRWTIMER_R0){}
-
-	// make sure that timer (Timer A) is disabled before configuring
-	HWREG(WTIMER0_BASE+TIMER_O_CTL) &= ~TIMER_CTL_TBEN; //TAEN = Bit1
-
-	// set it up in 32bit wide (individual, not concatenated) mode
-	// the constant name derives from the 16/32 bit timer, but this is a 32/64
-	// bit timer so we are setting the 32bit mode
-	HWREG(WTIMER0_BASE+TIMER_O_CFG) = TIMER_CFG_16_BIT; //bits 0-2 = 0x04
-
-	// set up timer A in 1-shot mode so that it disables timer on timeouts
-	// first mask off the TAMR field (bits 0:1) then set the value for
-	// 1-shot mode = 0x01
-	HWREG(WTIMER0_BASE+TIMER_O_TBMR) = (HWREG(WTIMER0_BASE+TIMER_O_TBMR)& ~TIMER_TBMR_TBMR_M)| TIMER_TBMR_TBMR_1_SHOT;
+	// Wide Timer 0B in 1-shot mode so that it disables itself on timeouts,
+	// sharing the block with the tape capture on Timer A
+	// it is interrupt number 95
+	if (!ClaimTimer(WT0_B, TIMER_MODE_ONE_SHOT, "turn one-shot"))
+	{
+		return;
+	}
 	
 	// set timeout
 	OneShotTimeoutMS = 1000; //arbitrary initialization value
-	HWREG(WTIMER0_BASE+TIMER_O_TBILR) = TicksPerMS*OneShotTimeoutMS;
-	
-	// enable a local timeout interrupt. TBTOIM = bit 1
-	HWREG(WTIMER0_BASE+TIMER_O_IMR) |= TIMER_IMR_TBTOIM; // bit1
-
-	// enable the Timer B in Wide Timer 0 interrupt in the NVIC
-	// it is interrupt number 95 so appears in EN2 at bit 31
-	HWREG(NVIC_EN2) |= BIT31HI;
-	
-	// set priority of this timer 
-	HWREG(NVIC_PRI23) |= NVIC_PRI23_INTD_M;
+	SetTimerLoad(WT0_B, TicksPerMS*OneShotTimeoutMS);
 
-	// make sure interrupts are enabled globally
-	__enable_irq();
+	// its priority, ES_SAFETY_PRIORITY, is in InterruptPriorities.c
 	
 	printf("\r\nGot through one shot interrupt init\r\n");
 }
@@ -362,10 +745,131 @@ static void InitOneShotISR(){
 static void SetTimeoutAndStartOneShot( uint32_t OneShotTimeoutMS )
 {
 	// set timeout
-	HWREG(WTIMER0_BASE+TIMER_O_TBILR) = TicksPerMS*OneShotTimeoutMS;
+	SetTimerLoad(WT0_B, TicksPerMS*OneShotTimeoutMS);
 	
 	// now kick the timer off by enabling it and enabling the timer to stall while stopped by the debugger
-	HWREG(WTIMER0_BASE+TIMER_O_CTL) |= (TIMER_CTL_TBEN | TIMER_CTL_TBSTALL);
+	StartTimer(WT0_B);
+}
+
+/****************************************************************************
+ Function
+     StopOneShot
+
+ Description
+			Disable the oneshot timer without letting it fire
+****************************************************************************/ 
+static void StopOneShot(void)
+{
+	StopTimer(WT0_B);
+}
+
+/****************************************************************************
+ Function
+     StartTurn
+
+ Parameters
+     int16_t Degrees : CCW positive
+     uint32_t TimeoutMS : open loop time the turn used to take
+
+ Description
+			Arm the odometry to end the turn on the measured angle, with
+			the oneshot as a backup in case the encoders stop counting
+****************************************************************************/ 
+static void StartTurn(int16_t Degrees, uint32_t TimeoutMS)
+{
+	StartMeasuredTurn(Degrees, MeasuredTurnDone);
+	SetTimeoutAndStartOneShot(TimeoutMS*TurnSafetyFactor);
+}
+
+/****************************************************************************
+ Function
+     TurnTimeout
+
+ Parameters
+     int16_t Degrees : CCW positive
+
+ Returns
+     uint32_t open loop time of the turn in ms, scaled between the 45
+     and 90 degree values
+****************************************************************************/ 
+static uint32_t TurnTimeout(int16_t Degrees)
+{
+	uint16_t Magnitude = (Degrees < 0) ? -Degrees : Degrees;
+	
+	return Rotate45Timeout + 
+	       ((int32_t)Magnitude - 45)*(Rotate90Timeout - Rotate45Timeout)/45;
+}
+
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+/****************************************************************************
+ Function
+     LogSweepBlock
+
+ Parameters
+     ES_Event ThisEvent : the IRSamplesReady just processed
+
+ Description
+			Log the lab beacon's strength in the block against heading. Once
+			the sweep has gone all the way round turn to the bearing, or give
+			up if the beacon was never seen
+****************************************************************************/ 
+static void LogSweepBlock(ES_Event ThisEvent)
+{
+	uint16_t Amplitudes[NUM_BEACONS];
+	uint32_t Bearing;
+	int16_t Degrees;
+	
+	GetBeaconAmplitudes(Amplitudes);
+	if (!LogBeaconBlock(ES_EventGetTime(ThisEvent), Amplitudes[BEACON_LAB]))
+	{
+		return;
+	}
+	StopOneShot();
+	if (!EstimateBearing(&Bearing))
+	{
+		stop();
+		EndAlignment();
+		return;
+	}
+	Degrees = BearingTurnDegrees(Bearing);
+	AlignPhase = ALIGN_TURN;
+	StartTurn(Degrees, TurnTimeout(Degrees));
+	start2rotate((Degrees < 0) ? CW : CCW);
+}
+
+/****************************************************************************
+ Function
+     EndAlignment
+
+ Description
+			The alignment is over, let the pipeline carry on
+****************************************************************************/ 
+static void EndAlignment(void)
+{
+	AlignPhase = ALIGN_IDLE;
+	StopIRDemod();
+	PostMotionDone(DONE_ON_BEACON);
+}
+#endif
+
+/****************************************************************************
+ Function
+     MeasuredTurnDone
+
+ Description
+			Called from the encoder ISR once the turn angle has been reached.
+			Stops hard through the urgent stop, as the one-shot does. A ramped
+			stop would rebuild the motion profile inside the ISR, on top of any
+			SetMotionTarget the service was in the middle of, and keep turning
+			through the ramp. The wheels still coast a few degrees past the
+			angle once the motors are off, and DONE_ON_TURN is posted while
+			they do
+****************************************************************************/ 
+static void MeasuredTurnDone(void)
+{
+	StopOneShot();
+	ES_UrgentRun(URGENT_STOP);
+	PostMotionDone(DONE_ON_TURN);
 }
 
 /****************************************************************************
@@ -383,18 +887,312 @@ static void SetTimeoutAndStartOneShot( uint32_t OneShotTimeoutMS )
 			stops whatever motion is going on
 			
  Notes
+			Runs above the framework critical ceiling, so it only stops the
+			motors here and pends the rest of the timeout to PendSV
 
  Author
      Team 16 
 ****************************************************************************/ 
 void OneShotISR(void){
 	
+	ES_ISR_ENTRY(ISR_TURN_ONESHOT);
+	
 	// clear interrupt
 	HWREG(WTIMER0_BASE+TIMER_O_ICR) = TIMER_ICR_TBTOCINT; 
 	
 	// stop current motion
-	stop();
+	ES_UrgentRun(URGENT_STOP);
+	ES_UrgentPend(URGENT_TURN_TIMEOUT);
+	
+	ES_ISR_EXIT(ISR_TURN_ONESHOT);
+}
+
+#ifdef TEST
+/* host test for the command table: every one of the 256 command bytes is
+   sent as a direct command and the motor calls it makes are checked. Then
+   a prefetched sequence is run to check that motions chain on MOTION_DONE.
+   Build this file alone with TEST defined; the functions it calls in other
+   modules are replaced by the stubs below, which log what they were asked
+   to do
+*/
+#include <string.h>
+
+static char CallLog[128];
+
+static void LogCall(char const *Call)
+{
+	strncat(CallLog, Call, sizeof(CallLog) - strlen(CallLog) - 1);
+}
+
+void stop(void) { LogCall("stop;"); }
+void drive(uint8_t Duty, bool direction)
+{
+	char Call[24];
+	sprintf(Call, "drive %d %s;", Duty, (direction == FORWARD) ? "fwd" : "rev");
+	LogCall(Call);
+}
+void start2rotate(bool direction) { LogCall((direction == CW) ? "rotate CW;" : "rotate CCW;"); }
+void rotate2beacon(void) { LogCall("beacon;"); }
+void EnableTapeInterrupt(void) { LogCall("tape;"); }
+void StartMeasuredTurn(int16_t Degrees, TurnDoneFunc_t *pDone)
+{
+	char Call[24];
+	sprintf(Call, "turn %d;", Degrees);
+	LogCall(Call);
+}
+void SetTimerLoad(TimerChannel_t Channel, uint32_t Ticks)
+{
+	char Call[24];
+	sprintf(Call, "timeout %lu;", (unsigned long)(Ticks/TicksPerMS));
+	LogCall(Call);
+}
+void CancelMeasuredTurn(void) {}
+void StartTimer(TimerChannel_t Channel) {}
+void StopTimer(TimerChannel_t Channel) {}
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner) { return true; }
+void PrintTimerAllocations(void) {}
+void PrintInterruptProfile(void) {}
+void PrintDMAAllocations(void) {}
+void InitInputCaptureForIRDetection(void) {}
+void EnableIRInterrupt(void) {}
+void DisableIRInterrupt(void) {}
+void ProcessIRBlock(uint8_t Half) {}
+void InitBeaconCounter(void) {}
+void StartBeaconCounter(Beacon_t Target) {}
+void StopBeaconCounter(void) {}
+char const *GetBeaconName(Beacon_t Beacon) { return ""; }
+uint32_t QueryBeaconHz(void) { return 0; }
+void InitIRDemod(void) {}
+void StartIRDemod(Beacon_t Target) {}
+void StopIRDemod(void) {}
+void ProcessIRSamples(uint8_t Half) {}
+void PrintIRDemodStats(void) {}
+void GetBeaconAmplitudes(uint16_t *pAmplitudes) {}
+void StartBearingSweep(void) {}
+bool LogBeaconBlock(uint32_t BlockEndUS, uint16_t Strength) { return false; }
+bool EstimateBearing(uint32_t *pHeading) { return false; }
+int16_t BearingTurnDegrees(uint32_t Bearing) { return 0; }
+void InitializePWM(void) {}
+void InitMotionProfile(void) {}
+void InitOdometry(void) {}
+void InitTapeInterrupt(void) {}
+bool ES_PostToService(uint8_t WhichService, ES_Event ThisEvent) { return true; }
+bool ES_Subscribe(uint8_t WhichService, ES_EventTyp_t EventType) { return true; }
+bool ES_UrgentRegister(ES_UrgentAction_t Action, ES_UrgentFunc_t *pHandler) { return true; }
+void ES_UrgentRun(ES_UrgentAction_t Action) {}
+void ES_UrgentPend(ES_UrgentAction_t Action) {}
+void ES_IsrEntry(ES_IsrId_t Id) {}
+void ES_IsrExit(ES_IsrId_t Id) {}
+void ES_UrgentGetStats(ES_UrgentAction_t Action, ES_UrgentStats_t *pStats)
+{
+	pStats->Count = 0;
+	pStats->LastCycles = 0;
+	pStats->MaxCycles = 0;
+}
+void ES_GetCriticalStats(ES_CriticalStats_t *pStats)
+{
+	memset(pStats, 0, sizeof(*pStats));
+}
+void HaltMotionProfile(void) {}
+void MotorsOff(void) {}
+void SetProfileDoneHook(ProfileDoneFunc_t *pHook) {}
+
+static uint32_t NowUS = 0;
+uint32_t ES_Timer_GetTimeUS32(void) { return NowUS; }
+
+// stands in for the SPIService lookahead
+static uint8_t Prefetched[8];
+static uint8_t PrefetchedHead = 0;
+static uint8_t PrefetchedTail = 0;
+bool GetNextCommand(uint8_t *pOpcode)
+{
+	if (PrefetchedHead == PrefetchedTail)
+	{
+		return false;
+	}
+	*pOpcode = Prefetched[PrefetchedHead++];
+	return true;
+}
+void StopCommandPrefetch(void)
+{
+	PrefetchedHead = PrefetchedTail;
+	LogCall("flush;");
+}
+
+static ES_Event MakeEvent(ES_EventTyp_t Type, uint16_t Param)
+{
+	ES_Event ThisEvent;
+	ThisEvent.EventType = Type;
+	ThisEvent.EventParam = Param;
+	ES_EventSetTime(&ThisEvent, NowUS);
+	return ThisEvent;
+}
+
+// run a prefetched sequence, each step is an event and the calls it causes
+typedef struct {
+	ES_EventTyp_t Type;
+	uint16_t Param;
+	uint32_t AtUS;
+	char const *Calls;
+} PipelineStep_t;
+
+static PipelineStep_t const PipelineSteps[] = {
+	{ NEXT_COMMAND, CW_90,  1000,  "turn -90;timeout 2100;rotate CW;" },
+	{ NEXT_COMMAND, FORWARD_FULL_SPEED, 1500, "" },      /* turn still running */
+	{ MOTION_DONE,  DONE_ON_RAMP, 1600,  "" },           /* spin ramp, not the turn */
+	{ MOTION_DONE,  DONE_ON_TURN, 9000,  "drive 100 fwd;" },
+	{ MOTION_DONE,  DONE_ON_RAMP, 9500,  "" },           /* nothing prefetched */
+	{ NEXT_COMMAND, 0x42,   20000, "" },                 /* unknown, skipped */
+	{ NEXT_COMMAND, STOP,   20500, "stop;" },
+};
+
+// TapeSensed posts the DONE_ON_TAPE, which the stub queue drops, so the
+// test delivers it
+static PipelineStep_t const TapeSteps[] = {
+	{ TapeSensed,   0,            0, "" },
+	{ MOTION_DONE,  DONE_ON_TAPE, 0, "stop;flush;" },
+	{ MOTION_DONE,  DONE_ON_RAMP, 0, "" },              /* nothing started */
+};
+
+typedef struct {
+	uint8_t Opcode;
+	char const *Calls;
+} ExpectedCalls_t;
+
+static ExpectedCalls_t const Expected[] = {
+	{ STOP,               "stop;" },
+	{ CW_90,              "turn -90;timeout 2100;rotate CW;" },
+	{ CW_45,              "turn -45;timeout 1100;rotate CW;" },
+	{ CCW_90,             "turn 90;timeout 2100;rotate CCW;" },
+	{ CCW_45,             "turn 45;timeout 1100;rotate CCW;" },
+	{ END_RUN_CMD,        "stop;flush;" },
+	{ FORWARD_HALF_SPEED, "drive 75 fwd;" },
+	{ FORWARD_FULL_SPEED, "drive 100 fwd;" },
+	{ REVERSE_HALF_SPEED, "drive 75 rev;" },
+	{ REVERSE_FULL_SPEED, "drive 100 rev;" },
+#if IR_DETECTOR == IR_DETECT_GOERTZEL
+	{ ALIGN_BEACON,       "timeout 8400;rotate CW;" },  /* bearing sweep */
+#else
+	{ ALIGN_BEACON,       "beacon;" },
+#endif
+	{ DRIVE2TAPE,         "tape;drive 100 fwd;" },
+};
+
+#define OPCODE_COUNT_ENTRY(Name, Value) +1
+#define NUM_KNOWN_OPCODES (0 COMMAND_OPCODES(OPCODE_COUNT_ENTRY))
+
+int main(void)
+{
+	ES_Event Command;
+	char const *pWant;
+	uint16_t Opcode;
+	uint8_t i;
+	uint16_t Failures = 0;
+	uint16_t Unknown = 0;
+
+	Command.EventType = ISR_COMMAND;
+	for (Opcode = 0; Opcode < NUM_OPCODES; Opcode++)
+	{
+		if (Opcode == READY4NEXTCOMMAND)
+		{
+			continue;
+		}
+		pWant = "";
+		for (i = 0; i < sizeof(Expected)/sizeof(Expected[0]); i++)
+		{
+			if (Expected[i].Opcode == Opcode)
+			{
+				pWant = Expected[i].Calls;
+			}
+		}
+		if (*pWant == '\0')
+		{
+			Unknown++;
+		}
+
+		CallLog[0] = '\0';
+		Command.EventParam = Opcode;
+		RunActionService(Command);
+
+		if (strcmp(CallLog, pWant) != 0)
+		{
+			printf("\r\nFAIL opcode %02x: got \"%s\" want \"%s\"\r\n", Opcode, CallLog, pWant);
+			Failures++;
+		}
+	}
+	if (GetUnknownCommandCount() != Unknown)
+	{
+		printf("\r\nFAIL %u unknown commands counted, %u expected\r\n", GetUnknownCommandCount(), Unknown);
+		Failures++;
+	}
+	if (sizeof(Expected)/sizeof(Expected[0]) != NUM_KNOWN_OPCODES)
+	{
+		printf("\r\nFAIL expected calls listed for %u of %u opcodes\r\n",
+		       (unsigned)(sizeof(Expected)/sizeof(Expected[0])), NUM_KNOWN_OPCODES);
+		Failures++;
+	}
+	printf("\r\ncommand table test: %u known, %u unknown, %u failures\r\n",
+	       NUM_KNOWN_OPCODES, Unknown, Failures);
+
+	// tape: the table test left DRIVE2TAPE running with a command
+	// prefetched behind it. The tape ends the drive and the run, and the
+	// prefetched command must not start once the stop ramp finishes
+	Prefetched[PrefetchedTail++] = FORWARD_FULL_SPEED;
+	for (i = 0; i < sizeof(TapeSteps)/sizeof(TapeSteps[0]); i++)
+	{
+		CallLog[0] = '\0';
+		RunActionService(MakeEvent(TapeSteps[i].Type, TapeSteps[i].Param));
+		if (strcmp(CallLog, TapeSteps[i].Calls) != 0)
+		{
+			printf("\r\nFAIL tape step %u: got \"%s\" want \"%s\"\r\n", i, CallLog, TapeSteps[i].Calls);
+			Failures++;
+		}
+	}
+	ClearPipelineStats();
+	for (i = 0; i < sizeof(PipelineSteps)/sizeof(PipelineSteps[0]); i++)
+	{
+		NowUS = PipelineSteps[i].AtUS;
+		if (PipelineSteps[i].Type == NEXT_COMMAND)
+		{
+			Prefetched[PrefetchedTail++] = (uint8_t)PipelineSteps[i].Param;
+		}
+		CallLog[0] = '\0';
+		RunActionService(MakeEvent(PipelineSteps[i].Type, PipelineSteps[i].Param));
+		if (strcmp(CallLog, PipelineSteps[i].Calls) != 0)
+		{
+			printf("\r\nFAIL pipeline step %u: got \"%s\" want \"%s\"\r\n", i, CallLog, PipelineSteps[i].Calls);
+			Failures++;
+		}
+	}
+	{
+		PipelineStats_t Pipeline;
+		GetPipelineStats(&Pipeline);
+		printf("\r\npipeline: %lu motions, %lu gaps, %lu back to back, last %lu us, max %lu us\r\n",
+		       (unsigned long)Pipeline.Motions, (unsigned long)Pipeline.Gaps,
+		       (unsigned long)Pipeline.BackToBack, (unsigned long)Pipeline.LastGapUS,
+		       (unsigned long)Pipeline.MaxGapUS);
+		// FORWARD chained with no gap, STOP waited 20500 - 9500 us
+		if ((Pipeline.Motions != 3) || (Pipeline.BackToBack != 1) ||
+		    (Pipeline.LastGapUS != 11000) || (Pipeline.TotalGapUS != 11000))
+		{
+			printf("\r\nFAIL pipeline stats\r\n");
+			Failures++;
+		}
+	}
+#if (IR_DETECTOR == IR_DETECT_EDGE_COUNT) || (IR_DETECTOR == IR_DETECT_CAPTURE) || \
+    (IR_DETECTOR == IR_DETECT_CAPTURE_DMA)
+	// the detector only reports the beacon, the stop comes from here
+	CallLog[0] = '\0';
+	RunActionService(MakeEvent(MOTION_DONE, DONE_ON_BEACON));
+	if (strcmp(CallLog, "stop;") != 0)
+	{
+		printf("\r\nFAIL beacon found: got \"%s\" want \"stop;\"\r\n", CallLog);
+		Failures++;
+	}
+#endif
+	return (Failures != 0);
 }
+#endif
 
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,456 @@
+/****************************************************************************
+Beacon Bearing Module
+	Find the heading of a beacon from one full turn instead of spinning
+	until it is first seen.
+
+	Spinning until the beacon is detected stops the robot at the edge of
+	the beam, where the signal first crosses the detection threshold,
+	plus however far it turns while the detection and the stop take
+	effect. Here the robot turns once while the strength of each IR block
+	is logged against heading (from the encoders), the bearing is taken
+	as the centre of the strongest lobe, and a measured turn goes straight
+	there.
+
+	A block's strength is the average over the block, so it is logged at
+	the heading the robot had in the middle of the block: the heading when
+	the block is handled, less the turn rate times how long ago that was.
+
+	The lobe centre is the strength weighted centroid of the bins around
+	the strongest one that are at least half its strength, which also
+	finds the middle of a flat topped lobe.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+
+#include "OdometryModule.h"
+#include "IRDemodModule.h"
+#include "BeaconBearingModule.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// BAM in a bin, 2^32/BEARING_BINS
+#define BIN_SHIFT 26
+#if (1UL << (32 - BIN_SHIFT)) != BEARING_BINS
+#error BIN_SHIFT does not match BEARING_BINS
+#endif
+
+// 2^32/360 binary angle units per degree
+#define BAM_PER_DEGREE 11930465L
+
+// a block of IR samples, in uS
+#define BLOCK_US ((1000000UL/IR_DEMOD_SAMPLE_HZ)*IR_DEMOD_BLOCK)
+
+// weakest peak taken for a beacon, in ADC counts
+#define MIN_STRENGTH 20
+
+/*---------------------------- Module Variables ---------------------------*/
+// strongest block seen in each heading bin
+static uint16_t Bins[BEARING_BINS];
+// how far the sweep has turned, in BAM, either way
+static uint64_t Swept;
+static uint32_t LastSampleHeading;
+static bool HaveSample;
+// heading and time of the last LogBeaconBlock, for the turn rate
+static uint32_t LastHeading;
+static uint32_t LastUS;
+static bool HaveRate;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     StartBearingSweep
+
+ Description
+     Forget the last sweep. The caller starts the robot turning
+****************************************************************************/
+void StartBearingSweep(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < BEARING_BINS; i++)
+	{
+		Bins[i] = 0;
+	}
+	Swept = 0;
+	HaveSample = false;
+	HaveRate = false;
+}
+
+/****************************************************************************
+ Function
+     LogBeaconBlock
+
+ Parameters
+     uint32_t BlockEndUS : EventTime of the IRSamplesReady for the block
+     uint16_t Strength : the beacon's amplitude in the block
+
+ Returns
+     bool true once the sweep has covered a full turn
+
+ Description
+     Called from the service as each block is processed during the sweep
+****************************************************************************/
+bool LogBeaconBlock(uint32_t BlockEndUS, uint16_t Strength)
+{
+	Pose_t Pose;
+	uint32_t Now;
+	uint32_t Heading;
+
+	GetPose(&Pose);
+	Now = ES_Timer_GetTimeUS32();
+	Heading = Pose.Heading;
+
+	//Back up to the middle of the block at the rate since the last one
+	if (HaveRate && (Now != LastUS))
+	{
+		Heading -= (int32_t)(((int64_t)(int32_t)(Pose.Heading - LastHeading)*
+		                      (int32_t)(Now - BlockEndUS + BLOCK_US/2))/
+		                     (int32_t)(Now - LastUS));
+	}
+	LastHeading = Pose.Heading;
+	LastUS = Now;
+	HaveRate = true;
+
+	return AddBearingSample(Heading, Strength);
+}
+
+/****************************************************************************
+ Function
+     AddBearingSample
+
+ Parameters
+     uint32_t Heading : binary angle the strength was seen at
+     uint16_t Strength
+
+ Returns
+     bool true once the samples have covered a full turn
+****************************************************************************/
+bool AddBearingSample(uint32_t Heading, uint16_t Strength)
+{
+	uint8_t Bin = Heading >> BIN_SHIFT;
+	int32_t Step;
+
+	if (Strength > Bins[Bin])
+	{
+		Bins[Bin] = Strength;
+	}
+	if (HaveSample)
+	{
+		Step = (int32_t)(Heading - LastSampleHeading);
+		Swept += (Step < 0) ? -(int64_t)Step : Step;
+	}
+	LastSampleHeading = Heading;
+	HaveSample = true;
+
+	return (Swept >= (1ULL << 32));
+}
+
+/****************************************************************************
+ Function
+     EstimateBearing
+
+ Parameters
+     uint32_t *pHeading : the beacon's binary angle heading
+
+ Returns
+     bool false if no bin reached MIN_STRENGTH
+****************************************************************************/
+bool EstimateBearing(uint32_t *pHeading)
+{
+	uint8_t Peak = 0;
+	uint8_t Offset;
+	uint16_t Half;
+	uint16_t Strength;
+	uint32_t Sum;
+	int32_t Moment = 0;
+	uint8_t i;
+
+	for (i = 1; i < BEARING_BINS; i++)
+	{
+		if (Bins[i] > Bins[Peak])
+		{
+			Peak = i;
+		}
+	}
+	if (Bins[Peak] < MIN_STRENGTH)
+	{
+		return false;
+	}
+
+	//The bins either side down to half the peak, wrapping round
+	Half = Bins[Peak]/2;
+	Sum = Bins[Peak];
+	for (Offset = 1; Offset < BEARING_BINS/2; Offset++)
+	{
+		Strength = Bins[(Peak + Offset) % BEARING_BINS];
+		if (Strength < Half)
+		{
+			break;
+		}
+		Sum += Strength;
+		Moment += Offset*Strength;
+	}
+	for (Offset = 1; Offset < BEARING_BINS/2; Offset++)
+	{
+		Strength = Bins[(Peak + BEARING_BINS - Offset) % BEARING_BINS];
+		if (Strength < Half)
+		{
+			break;
+		}
+		Sum += Strength;
+		Moment -= Offset*Strength;
+	}
+
+	//The middle of the peak bin, moved by the centroid in bins
+	*pHeading = ((uint32_t)Peak << BIN_SHIFT) + (1UL << (BIN_SHIFT - 1)) +
+	            (int32_t)(((int64_t)Moment << BIN_SHIFT)/(int32_t)Sum);
+	return true;
+}
+
+/****************************************************************************
+ Function
+     BearingTurnDegrees
+
+ Parameters
+     uint32_t Bearing : from EstimateBearing
+
+ Returns
+     int16_t turn from the current heading, CCW positive, within what
+     StartMeasuredTurn takes
+****************************************************************************/
+int16_t BearingTurnDegrees(uint32_t Bearing)
+{
+	Pose_t Pose;
+	int32_t Degrees;
+
+	GetPose(&Pose);
+	Degrees = ((int32_t)(Bearing - Pose.Heading))/BAM_PER_DEGREE;
+	if (Degrees > 179)
+	{
+		Degrees = 179;
+	}
+	else if (Degrees < -179)
+	{
+		Degrees = -179;
+	}
+	return (int16_t)Degrees;
+}
+
+#ifdef TEST
+/* host simulation of the alignment, spin until detected against sweep and
+   turn, for the beacon at a range of bearings. The robot turns at a rate
+   proportional to its duty, which ramps at the motion profile's slew
+   rate, so every stop coasts. The beacon's strength falls off as cos^8
+   of the angle off it, +-24 degrees to half strength, and each 20 mS
+   block reports its average with a little noise, handled up to 8 mS late
+   by the service. Spin until detected stops on the first block over
+   MIN_STRENGTH, as the demodulator reports a beacon; sweep and turn runs
+   the real LogBeaconBlock and EstimateBearing, then a measured turn.
+   Reported: final heading error and time until the robot is at rest.
+   gcc -DTEST -I<stubs> -IHeaders Source/BeaconBearingModule.c -lm
+*/
+#include <math.h>
+#include "MotionProfileModule.h"
+
+#define SIM_DEG_PER_S_FULL 130.0   // spin rate at 100% duty
+#define SIM_STRENGTH 300.0
+#define SIM_BLOCK_MS 20
+#define SIM_MAX_MS 20000
+#define SIM_PI 3.14159265358979323846
+
+typedef enum { SPIN_UNTIL_SEEN, SWEEP_AND_TURN } SimMethod_t;
+
+static double SimHeading;     // degrees, CCW positive
+static double SimDuty;        // signed, CCW positive
+static double SimTargetDuty;
+static uint32_t SimMS;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t Range)
+{
+	Seed = Seed * 1103515245UL + 12345UL;
+	return (Seed >> 8) % Range;
+}
+
+void GetPose(Pose_t *pPose)
+{
+	double Wrapped = fmod(SimHeading, 360.0);
+
+	if (Wrapped < 0)
+	{
+		Wrapped += 360.0;
+	}
+	pPose->XUM = 0;
+	pPose->YUM = 0;
+	pPose->Heading = (uint32_t)(Wrapped/360.0*4294967296.0);
+}
+uint32_t ES_Timer_GetTimeUS32(void) { return SimMS*1000; }
+
+// signed difference a - b, within +-180
+static double AngleDiff(double a, double b)
+{
+	double Diff = fmod(a - b, 360.0);
+
+	if (Diff > 180.0)
+	{
+		Diff -= 360.0;
+	}
+	else if (Diff < -180.0)
+	{
+		Diff += 360.0;
+	}
+	return Diff;
+}
+
+static double Strength(double Bearing)
+{
+	double Cos = cos(AngleDiff(SimHeading, Bearing)*SIM_PI/180.0);
+
+	return (Cos > 0) ? SIM_STRENGTH*pow(Cos, 8) : 0;
+}
+
+// one mS of the motors: the duty slews toward its target, the heading follows
+static void SimStep(void)
+{
+	double Slew = (double)DUTY_SLEW_PER_TICK/PROFILE_TICK_MS;
+
+	if (SimDuty < SimTargetDuty)
+	{
+		SimDuty = (SimDuty + Slew > SimTargetDuty) ? SimTargetDuty : SimDuty + Slew;
+	}
+	else if (SimDuty > SimTargetDuty)
+	{
+		SimDuty = (SimDuty - Slew < SimTargetDuty) ? SimTargetDuty : SimDuty - Slew;
+	}
+	SimHeading += SIM_DEG_PER_S_FULL*SimDuty/100.0/1000.0;
+	SimMS++;
+}
+
+// final heading error in degrees, time to rest in pTimeMS
+static double Align(SimMethod_t Method, double Bearing, uint32_t *pTimeMS)
+{
+	double BlockSum = 0;
+	uint16_t BlockStrength = 0;
+	uint32_t BlockEndMS = 0;
+	uint32_t ServiceAtMS = 0;
+	bool Pending = false;
+	bool Stopping = false;
+	bool Turning = false;
+	double TurnStart = 0;
+	int16_t TurnDegrees = 0;
+	uint32_t Estimate;
+	double Noise;
+
+	SimHeading = Random(360);
+	SimDuty = 0;
+	SimMS = 0;
+	if (Method == SPIN_UNTIL_SEEN)
+	{
+		// rotate2beacon, CW at 60%
+		SimTargetDuty = -60;
+	}
+	else
+	{
+		// start2rotate(CW) at full duty for the sweep
+		StartBearingSweep();
+		SimTargetDuty = -100;
+	}
+
+	while (SimMS < SIM_MAX_MS)
+	{
+		SimStep();
+		BlockSum += Strength(Bearing);
+		if ((SimMS % SIM_BLOCK_MS) == 0)
+		{
+			Noise = (double)Random(7) - 3;
+			BlockStrength = (BlockSum/SIM_BLOCK_MS + Noise > 0) ? (uint16_t)(BlockSum/SIM_BLOCK_MS + Noise) : 0;
+			BlockSum = 0;
+			BlockEndMS = SimMS;
+			ServiceAtMS = SimMS + Random(9);
+			Pending = true;
+		}
+		if (Pending && (SimMS >= ServiceAtMS) && !Stopping)
+		{
+			Pending = false;
+			if (Method == SPIN_UNTIL_SEEN)
+			{
+				if (BlockStrength >= MIN_STRENGTH)
+				{
+					SimTargetDuty = 0;
+					Stopping = true;
+				}
+			}
+			else if (!Turning && LogBeaconBlock(BlockEndMS*1000, BlockStrength))
+			{
+				if (!EstimateBearing(&Estimate))
+				{
+					break;
+				}
+				TurnDegrees = BearingTurnDegrees(Estimate);
+				TurnStart = SimHeading;
+				SimTargetDuty = (TurnDegrees < 0) ? -100 : 100;
+				Turning = true;
+			}
+		}
+		// the measured turn, as the encoder ISR checks it
+		if (Turning && !Stopping &&
+		    ((TurnDegrees < 0) ? (SimHeading - TurnStart <= TurnDegrees) :
+		                         (SimHeading - TurnStart >= TurnDegrees)))
+		{
+			SimTargetDuty = 0;
+			Stopping = true;
+		}
+		if (Stopping && (SimDuty == 0))
+		{
+			break;
+		}
+	}
+	*pTimeMS = SimMS;
+	return AngleDiff(SimHeading, Bearing);
+}
+
+int main(void)
+{
+	double Error[2];
+	uint32_t TimeMS[2];
+	double SumError[2] = { 0, 0 };
+	double MaxError[2] = { 0, 0 };
+	uint32_t SumTime[2] = { 0, 0 };
+	uint16_t Bearing;
+	uint16_t Runs = 0;
+	uint8_t m;
+
+	printf("\r\nbearing  spin until seen: error    ms   sweep and turn: error    ms\r\n");
+	for (Bearing = 0; Bearing < 360; Bearing += 23)
+	{
+		for (m = SPIN_UNTIL_SEEN; m <= SWEEP_AND_TURN; m++)
+		{
+			Error[m] = Align((SimMethod_t)m, Bearing, &TimeMS[m]);
+			SumError[m] += fabs(Error[m]);
+			SumTime[m] += TimeMS[m];
+			if (fabs(Error[m]) > MaxError[m])
+			{
+				MaxError[m] = fabs(Error[m]);
+			}
+		}
+		printf("%7u %22.1f %5lu %21.1f %5lu\r\n", Bearing, Error[0],
+		       (unsigned long)TimeMS[0], Error[1], (unsigned long)TimeMS[1]);
+		Runs++;
+	}
+	printf("mean |error| %15.1f %27.1f\r\n", SumError[0]/Runs, SumError[1]/Runs);
+	printf("max |error| %16.1f %27.1f\r\n", MaxError[0], MaxError[1]);
+	printf("mean time %24lu %27lu\r\n", (unsigned long)(SumTime[0]/Runs),
+	       (unsigned long)(SumTime[1]/Runs));
+	return (MaxError[1] < 10.0) ? 0 : 1;
+}
+#endif
@@ -0,0 +1,510 @@
+/****************************************************************************
+Beacon Counter Module
+	Find IR beacons by their frequency with one interrupt per gate window
+	instead of one per edge.
+
+	Wide Timer 1A counts the rising edges on PC6 in hardware (edge count
+	mode), and Wide Timer 4A is a periodic gate every BEACON_GATE_MS. The
+	gate ISR reads the count, takes the edges since the last window as the
+	frequency and looks it up in the beacon band table. The counter is never
+	stopped or reset, so no edge is lost between windows however late the
+	gate ISR runs.
+
+	A window that straddles a beacon coming into or out of view counts
+	part of its edges and can land in another beacon's band, so a band has
+	to be seen for BEACON_CONFIRM_WINDOWS windows in a row before it is
+	reported.
+
+Events to receive:
+  None
+
+Events to post:
+	IRBeaconClassified (published), when the confirmed band changes, the
+	band (or BEACON_NONE) as the param
+	MOTION_DONE (to ActionService), when the search target is found, which
+	ActionService answers by stopping the motors
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_timer.h"
+#include "BITDEFS.H"
+
+#include "ActionService.h"
+#include "TimerManager.h"
+#include "BeaconCounterModule.h"
+#include "ClockConfig.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define BitsPerNibble 4
+#define numbNibblesShifted 6
+#define pinC6Mask 0xf0ffffff
+
+/*---------------------------- Module Types -------------------------------*/
+typedef struct {
+	char const *Name;
+	uint16_t LowHz;
+	uint16_t HighHz;
+} BeaconBand_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+// in Beacon_t order. The lab beacon keeps IRBeaconModule's +-20%, the
+// others are +-10% so that neighbours do not overlap. Each band is several
+// times wider than the 1000/BEACON_GATE_MS Hz the count resolves
+static BeaconBand_t const BeaconBands[NUM_BEACONS] = {
+	[BEACON_LAB]  = { "lab 1950 Hz", 1560, 2340 },
+	[BEACON_909]  = { "909 Hz",       818, 1000 },
+	[BEACON_1250] = { "1250 Hz",     1125, 1375 },
+	[BEACON_3333] = { "3333 Hz",     3000, 3666 },
+};
+
+static uint32_t LastCount;
+static volatile uint32_t BeaconHz = 0;
+// band seen in the last windows, and how many windows in a row
+static Beacon_t Candidate = BEACON_NONE;
+static uint8_t CandidateWindows = 0;
+static volatile Beacon_t Reported = BEACON_NONE;
+// band that ends the search, BEACON_NONE to only report
+static Beacon_t SearchTarget = BEACON_NONE;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     InitBeaconCounter
+
+ Description
+     Wide Timer 1A counting edges on PC6 and Wide Timer 4A as the gate
+     (interrupt 102), both left stopped
+****************************************************************************/
+void InitBeaconCounter(void)
+{
+	if (!ClaimTimer(WT1_A, TIMER_MODE_EDGE_COUNT, "IR beacon counter") ||
+	    !ClaimTimer(WT4_A, TIMER_MODE_PERIODIC, "IR beacon gate"))
+	{
+		return;
+	}
+	SetTimerLoad(WT4_A, TicksPerMS*BEACON_GATE_MS);
+
+	//Enable the clock to Port C
+	HWREG(SYSCTL_RCGCGPIO) |= SYSCTL_RCGCGPIO_R2;
+
+	//Route PC6 to WT1CCP0, as for the edge capture
+	HWREG(GPIO_PORTC_BASE + GPIO_O_AFSEL) |= BIT6HI;
+	HWREG(GPIO_PORTC_BASE + GPIO_O_PCTL) = (HWREG(GPIO_PORTC_BASE + GPIO_O_PCTL) & pinC6Mask) + (7 << (BitsPerNibble*numbNibblesShifted));
+	HWREG(GPIO_PORTC_BASE + GPIO_O_DEN) |= BIT6HI;
+	HWREG(GPIO_PORTC_BASE + GPIO_O_DIR) &= BIT6LO;
+
+	printf("\r\nGot through IR beacon counter init\r\n");
+}
+
+/****************************************************************************
+ Function
+     StartBeaconCounter
+
+ Parameters
+     Beacon_t Target : band that posts MOTION_DONE, so the motors stop,
+       when confirmed, BEACON_NONE to only publish the bands seen
+
+ Description
+     Starts counting from no beacon reported
+****************************************************************************/
+void StartBeaconCounter(Beacon_t Target)
+{
+	StopBeaconCounter();
+	Candidate = BEACON_NONE;
+	CandidateWindows = 0;
+	Reported = BEACON_NONE;
+	BeaconHz = 0;
+	SearchTarget = Target;
+
+	//The first window counts from here
+	StartTimer(WT1_A);
+	LastCount = HWREG(WTIMER1_BASE + TIMER_O_TAR);
+	StartTimer(WT4_A);
+}
+
+/****************************************************************************
+ Function
+     StopBeaconCounter
+****************************************************************************/
+void StopBeaconCounter(void)
+{
+	StopTimer(WT4_A);
+	StopTimer(WT1_A);
+}
+
+/****************************************************************************
+ Function
+     ClassifyBeacon
+
+ Parameters
+     uint32_t Hz : measured edge frequency
+
+ Returns
+     Beacon_t the band it falls in, BEACON_NONE if none
+****************************************************************************/
+Beacon_t ClassifyBeacon(uint32_t Hz)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		if ((Hz >= BeaconBands[i].LowHz) && (Hz <= BeaconBands[i].HighHz))
+		{
+			return (Beacon_t)i;
+		}
+	}
+	return BEACON_NONE;
+}
+
+/****************************************************************************
+ Function
+     GetBeaconName
+****************************************************************************/
+char const *GetBeaconName(Beacon_t Beacon)
+{
+	return (Beacon < NUM_BEACONS) ? BeaconBands[Beacon].Name : "none";
+}
+
+/****************************************************************************
+ Function
+     QueryBeacon
+
+ Returns
+     Beacon_t the last confirmed band
+****************************************************************************/
+Beacon_t QueryBeacon(void)
+{
+	return Reported;
+}
+
+/****************************************************************************
+ Function
+     QueryBeaconHz
+
+ Returns
+     uint32_t frequency counted in the last window
+****************************************************************************/
+uint32_t QueryBeaconHz(void)
+{
+	return BeaconHz;
+}
+
+/****************************************************************************
+ Function
+     BeaconGateISR
+
+ Description
+     Wide Timer 4A timeout: the edges counted in the window that just ended
+****************************************************************************/
+void BeaconGateISR(void)
+{
+	uint32_t Count;
+	Beacon_t Seen;
+	ES_Event ThisEvent;
+
+	ES_ISR_ENTRY(ISR_BEACON_GATE);
+
+	//Start by clearing out the source of the interrupt
+	HWREG(WTIMER4_BASE + TIMER_O_ICR) = TIMER_ICR_TATOCINT;
+	ES_ISR_LATENCY(ISR_BEACON_GATE,
+	               HWREG(WTIMER4_BASE + TIMER_O_TAILR) - HWREG(WTIMER4_BASE + TIMER_O_TAV));
+
+	//Edges since the last read. A late read moves a few edges from the
+	//next window into this one, none are lost
+	Count = HWREG(WTIMER1_BASE + TIMER_O_TAR);
+	BeaconHz = (Count - LastCount)*(1000/BEACON_GATE_MS);
+	LastCount = Count;
+
+	Seen = ClassifyBeacon(BeaconHz);
+	if (Seen == Candidate)
+	{
+		if (CandidateWindows < BEACON_CONFIRM_WINDOWS)
+		{
+			CandidateWindows++;
+		}
+	}
+	else
+	{
+		Candidate = Seen;
+		CandidateWindows = 1;
+	}
+
+	if ((CandidateWindows == BEACON_CONFIRM_WINDOWS) && (Candidate != Reported))
+	{
+		Reported = Candidate;
+		if ((Reported != BEACON_NONE) && (Reported == SearchTarget))
+		{
+			//Found it, nothing more to count until the next search.
+			//ActionService stops the motors when it gets the MOTION_DONE,
+			//the ramp is not ISR safe
+			StopBeaconCounter();
+			PostMotionDone(DONE_ON_BEACON);
+		}
+		ThisEvent.EventType = IRBeaconClassified;
+		ThisEvent.EventParam = Reported;
+		ES_EventSetTime(&ThisEvent, ES_Timer_GetTimeUS32());
+		ES_Publish(ThisEvent);
+	}
+
+	ES_ISR_EXIT(ISR_BEACON_GATE);
+}
+
+#ifdef TEST
+/* host simulation of the gated count. The robot sweeps past a series of
+   beacons (or none), each in view for a while, with the edges jittered
+   and starting at a random phase. A simulated WT1A counts them into TAR
+   and the real gate ISR runs every BEACON_GATE_MS. The reports published
+   are checked against the beacons that were in view, and against the
+   reports a per window classification without confirmation would have
+   made. The timer registers are pages of host memory mapped at their
+   base addresses.
+   gcc -DTEST -I<stubs> -IHeaders Source/BeaconCounterModule.c
+*/
+#include <sys/mman.h>
+
+#define SIM_TICKS_PER_MS TicksPerMS
+#define MAX_SEGMENTS 8
+#define MAX_REPORTS 16
+
+typedef struct {
+	uint32_t Hz;      // 0 for no beacon in view
+	uint32_t MS;
+} SimSegment_t;
+
+typedef struct {
+	char const *Name;
+	Beacon_t Target;
+	SimSegment_t Segments[MAX_SEGMENTS];
+	Beacon_t Expected[MAX_REPORTS];   // ends at the first BEACON_NONE after a beacon
+	uint8_t NumExpected;
+} SimCase_t;
+
+static SimCase_t const Cases[] = {
+	{ "sweep past three", BEACON_NONE,
+	  { { 0, 107 }, { 909, 153 }, { 0, 71 }, { 3333, 149 }, { 0, 63 },
+	    { 1250, 151 }, { 0, 100 } },
+	  { BEACON_909, BEACON_NONE, BEACON_3333, BEACON_NONE, BEACON_1250, BEACON_NONE }, 6 },
+	{ "stop on lab beacon", BEACON_LAB,
+	  { { 0, 93 }, { 3333, 120 }, { 0, 41 }, { 1950, 300 } },
+	  { BEACON_3333, BEACON_NONE, BEACON_LAB }, 3 },
+	{ "lab beacon in view", BEACON_NONE,
+	  { { 1950, 500 } },
+	  { BEACON_LAB }, 1 },
+};
+
+static bool SimCounting;
+static bool SimGating;
+static bool SimStopped;
+static uint32_t SimNow;
+static uint32_t SimStoppedAt;
+static Beacon_t SimReports[MAX_REPORTS];
+static uint8_t SimNumReports;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t Range)
+{
+	Seed = Seed * 1103515245UL + 12345UL;
+	return (Seed >> 8) % Range;
+}
+
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner) { return true; }
+void SetTimerLoad(TimerChannel_t Channel, uint32_t Ticks) {}
+void StartTimer(TimerChannel_t Channel)
+{
+	if (Channel == WT1_A)
+	{
+		SimCounting = true;
+	}
+	else
+	{
+		SimGating = true;
+	}
+}
+void StopTimer(TimerChannel_t Channel)
+{
+	if (Channel == WT1_A)
+	{
+		SimCounting = false;
+	}
+	else
+	{
+		SimGating = false;
+	}
+}
+// ActionService stops the motors on this
+void PostMotionDone(MotionDone_t Source)
+{
+	if (Source == DONE_ON_BEACON)
+	{
+		SimStopped = true;
+		SimStoppedAt = SimNow;
+	}
+}
+uint32_t ES_Timer_GetTimeUS32(void) { return SimNow/(SIM_TICKS_PER_MS/1000); }
+void ES_IsrEntry(ES_IsrId_t Id) {}
+void ES_IsrLatency(ES_IsrId_t Id, uint32_t SinceEvent) {}
+void ES_IsrExit(ES_IsrId_t Id) {}
+uint16_t ES_Publish(ES_Event ThisEvent)
+{
+	if ((ThisEvent.EventType == IRBeaconClassified) && (SimNumReports < MAX_REPORTS))
+	{
+		SimReports[SimNumReports++] = (Beacon_t)ThisEvent.EventParam;
+	}
+	return 0;
+}
+
+static bool RunCase(SimCase_t const *pCase)
+{
+	uint32_t Gate = BEACON_GATE_MS*SIM_TICKS_PER_MS;
+	uint32_t SegmentStart = 0;
+	uint32_t SegmentEnd;
+	uint32_t TargetInView = 0;
+	uint32_t Period;
+	uint32_t Edge;
+	uint32_t NextGate;
+	uint32_t Windows = 0;
+	uint32_t Edges = 0;
+	uint32_t Unconfirmed = 0;
+	Beacon_t LastSeen = BEACON_NONE;
+	bool Passed = true;
+	uint8_t s;
+	uint8_t i;
+
+	SimStopped = false;
+	SimNumReports = 0;
+	HWREG(WTIMER1_BASE + TIMER_O_TAR) = Random(1000);
+	StartBeaconCounter(pCase->Target);
+	NextGate = Gate;
+
+	for (s = 0; (s < MAX_SEGMENTS) && (pCase->Segments[s].MS != 0); s++)
+	{
+		SegmentEnd = SegmentStart + pCase->Segments[s].MS*SIM_TICKS_PER_MS;
+		Period = pCase->Segments[s].Hz ? (1000*SIM_TICKS_PER_MS)/pCase->Segments[s].Hz : 0;
+		Edge = SegmentStart + (Period ? Random(Period) : 0);
+		if ((TargetInView == 0) && (pCase->Target != BEACON_NONE) &&
+		    (ClassifyBeacon(pCase->Segments[s].Hz) == pCase->Target))
+		{
+			TargetInView = SegmentStart;
+		}
+		for (SimNow = SegmentStart; SimNow < SegmentEnd; )
+		{
+			if (Period && (Edge < NextGate) && (Edge < SegmentEnd))
+			{
+				SimNow = Edge;
+				if (SimCounting)
+				{
+					HWREG(WTIMER1_BASE + TIMER_O_TAR)++;
+					Edges++;
+				}
+				// +-0.5% jitter on each period
+				Edge += Period - Period/200 + Random(Period/100 + 1);
+			}
+			else if (NextGate < SegmentEnd)
+			{
+				SimNow = NextGate;
+				NextGate += Gate;
+				if (!SimGating)
+				{
+					continue;
+				}
+				Windows++;
+				// up to 10 uS of latency, the count keeps going meanwhile
+				HWREG(WTIMER4_BASE + TIMER_O_TAILR) = Gate;
+				HWREG(WTIMER4_BASE + TIMER_O_TAV) = Gate - Random(400);
+				BeaconGateISR();
+				// what reporting every window would have said
+				if (ClassifyBeacon(QueryBeaconHz()) != LastSeen)
+				{
+					LastSeen = ClassifyBeacon(QueryBeaconHz());
+					Unconfirmed++;
+				}
+			}
+			else
+			{
+				SimNow = SegmentEnd;
+			}
+		}
+		SegmentStart = SegmentEnd;
+	}
+
+	printf("%-20s %5lu %5lu %6lu  ", pCase->Name, (unsigned long)Edges,
+	       (unsigned long)Windows, (unsigned long)Unconfirmed);
+	for (i = 0; i < SimNumReports; i++)
+	{
+		printf("%s%s", i ? ", " : "", GetBeaconName(SimReports[i]));
+	}
+	Passed = (SimNumReports == pCase->NumExpected);
+	for (i = 0; Passed && (i < SimNumReports); i++)
+	{
+		Passed = (SimReports[i] == pCase->Expected[i]);
+	}
+	if (pCase->Target != BEACON_NONE)
+	{
+		// confirmed within a window of the confirmation windows
+		Passed = Passed && SimStopped && !SimGating &&
+		         (SimStoppedAt - TargetInView <= (BEACON_CONFIRM_WINDOWS + 1)*Gate);
+		printf(SimStopped ? "  stopped after %lu ms" : "  not stopped",
+		       (unsigned long)((SimStoppedAt - TargetInView)/SIM_TICKS_PER_MS));
+	}
+	printf("  %s\r\n", Passed ? "ok" : "FAILED");
+	return Passed;
+}
+
+int main(void)
+{
+	uint8_t Failures = 0;
+	uint8_t i;
+	uint8_t j;
+
+	if ((mmap((void *)WTIMER1_BASE, 0x1000, PROT_READ | PROT_WRITE,
+	          MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED) ||
+	    (mmap((void *)WTIMER4_BASE, 0x1000, PROT_READ | PROT_WRITE,
+	          MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED))
+	{
+		printf("could not map the simulated timers\r\n");
+		return 1;
+	}
+
+	// every band must classify to itself and no two may overlap
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		if (ClassifyBeacon((BeaconBands[i].LowHz + BeaconBands[i].HighHz)/2) != i)
+		{
+			printf("band %s does not classify to itself\r\n", BeaconBands[i].Name);
+			Failures++;
+		}
+		for (j = i + 1; j < NUM_BEACONS; j++)
+		{
+			if ((BeaconBands[i].LowHz <= BeaconBands[j].HighHz) &&
+			    (BeaconBands[j].LowHz <= BeaconBands[i].HighHz))
+			{
+				printf("bands %s and %s overlap\r\n", BeaconBands[i].Name, BeaconBands[j].Name);
+				Failures++;
+			}
+		}
+	}
+
+	printf("\r\n%d ms gate, %d windows to confirm\r\n", BEACON_GATE_MS, BEACON_CONFIRM_WINDOWS);
+	printf("case                 edges  ints  unconfirmed  reports\r\n");
+	for (i = 0; i < sizeof(Cases)/sizeof(Cases[0]); i++)
+	{
+		if (!RunCase(&Cases[i]))
+		{
+			Failures++;
+		}
+	}
+	printf("%u failures\r\n", Failures);
+	return Failures;
+}
+#endif
@@ -0,0 +1,490 @@
+/****************************************************************************
+Control Laws
+	PID and biquad filter in floating point, for control code that is
+	easier to write and tune in floats now that the FPU is on, and a fixed
+	point PID to set against it. The fixed point biquad is BiquadQ15 in
+	DSPKernels.
+
+	Single precision only: a double, or a float constant without the f,
+	goes to the software library. With lazy stacking (set in startup) an
+	ISR that runs one of these pays for saving the FP registers of the
+	code it interrupted (S0-S15 and FPSCR) the first time it touches the
+	FPU; ISRs that don't use the FPU pay nothing.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+#include "ControlLaws.h"
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     PIDInitFloat
+
+ Parameters
+     PIDFloat_t *pPID
+     float Kp, Ki, Kd : Ki and Kd per call
+     float OutMin, OutMax : output and integral limits
+****************************************************************************/
+void PIDInitFloat(PIDFloat_t *pPID, float Kp, float Ki, float Kd, float OutMin, float OutMax)
+{
+	pPID->Kp = Kp;
+	pPID->Ki = Ki;
+	pPID->Kd = Kd;
+	pPID->OutMin = OutMin;
+	pPID->OutMax = OutMax;
+	pPID->Integral = 0.0f;
+	pPID->LastError = 0.0f;
+}
+
+/****************************************************************************
+ Function
+     PIDFloat
+
+ Parameters
+     PIDFloat_t *pPID
+     float Error : setpoint less measurement
+
+ Returns
+     float the control output, within the limits
+****************************************************************************/
+float PIDFloat(PIDFloat_t *pPID, float Error)
+{
+	float Out;
+
+	pPID->Integral += pPID->Ki*Error;
+	if (pPID->Integral > pPID->OutMax)
+	{
+		pPID->Integral = pPID->OutMax;
+	}
+	else if (pPID->Integral < pPID->OutMin)
+	{
+		pPID->Integral = pPID->OutMin;
+	}
+	Out = pPID->Kp*Error + pPID->Integral + pPID->Kd*(Error - pPID->LastError);
+	pPID->LastError = Error;
+
+	if (Out > pPID->OutMax)
+	{
+		return pPID->OutMax;
+	}
+	if (Out < pPID->OutMin)
+	{
+		return pPID->OutMin;
+	}
+	return Out;
+}
+
+/****************************************************************************
+ Function
+     PIDInitFixed
+
+ Parameters
+     PIDFixed_t *pPID
+     int32_t Kp, Ki, Kd : Q16, PID_GAIN_Q16 for constants
+     int16_t OutMin, OutMax : output and integral limits
+****************************************************************************/
+void PIDInitFixed(PIDFixed_t *pPID, int32_t Kp, int32_t Ki, int32_t Kd, int16_t OutMin, int16_t OutMax)
+{
+	pPID->Kp = Kp;
+	pPID->Ki = Ki;
+	pPID->Kd = Kd;
+	pPID->OutMin = OutMin;
+	pPID->OutMax = OutMax;
+	pPID->Integral = 0;
+	pPID->LastError = 0;
+}
+
+/****************************************************************************
+ Function
+     PIDFixed
+
+ Parameters
+     PIDFixed_t *pPID
+     int32_t Error : setpoint less measurement
+
+ Returns
+     int16_t the control output rounded, within the limits
+
+ Description
+     The products are Q16 in 64 bits, SMLAL on the M4
+****************************************************************************/
+int16_t PIDFixed(PIDFixed_t *pPID, int32_t Error)
+{
+	int64_t Integral = pPID->Integral + (int64_t)pPID->Ki*Error;
+	int64_t Out;
+
+	if (Integral > ((int64_t)pPID->OutMax << 16))
+	{
+		Integral = (int64_t)pPID->OutMax << 16;
+	}
+	else if (Integral < ((int64_t)pPID->OutMin << 16))
+	{
+		Integral = (int64_t)pPID->OutMin << 16;
+	}
+	pPID->Integral = (int32_t)Integral;
+	Out = (int64_t)pPID->Kp*Error + Integral + (int64_t)pPID->Kd*(Error - pPID->LastError);
+	pPID->LastError = Error;
+
+	Out = (Out + 0x8000) >> 16;
+	if (Out > pPID->OutMax)
+	{
+		return pPID->OutMax;
+	}
+	if (Out < pPID->OutMin)
+	{
+		return pPID->OutMin;
+	}
+	return (int16_t)Out;
+}
+
+/****************************************************************************
+ Function
+     BiquadInitFloat
+
+ Parameters
+     BiquadFloat_t *pBiquad
+     float const *pCoeffs : b0, b1, b2, a1, a2
+****************************************************************************/
+void BiquadInitFloat(BiquadFloat_t *pBiquad, float const *pCoeffs)
+{
+	uint8_t k;
+
+	for (k = 0; k < 5; k++)
+	{
+		pBiquad->Coeffs[k] = pCoeffs[k];
+	}
+	pBiquad->X1 = pBiquad->X2 = 0.0f;
+	pBiquad->Y1 = pBiquad->Y2 = 0.0f;
+}
+
+/****************************************************************************
+ Function
+     BiquadFloat
+
+ Description
+     Direct form I, the state in locals for the block so it stays in the
+     FP registers
+****************************************************************************/
+void BiquadFloat(BiquadFloat_t *pBiquad, float const *pIn, float *pOut, uint16_t NumSamples)
+{
+	float const *pC = pBiquad->Coeffs;
+	float X1 = pBiquad->X1, X2 = pBiquad->X2;
+	float Y1 = pBiquad->Y1, Y2 = pBiquad->Y2;
+	float Y;
+	uint16_t n;
+
+	for (n = 0; n < NumSamples; n++)
+	{
+		Y = pC[0]*pIn[n] + pC[1]*X1 + pC[2]*X2 + pC[3]*Y1 + pC[4]*Y2;
+		X2 = X1;
+		X1 = pIn[n];
+		Y2 = Y1;
+		Y1 = Y;
+		pOut[n] = Y;
+	}
+	pBiquad->X1 = X1;
+	pBiquad->X2 = X2;
+	pBiquad->Y1 = Y1;
+	pBiquad->Y2 = Y2;
+}
+
+#ifdef TEST
+/* float against fixed point, on the host or the target.
+   The two PIDs are given the same errors, from a float PID closing the
+   loop on a simulated wheel, and have to agree to a duty count. The float
+   biquad and BiquadQ15 filter the same block and have to agree to a few
+   Q15 steps. Then cycles per call from the DWT counter on the target, or
+   the TSC on an x86 host.
+   On the target it also times PendSV in and out, with an empty handler
+   put in place of the urgent dispatcher for the measurement, with no FP
+   state live, with FP state live and lazy stacking, and with FP state
+   live and the FP registers always stacked, which is what an ISR's
+   latency grows by in each case.
+   gcc -O2 -DTEST -I<stubs> -IHeaders Source/ControlLaws.c Source/DSPKernels.c -lm
+*/
+#include <stdio.h>
+#include "DSPKernels.h"
+#ifdef __ARMCC_VERSION
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "ES_Port.h"
+#include "ES_Urgent.h"
+#include "termio.h"
+#else
+#include <time.h>
+#endif
+
+#define LOOP_TICKS 600
+#define BLOCK 200
+#define BENCH_ROUNDS 100
+#define LATENCY_TRIES 16
+
+static int32_t Errors[LOOP_TICKS];
+static float ErrorsFloat[LOOP_TICKS];
+static int16_t InQ15[BLOCK];
+static int16_t OutQ15[BLOCK];
+static float InFloat[BLOCK];
+static float OutFloat[BLOCK];
+
+// as the DSPKernels test: Q14 for a PostShift of 1
+static int16_t const BiquadCoeffsQ15[5] = { 4096, 8192, 4096, 26000, -12500 };
+
+static volatile float SinkFloat;
+static volatile int32_t SinkFixed;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t Range)
+{
+	Seed = Seed * 1103515245UL + 12345UL;
+	return (Seed >> 8) % Range;
+}
+
+static uint32_t BenchCycles(void)
+{
+#if defined(__ARMCC_VERSION)
+	return HWREG(DWT_CYCCNT);
+#elif defined(__x86_64__) || defined(__i386__)
+	return (uint32_t)__builtin_ia32_rdtsc();
+#else
+	return (uint32_t)clock();
+#endif
+}
+
+static void PrintBench(char const *Name, uint32_t Cycles, uint32_t CallsPerRound)
+{
+	uint32_t Tenths = (uint32_t)((10ULL*Cycles + (uint64_t)BENCH_ROUNDS*CallsPerRound/2)/
+	                             ((uint64_t)BENCH_ROUNDS*CallsPerRound));
+
+	printf("%-24s %5lu.%lu\r\n", Name, (unsigned long)(Tenths/10), (unsigned long)(Tenths % 10));
+}
+
+#define BENCH(Name, Calls, Call) \
+	do { \
+		Start = BenchCycles(); \
+		for (r = 0; r < BENCH_ROUNDS; r++) \
+		{ \
+			Call; \
+		} \
+		PrintBench(Name, BenchCycles() - Start, Calls); \
+	} while (0)
+
+// a wheel: speed in encoder counts a tick follows the duty with a lag.
+// Setpoint steps up, down through zero and back, the float PID closes the
+// loop and its errors, rounded to counts, are kept for both PIDs
+static void MakeErrors(void)
+{
+	PIDFloat_t PID;
+	float Speed = 0.0f;
+	float Duty = 0.0f;
+	int32_t Setpoint;
+	uint16_t n;
+
+	PIDInitFloat(&PID, 1.5f, 0.05f, 0.5f, -100.0f, 100.0f);
+	for (n = 0; n < LOOP_TICKS; n++)
+	{
+		Setpoint = (n < 200) ? 40 : ((n < 400) ? -30 : 10);
+		Errors[n] = Setpoint - (int32_t)(Speed + ((Speed < 0) ? -0.5f : 0.5f)) + (int32_t)Random(3) - 1;
+		ErrorsFloat[n] = (float)Errors[n];
+		Duty = PIDFloat(&PID, ErrorsFloat[n]);
+		Speed += (0.6f*Duty - Speed)/8.0f;
+	}
+}
+
+static uint32_t CheckAgreement(void)
+{
+	PIDFloat_t PIDF;
+	PIDFixed_t PIDQ;
+	BiquadFloat_t BiquadF;
+	BiquadQ15_t BiquadQ;
+	float CoeffsFloat[5];
+	float OutF;
+	int32_t OutQ;
+	int32_t Diff;
+	int32_t MaxPIDDiff = 0;
+	int32_t MaxBiquadDiff = 0;
+	uint32_t Failures = 0;
+	uint16_t n;
+
+	MakeErrors();
+	PIDInitFloat(&PIDF, 1.5f, 0.05f, 0.5f, -100.0f, 100.0f);
+	PIDInitFixed(&PIDQ, PID_GAIN_Q16(1.5f), PID_GAIN_Q16(0.05f), PID_GAIN_Q16(0.5f), -100, 100);
+	for (n = 0; n < LOOP_TICKS; n++)
+	{
+		OutF = PIDFloat(&PIDF, ErrorsFloat[n]);
+		OutQ = PIDFixed(&PIDQ, Errors[n]);
+		Diff = OutQ - (int32_t)(OutF + ((OutF < 0) ? -0.5f : 0.5f));
+		Diff = (Diff < 0) ? -Diff : Diff;
+		if (Diff > MaxPIDDiff)
+		{
+			MaxPIDDiff = Diff;
+		}
+	}
+
+	// the resonance has a gain of 8, keep the output inside full scale
+	// where the float filter has no saturation to match
+	for (n = 0; n < BLOCK; n++)
+	{
+		InQ15[n] = (int16_t)(Random(6000) - 3000);
+		InFloat[n] = InQ15[n];
+	}
+	for (n = 0; n < 5; n++)
+	{
+		CoeffsFloat[n] = BiquadCoeffsQ15[n]/16384.0f;
+	}
+	BiquadInitFloat(&BiquadF, CoeffsFloat);
+	BiquadInitQ15(&BiquadQ, BiquadCoeffsQ15, 1);
+	BiquadFloat(&BiquadF, InFloat, OutFloat, BLOCK);
+	BiquadQ15(&BiquadQ, InQ15, OutQ15, BLOCK);
+	for (n = 0; n < BLOCK; n++)
+	{
+		Diff = OutQ15[n] - (int32_t)(OutFloat[n] + ((OutFloat[n] < 0) ? -0.5f : 0.5f));
+		Diff = (Diff < 0) ? -Diff : Diff;
+		if (Diff > MaxBiquadDiff)
+		{
+			MaxBiquadDiff = Diff;
+		}
+	}
+
+	printf("\r\nfloat against fixed: pid %ld duty counts, biquad %ld Q15 steps at most\r\n",
+	       (long)MaxPIDDiff, (long)MaxBiquadDiff);
+	if (MaxPIDDiff > 1)
+	{
+		Failures++;
+	}
+	// the Q15 rounding goes round the feedback
+	if (MaxBiquadDiff > 4)
+	{
+		Failures++;
+	}
+	return Failures;
+}
+
+static void Benchmark(void)
+{
+	PIDFloat_t PIDF;
+	PIDFixed_t PIDQ;
+	BiquadFloat_t BiquadF;
+	BiquadQ15_t BiquadQ;
+	float CoeffsFloat[5];
+	uint32_t Start;
+	uint16_t r;
+	uint16_t n;
+
+	PIDInitFloat(&PIDF, 1.5f, 0.05f, 0.5f, -100.0f, 100.0f);
+	PIDInitFixed(&PIDQ, PID_GAIN_Q16(1.5f), PID_GAIN_Q16(0.05f), PID_GAIN_Q16(0.5f), -100, 100);
+	for (n = 0; n < 5; n++)
+	{
+		CoeffsFloat[n] = BiquadCoeffsQ15[n]/16384.0f;
+	}
+	BiquadInitFloat(&BiquadF, CoeffsFloat);
+	BiquadInitQ15(&BiquadQ, BiquadCoeffsQ15, 1);
+
+	printf("\r\n%s, cycles a call or sample:\r\n",
+#if defined(__ARMCC_VERSION)
+	       "target");
+#else
+	       "host");
+#endif
+	BENCH("pid float", LOOP_TICKS,
+	      for (n = 0; n < LOOP_TICKS; n++) SinkFloat = PIDFloat(&PIDF, ErrorsFloat[n]));
+	BENCH("pid fixed", LOOP_TICKS,
+	      for (n = 0; n < LOOP_TICKS; n++) SinkFixed = PIDFixed(&PIDQ, Errors[n]));
+	BENCH("biquad float", BLOCK, BiquadFloat(&BiquadF, InFloat, OutFloat, BLOCK));
+	BENCH("biquad q15", BLOCK, BiquadQ15(&BiquadQ, InQ15, OutQ15, BLOCK));
+}
+
+#ifdef __ARMCC_VERSION
+// stands in for the urgent dispatcher, so only the entry and exit are timed
+static void EmptyPendSV(void)
+{
+}
+
+// PendSV in and out, the fewest cycles of a few tries
+static uint32_t PendSVRoundTrip(bool FPLive)
+{
+	register uint32_t Control __asm("control");
+	uint32_t Fewest = 0xffffffff;
+	uint32_t Cycles;
+	uint8_t i;
+
+	for (i = 0; i < LATENCY_TRIES; i++)
+	{
+		if (FPLive)
+		{
+			// any FP instruction makes the FP state live
+			SinkFloat = SinkFloat*1.5f;
+		}
+		else
+		{
+			Control &= ~0x4;   // FPCA
+			__isb(0xf);
+		}
+		Cycles = HWREG(DWT_CYCCNT);
+		HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+		__dsb(0xf);
+		__isb(0xf);
+		Cycles = HWREG(DWT_CYCCNT) - Cycles;
+		if (Cycles < Fewest)
+		{
+			Fewest = Cycles;
+		}
+	}
+	return Fewest;
+}
+
+static void MeasureStacking(void)
+{
+	uint32_t Saved = HWREG(FPCCR);
+	uint32_t NoFP;
+	uint32_t Lazy;
+	uint32_t Always;
+
+	IntRegister(FAULT_PENDSV, EmptyPendSV);
+	HWREG(FPCCR) = FPCCR_ASPEN | FPCCR_LSPEN;
+	NoFP = PendSVRoundTrip(false);
+	Lazy = PendSVRoundTrip(true);
+	HWREG(FPCCR) = FPCCR_ASPEN;
+	Always = PendSVRoundTrip(true);
+	HWREG(FPCCR) = Saved;
+	IntRegister(FAULT_PENDSV, ES_UrgentPendSVHandler);
+
+	printf("\r\nPendSV in and out, cycles: no FP state %lu, lazy stacking +%ld, "
+	       "always stacked +%ld\r\n", (unsigned long)NoFP,
+	       (long)(Lazy - NoFP), (long)(Always - NoFP));
+}
+#endif
+
+int main(void)
+{
+	uint32_t Failures = 0;
+
+#ifdef __ARMCC_VERSION
+	SysCtlClockSet(CPU_CLOCK_SYSCTL);
+	TERMIO_Init();
+	ES_CycleCounterStart();
+#endif
+
+	Failures += CheckAgreement();
+	Benchmark();
+#ifdef __ARMCC_VERSION
+	MeasureStacking();
+#endif
+
+	printf("%lu failures\r\n", (unsigned long)Failures);
+	return Failures;
+}
+#endif
@@ -0,0 +1,180 @@
+/****************************************************************************
+DMA Manager
+	Owns the uDMA controller and its channel control table, and hands the
+	channels out the way TimerManager hands out the wide timers: a module
+	claims a channel with its peripheral assignment at init, a second claim
+	on the same channel is refused and reported as a conflict.
+
+	The transfers handed out are ping-pong reads of a 32 bit peripheral
+	register into a buffer, one item per request: the primary and alternate
+	halves fill in turn, and the owner re-arms each half as it consumes it.
+	A finished half raises the done interrupt on the peripheral's own
+	vector, so the owner's ISR asks IsDMAHalfDone which half it was.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+
+#include "DMAManager.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// the channel number is the low byte of a UDMA_CHn_xxx assignment
+#define CHANNEL_OF(Assignment) ((uint8_t)((Assignment) & 0xff))
+
+/*---------------------------- Module Variables ---------------------------*/
+// primary structures then alternate ones, the controller wants it on a
+// 1 KB boundary
+static tDMAControlTable ControlTable[2*NUM_DMA_CHANNELS] __attribute__((aligned(1024)));
+
+static char const *ChannelOwner[NUM_DMA_CHANNELS];
+static bool ControllerOn = false;
+static uint8_t Conflicts = 0;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     ClaimDMAChannel
+
+ Parameters
+     uint32_t Assignment : UDMA_CHn_xxx from udma.h, the channel and the
+       peripheral on it
+     char const *Owner : name reported in conflicts and allocation dumps
+
+ Returns
+     bool, false if the channel is already owned
+
+ Description
+     Turns the controller on with the first claim, maps the channel to the
+     peripheral and clears its attributes. The channel is left disabled
+****************************************************************************/
+bool ClaimDMAChannel(uint32_t Assignment, char const *Owner)
+{
+	uint8_t Channel = CHANNEL_OF(Assignment);
+
+	if (Channel >= NUM_DMA_CHANNELS)
+	{
+		printf("\r\nDMA claim for invalid channel %d by %s\r\n", Channel, Owner);
+		Conflicts++;
+		return false;
+	}
+	if (ChannelOwner[Channel] != 0)
+	{
+		printf("\r\nDMA conflict: channel %d wanted by %s, owned by %s\r\n",
+		       Channel, Owner, ChannelOwner[Channel]);
+		Conflicts++;
+		return false;
+	}
+	ChannelOwner[Channel] = Owner;
+
+	if (!ControllerOn)
+	{
+		SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+		while (!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA)){}
+		uDMAEnable();
+		uDMAControlBaseSet(ControlTable);
+		ControllerOn = true;
+	}
+
+	uDMAChannelAssign(Assignment);
+	uDMAChannelAttributeDisable(Channel, UDMA_ATTR_ALL);
+	return true;
+}
+
+/****************************************************************************
+ Function
+     ArmDMAFromRegister
+
+ Parameters
+     uint8_t Channel : a claimed channel
+     bool Alternate : which half of the ping-pong to arm
+     uint32_t Register : address of the 32 bit register to read
+     uint32_t *pDest : where the reads go
+     uint16_t Count : reads before the half is done, up to MAX_DMA_TRANSFER
+
+ Description
+     Arms one half for Count single reads of the register. Safe to call for
+     a half that has finished while the other one is running
+****************************************************************************/
+void ArmDMAFromRegister(uint8_t Channel, bool Alternate, uint32_t Register,
+                        uint32_t *pDest, uint16_t Count)
+{
+	uint32_t Select = Channel | (Alternate ? UDMA_ALT_SELECT : UDMA_PRI_SELECT);
+
+	uDMAChannelControlSet(Select, UDMA_SIZE_32 | UDMA_SRC_INC_NONE |
+	                      UDMA_DST_INC_32 | UDMA_ARB_1);
+	uDMAChannelTransferSet(Select, UDMA_MODE_PINGPONG, (void *)Register,
+	                       pDest, Count);
+}
+
+/****************************************************************************
+ Function
+     IsDMAHalfDone
+
+ Returns
+     bool, true once the half has finished and until it is armed again
+****************************************************************************/
+bool IsDMAHalfDone(uint8_t Channel, bool Alternate)
+{
+	return (uDMAChannelModeGet(Channel | (Alternate ? UDMA_ALT_SELECT : UDMA_PRI_SELECT))
+	        == UDMA_MODE_STOP);
+}
+
+/****************************************************************************
+ Function
+     EnableDMAChannel / DisableDMAChannel
+****************************************************************************/
+void EnableDMAChannel(uint8_t Channel)
+{
+	uDMAChannelEnable(Channel);
+}
+
+void DisableDMAChannel(uint8_t Channel)
+{
+	uDMAChannelDisable(Channel);
+}
+
+/****************************************************************************
+ Function
+     GetDMAConflicts
+
+ Returns
+     uint8_t number of refused claims since reset, 0 on a healthy build
+****************************************************************************/
+uint8_t GetDMAConflicts(void)
+{
+	return Conflicts;
+}
+
+/****************************************************************************
+ Function
+     PrintDMAAllocations
+
+ Description
+     Dump who owns which channel
+****************************************************************************/
+void PrintDMAAllocations(void)
+{
+	uint8_t Channel;
+
+	printf("\r\nuDMA channel allocations (%d conflicts)\r\n", Conflicts);
+	for (Channel = 0; Channel < NUM_DMA_CHANNELS; Channel++)
+	{
+		if (ChannelOwner[Channel] != 0)
+		{
+			printf("  %2d %s\r\n", Channel, ChannelOwner[Channel]);
+		}
+	}
+}
@@ -0,0 +1,1151 @@
+/****************************************************************************
+DSP Kernels
+	Fixed point signal processing for the sensors, written around the
+	Cortex-M4 DSP instructions.
+
+	Samples are handled as pairs of Q15 values packed into a 32 bit word,
+	low half first, so the SIMD instructions work on two at a time and a
+	block is read with half the loads. Block lengths are even.
+
+	The filters (FIR, decimating FIR, biquad, moving average) take arrays
+	of samples and keep their history in a caller supplied state, so a
+	stream can be filtered a block at a time. The Q15 ones still read
+	their taps in pairs; the Q31 ones use one SMMULR a tap. Outputs are
+	rounded and saturated, and no kernel divides.
+
+	On the host the intrinsics are replaced by C that gives the same bits,
+	and the test harness checks the kernels against reference C and times
+	them.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <math.h>
+#include "ES_Configure.h"
+#include "ES_Types.h"
+
+#include "DSPKernels.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// ADC results are 12 bit, shifted up 3 they fill a Q15 half without sign
+#define ADC_MASK 0xfff
+#define ADC_TO_Q15_SHIFT 3
+
+#define PI 3.14159265358979323846
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     PackRemoveMean
+
+ Parameters
+     uint32_t const *pSamples : ADC FIFO words, result in the low 12 bits
+     int32_t *pPairs : NumSamples/2 words out
+     uint16_t NumSamples : even
+
+ Returns
+     int32_t the block mean in ADC counts
+
+ Description
+     Takes the mean off the block and scales it to Q15, two samples per
+     PKHBT and SSUB16. The mean is the ambient light, a beacon is what
+     changes around it
+****************************************************************************/
+int32_t PackRemoveMean(uint32_t const *pSamples, int32_t *pPairs, uint16_t NumSamples)
+{
+	uint32_t Sum = 0;
+	uint32_t Mean;
+	uint32_t MeanPair;
+	uint16_t i;
+
+	if (NumSamples == 0)
+	{
+		return 0;
+	}
+	for (i = 0; i < NumSamples; i++)
+	{
+		Sum += pSamples[i] & ADC_MASK;
+	}
+	Mean = (Sum + NumSamples/2)/NumSamples;
+	MeanPair = DSP_PKHBT(Mean << ADC_TO_Q15_SHIFT, Mean << ADC_TO_Q15_SHIFT);
+
+	//Both halves are under 2^15, so the difference cannot wrap
+	for (i = 0; i < NumSamples/2; i++)
+	{
+		pPairs[i] = DSP_SSUB16(DSP_PKHBT((pSamples[2*i] & ADC_MASK) << ADC_TO_Q15_SHIFT,
+		                                 (pSamples[2*i + 1] & ADC_MASK) << ADC_TO_Q15_SHIFT),
+		                       MeanPair);
+	}
+	return Mean;
+}
+
+/****************************************************************************
+ Function
+     PairEnergy
+
+ Returns
+     uint64_t sum of the squares of the samples, two per SMLALD
+****************************************************************************/
+uint64_t PairEnergy(int32_t const *pPairs, uint16_t NumPairs)
+{
+	int64_t Energy = 0;
+	uint16_t i;
+
+	for (i = 0; i < NumPairs; i++)
+	{
+		Energy = DSP_SMLALD(pPairs[i], pPairs[i], Energy);
+	}
+	return (uint64_t)Energy;
+}
+
+/****************************************************************************
+ Function
+     GoertzelCoefficient
+
+ Returns
+     int32_t cos(2 pi FreqHz/SampleHz) in Q31, for GoertzelPower. Uses the
+     floating point library, so compute it once at init
+****************************************************************************/
+int32_t GoertzelCoefficient(uint32_t FreqHz, uint32_t SampleHz)
+{
+	double Cos = cos(2*PI*FreqHz/SampleHz);
+
+	if (Cos >= 1.0)
+	{
+		return 0x7fffffff;
+	}
+	return (int32_t)floor(Cos*2147483648.0 + 0.5);
+}
+
+/****************************************************************************
+ Function
+     GoertzelPower
+
+ Parameters
+     int32_t CosQ31 : from GoertzelCoefficient
+     int32_t const *pPairs : Q15 sample pairs from PackRemoveMean
+     uint16_t NumPairs : half the block length N
+
+ Returns
+     uint64_t |X(f)|^2 of the block, (N*A/2)^2 for a tone of amplitude A
+     at the filter frequency
+
+ Description
+     The Goertzel recursion s = x + 2cos(w)s1 - s2, one SMMULR a sample.
+     The states stay in 32 bits for blocks of a few hundred Q15 samples as
+     long as w is not close to 0, shifting s1 up 2 for 2cos in Q31 leaves
+     them 2^29
+****************************************************************************/
+uint64_t GoertzelPower(int32_t CosQ31, int32_t const *pPairs, uint16_t NumPairs)
+{
+	int32_t S1 = 0;
+	int32_t S2 = 0;
+	int32_t S0;
+	int32_t Pair;
+	uint16_t i;
+
+	for (i = 0; i < NumPairs; i++)
+	{
+		Pair = pPairs[i];
+		S0 = (int16_t)Pair + DSP_SMMULR(CosQ31, S1 << 2) - S2;
+		S2 = S1;
+		S1 = S0;
+		S0 = (Pair >> 16) + DSP_SMMULR(CosQ31, S1 << 2) - S2;
+		S2 = S1;
+		S1 = S0;
+	}
+	return (uint64_t)((int64_t)S1*S1 + (int64_t)S2*S2 -
+	                  (int64_t)DSP_SMMULR(CosQ31, S1 << 2)*S2);
+}
+
+/****************************************************************************
+ Function
+     Sqrt64
+
+ Returns
+     uint32_t floor of the square root, bit by bit
+****************************************************************************/
+uint32_t Sqrt64(uint64_t Value)
+{
+	uint64_t Root = 0;
+	uint64_t Bit = 1ULL << 62;
+
+	while (Bit > Value)
+	{
+		Bit >>= 2;
+	}
+	while (Bit != 0)
+	{
+		if (Value >= Root + Bit)
+		{
+			Value -= Root + Bit;
+			Root = (Root >> 1) + Bit;
+		}
+		else
+		{
+			Root >>= 1;
+		}
+		Bit >>= 2;
+	}
+	return (uint32_t)Root;
+}
+
+/****************************************************************************
+ Function
+     Saturate32
+
+ Returns
+     int32_t Value clamped to 32 bits, for the 64 bit Q31 sums
+****************************************************************************/
+static int32_t Saturate32(int64_t Value)
+{
+	if (Value > 0x7fffffffLL)
+	{
+		return 0x7fffffff;
+	}
+	if (Value < -0x80000000LL)
+	{
+		return (int32_t)0x80000000;
+	}
+	return (int32_t)Value;
+}
+
+/****************************************************************************
+ Function
+     FirOutputQ15
+
+ Parameters
+     int16_t const *pWindow : the NumTaps inputs, oldest first
+
+ Returns
+     int16_t one output, rounded and saturated. Two taps per SMLAD
+****************************************************************************/
+static int16_t FirOutputQ15(int16_t const *pCoeffs, int16_t const *pWindow, uint16_t NumTaps)
+{
+	int32_t Acc = 1 << 14;
+	uint16_t k;
+
+	for (k = 0; k < NumTaps; k += 2)
+	{
+		Acc = DSP_SMLAD(DSP_READ_PAIR(&pCoeffs[k]), DSP_READ_PAIR(&pWindow[k]), Acc);
+	}
+	return (int16_t)DSP_SSAT(Acc >> 15, 16);
+}
+
+/****************************************************************************
+ Function
+     FirInitQ15
+
+ Parameters
+     FirQ15_t *pFir
+     int16_t const *pCoeffs : NumTaps, oldest first
+     uint16_t NumTaps : even, pad with a zero tap
+     int16_t *pState : FIR_STATE_LEN(NumTaps, longest block)
+
+ Returns
+     bool false if NumTaps is odd or the taps could overflow the sum
+****************************************************************************/
+bool FirInitQ15(FirQ15_t *pFir, int16_t const *pCoeffs, uint16_t NumTaps, int16_t *pState)
+{
+	uint32_t Gain = 0;
+	uint16_t k;
+
+	if ((NumTaps == 0) || ((NumTaps & 1) != 0))
+	{
+		return false;
+	}
+	//Under 2.0 in Q15 keeps every sum, rounding included, inside 2^31
+	for (k = 0; k < NumTaps; k++)
+	{
+		Gain += (pCoeffs[k] < 0) ? -pCoeffs[k] : pCoeffs[k];
+	}
+	if (Gain >= 0xffff)
+	{
+		return false;
+	}
+	pFir->pCoeffs = pCoeffs;
+	pFir->pState = pState;
+	pFir->NumTaps = NumTaps;
+	for (k = 0; k < NumTaps - 1; k++)
+	{
+		pState[k] = 0;
+	}
+	return true;
+}
+
+/****************************************************************************
+ Function
+     DecimateQ15
+
+ Parameters
+     FirQ15_t *pFir : anti-alias filter from FirInitQ15
+     uint8_t Factor : one output for each Factor inputs
+     int16_t const *pIn : NumSamples
+     int16_t *pOut : NumSamples/Factor
+     uint16_t NumSamples : a multiple of Factor
+
+ Description
+     The filter is only run for the outputs that are kept
+****************************************************************************/
+void DecimateQ15(FirQ15_t *pFir, uint8_t Factor, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples)
+{
+	int16_t *pState = pFir->pState;
+	uint16_t History = pFir->NumTaps - 1;
+	uint16_t n;
+
+	for (n = 0; n < NumSamples; n++)
+	{
+		pState[History + n] = pIn[n];
+	}
+	for (n = Factor - 1; n < NumSamples; n += Factor)
+	{
+		*pOut++ = FirOutputQ15(pFir->pCoeffs, &pState[n], pFir->NumTaps);
+	}
+	for (n = 0; n < History; n++)
+	{
+		pState[n] = pState[NumSamples + n];
+	}
+}
+
+/****************************************************************************
+ Function
+     FirQ15
+
+ Description
+     An output for every input, DecimateQ15 by 1
+****************************************************************************/
+void FirQ15(FirQ15_t *pFir, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples)
+{
+	DecimateQ15(pFir, 1, pIn, pOut, NumSamples);
+}
+
+/****************************************************************************
+ Function
+     FirInitQ31
+
+ Parameters
+     FirQ31_t *pFir
+     int32_t const *pCoeffs : NumTaps, oldest first
+     uint16_t NumTaps
+     int32_t *pState : FIR_STATE_LEN(NumTaps, longest block)
+****************************************************************************/
+void FirInitQ31(FirQ31_t *pFir, int32_t const *pCoeffs, uint16_t NumTaps, int32_t *pState)
+{
+	uint16_t k;
+
+	pFir->pCoeffs = pCoeffs;
+	pFir->pState = pState;
+	pFir->NumTaps = NumTaps;
+	for (k = 0; k + 1 < NumTaps; k++)
+	{
+		pState[k] = 0;
+	}
+}
+
+/****************************************************************************
+ Function
+     FirQ31
+
+ Description
+     One SMMULR a tap, the Q30 products summed in 64 bits and saturated
+     back to Q31
+****************************************************************************/
+void FirQ31(FirQ31_t *pFir, int32_t const *pIn, int32_t *pOut, uint16_t NumSamples)
+{
+	int32_t *pState = pFir->pState;
+	uint16_t History = pFir->NumTaps - 1;
+	int64_t Acc;
+	uint16_t n;
+	uint16_t k;
+
+	for (n = 0; n < NumSamples; n++)
+	{
+		pState[History + n] = pIn[n];
+	}
+	for (n = 0; n < NumSamples; n++)
+	{
+		Acc = 0;
+		for (k = 0; k < pFir->NumTaps; k++)
+		{
+			Acc += DSP_SMMULR(pFir->pCoeffs[k], pState[n + k]);
+		}
+		pOut[n] = Saturate32(Acc << 1);
+	}
+	for (n = 0; n < History; n++)
+	{
+		pState[n] = pState[NumSamples + n];
+	}
+}
+
+/****************************************************************************
+ Function
+     BiquadInitQ15
+
+ Parameters
+     BiquadQ15_t *pBiquad
+     int16_t const *pCoeffs : b0, b1, b2, a1, a2 in Q15 - PostShift
+     uint8_t PostShift : 0 to 14
+****************************************************************************/
+void BiquadInitQ15(BiquadQ15_t *pBiquad, int16_t const *pCoeffs, uint8_t PostShift)
+{
+	pBiquad->B0 = pCoeffs[0];
+	pBiquad->B12 = DSP_PKHBT(pCoeffs[1], pCoeffs[2]);
+	pBiquad->A12 = DSP_PKHBT(pCoeffs[3], pCoeffs[4]);
+	pBiquad->X12 = 0;
+	pBiquad->Y12 = 0;
+	pBiquad->PostShift = PostShift;
+}
+
+/****************************************************************************
+ Function
+     BiquadQ15
+
+ Description
+     Direct form I, the past inputs and outputs kept in pairs so each
+     pair of taps is one SMLALD. The saturated output is what is fed back
+****************************************************************************/
+void BiquadQ15(BiquadQ15_t *pBiquad, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples)
+{
+	uint8_t Shift = 15 - pBiquad->PostShift;
+	int32_t X12 = pBiquad->X12;
+	int32_t Y12 = pBiquad->Y12;
+	int64_t Acc;
+	int16_t Y;
+	uint16_t n;
+
+	for (n = 0; n < NumSamples; n++)
+	{
+		Acc = (int32_t)pBiquad->B0*pIn[n] + (1 << (Shift - 1));
+		Acc = DSP_SMLALD(pBiquad->B12, X12, Acc);
+		Acc = DSP_SMLALD(pBiquad->A12, Y12, Acc);
+		Y = (int16_t)DSP_SSAT((int32_t)(Acc >> Shift), 16);
+		X12 = DSP_PKHBT(pIn[n], X12);
+		Y12 = DSP_PKHBT(Y, Y12);
+		pOut[n] = Y;
+	}
+	pBiquad->X12 = X12;
+	pBiquad->Y12 = Y12;
+}
+
+/****************************************************************************
+ Function
+     BiquadInitQ31
+
+ Parameters
+     BiquadQ31_t *pBiquad
+     int32_t const *pCoeffs : b0, b1, b2, a1, a2 in Q31 - PostShift
+     uint8_t PostShift
+****************************************************************************/
+void BiquadInitQ31(BiquadQ31_t *pBiquad, int32_t const *pCoeffs, uint8_t PostShift)
+{
+	uint8_t k;
+
+	for (k = 0; k < 5; k++)
+	{
+		pBiquad->Coeffs[k] = pCoeffs[k];
+	}
+	pBiquad->X1 = pBiquad->X2 = 0;
+	pBiquad->Y1 = pBiquad->Y2 = 0;
+	pBiquad->PostShift = PostShift;
+}
+
+/****************************************************************************
+ Function
+     BiquadQ31
+
+ Description
+     Direct form I, one SMMULR a tap as in FirQ31
+****************************************************************************/
+void BiquadQ31(BiquadQ31_t *pBiquad, int32_t const *pIn, int32_t *pOut, uint16_t NumSamples)
+{
+	int32_t const *pC = pBiquad->Coeffs;
+	int64_t Acc;
+	int32_t Y;
+	uint16_t n;
+
+	for (n = 0; n < NumSamples; n++)
+	{
+		Acc = (int64_t)DSP_SMMULR(pC[0], pIn[n]) + DSP_SMMULR(pC[1], pBiquad->X1) +
+		      DSP_SMMULR(pC[2], pBiquad->X2) + DSP_SMMULR(pC[3], pBiquad->Y1) +
+		      DSP_SMMULR(pC[4], pBiquad->Y2);
+		Y = Saturate32(Acc << (1 + pBiquad->PostShift));
+		pBiquad->X2 = pBiquad->X1;
+		pBiquad->X1 = pIn[n];
+		pBiquad->Y2 = pBiquad->Y1;
+		pBiquad->Y1 = Y;
+		pOut[n] = Y;
+	}
+}
+
+/****************************************************************************
+ Function
+     MovingAverageInitQ15
+
+ Parameters
+     MovingAverageQ15_t *pAverage
+     int16_t *pWindow : 2^Shift samples
+     uint8_t Shift : 0 to 15
+****************************************************************************/
+void MovingAverageInitQ15(MovingAverageQ15_t *pAverage, int16_t *pWindow, uint8_t Shift)
+{
+	uint16_t i;
+
+	pAverage->pWindow = pWindow;
+	pAverage->Sum = 0;
+	pAverage->Index = 0;
+	pAverage->Shift = Shift;
+	for (i = 0; i < (1U << Shift); i++)
+	{
+		pWindow[i] = 0;
+	}
+}
+
+/****************************************************************************
+ Function
+     MovingAverageQ15
+
+ Description
+     The sum is kept exactly, the sample leaving the window taken off as
+     the new one goes on, and rounded by a shift instead of a divide
+****************************************************************************/
+void MovingAverageQ15(MovingAverageQ15_t *pAverage, int16_t const *pIn, int16_t *pOut, uint16_t NumSamples)
+{
+	uint16_t Mask = (1U << pAverage->Shift) - 1;
+	int32_t Round = (1 << pAverage->Shift) >> 1;
+	int32_t Sum = pAverage->Sum;
+	uint16_t Index = pAverage->Index;
+	uint16_t n;
+
+	for (n = 0; n < NumSamples; n++)
+	{
+		Sum += pIn[n] - pAverage->pWindow[Index];
+		pAverage->pWindow[Index] = pIn[n];
+		Index = (Index + 1) & Mask;
+		pOut[n] = (int16_t)((Sum + Round) >> pAverage->Shift);
+	}
+	pAverage->Sum = Sum;
+	pAverage->Index = Index;
+}
+
+/****************************************************************************
+ Function
+     DotQ15
+
+ Returns
+     int64_t sum of the products of the Q15 pairs, Q30, two per SMLALD
+****************************************************************************/
+int64_t DotQ15(int32_t const *pA, int32_t const *pB, uint16_t NumPairs)
+{
+	int64_t Acc = 0;
+	uint16_t i;
+
+	for (i = 0; i < NumPairs; i++)
+	{
+		Acc = DSP_SMLALD(pA[i], pB[i], Acc);
+	}
+	return Acc;
+}
+
+/****************************************************************************
+ Function
+     DotQ31
+
+ Returns
+     int64_t sum of the products, each rounded to Q30 by SMMULR
+****************************************************************************/
+int64_t DotQ31(int32_t const *pA, int32_t const *pB, uint16_t Num)
+{
+	int64_t Acc = 0;
+	uint16_t i;
+
+	for (i = 0; i < Num; i++)
+	{
+		Acc += DSP_SMMULR(pA[i], pB[i]);
+	}
+	return Acc;
+}
+
+/****************************************************************************
+ Function
+     AddQ15
+
+ Description
+     Saturating sum of two blocks of Q15 pairs, two per QADD16
+****************************************************************************/
+void AddQ15(int32_t const *pA, int32_t const *pB, int32_t *pOut, uint16_t NumPairs)
+{
+	uint16_t i;
+
+	for (i = 0; i < NumPairs; i++)
+	{
+		pOut[i] = DSP_QADD16(pA[i], pB[i]);
+	}
+}
+
+#if !(defined(__ARMCC_VERSION) && defined(__TARGET_FEATURE_DSPMUL))
+/****************************************************************************
+ Functions
+     DSPSsub16, DSPQadd16, DSPSmlad, DSPSmlald, DSPSsat, DSPReadPair
+
+ Description
+     What SSUB16, QADD16, SMLAD, SMLALD, SSAT and an unaligned LDR do, for
+     the host. SSUB16 wraps each half, QADD16 saturates it, SMLAD wraps
+     the 32 bit sum (and would set Q)
+****************************************************************************/
+int32_t DSPSsub16(int32_t a, int32_t b)
+{
+	uint16_t Lo = (uint16_t)((int16_t)a - (int16_t)b);
+	uint16_t Hi = (uint16_t)((int16_t)(a >> 16) - (int16_t)(b >> 16));
+
+	return (int32_t)DSP_PKHBT(Lo, Hi);
+}
+
+int32_t DSPQadd16(int32_t a, int32_t b)
+{
+	int32_t Lo = DSPSsat((int16_t)a + (int16_t)b, 16);
+	int32_t Hi = DSPSsat((int16_t)(a >> 16) + (int16_t)(b >> 16), 16);
+
+	return (int32_t)DSP_PKHBT(Lo, Hi);
+}
+
+int32_t DSPSmlad(int32_t a, int32_t b, int32_t Acc)
+{
+	return (int32_t)((uint32_t)Acc + (uint32_t)((int32_t)(int16_t)a*(int16_t)b) +
+	                 (uint32_t)((int32_t)(int16_t)(a >> 16)*(int16_t)(b >> 16)));
+}
+
+int64_t DSPSmlald(int32_t a, int32_t b, int64_t Acc)
+{
+	return Acc + (int32_t)(int16_t)a*(int16_t)b +
+	       (int32_t)(int16_t)(a >> 16)*(int16_t)(b >> 16);
+}
+
+int32_t DSPSsat(int32_t x, uint8_t Bits)
+{
+	int32_t Max = (1L << (Bits - 1)) - 1;
+
+	if (x > Max)
+	{
+		return Max;
+	}
+	if (x < -Max - 1)
+	{
+		return -Max - 1;
+	}
+	return x;
+}
+
+int32_t DSPReadPair(int16_t const *p)
+{
+	return (int32_t)DSP_PKHBT(p[0], p[1]);
+}
+#endif
+
+#ifdef TEST
+/* check of the kernels, and a benchmark, on the host or the target. The
+   Goertzel blocks are what the IR demodulator sees: a 10 kHz ADC stream,
+   200 samples, tones on a DC level with a little noise, checked against
+   double precision. The filter kernels are checked bit for bit against
+   plain 64 bit C over several blocks of random and full scale samples,
+   so on the target the intrinsics are checked against C and on the host
+   the stand-ins are. The benchmark gives cycles a sample for each kernel,
+   from the DWT cycle counter on the target and the time stamp counter on
+   an x86 host.
+   gcc -O2 -DTEST -I<stubs> -IHeaders Source/DSPKernels.c -lm
+*/
+#include <stdio.h>
+#ifdef __ARMCC_VERSION
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "ES_Port.h"
+#include "termio.h"
+#else
+#include <time.h>
+#endif
+
+#define SAMPLE_HZ 10000
+#define BLOCK 200
+#define BENCH_ROUNDS 100
+#define TAPS 16
+#define FILTER_BLOCK 64
+#define FILTER_BLOCKS 4
+#define STREAM (FILTER_BLOCK*FILTER_BLOCKS)
+#define DECIMATE_BY 4
+#define AVERAGE_SHIFT 4
+
+typedef struct {
+	uint32_t ToneHz;
+	uint32_t Amplitude;   // ADC counts
+	uint32_t FilterHz;
+} KernelCase_t;
+
+static KernelCase_t const Cases[] = {
+	{ 1950, 1000, 1950 },
+	{  909,  300,  909 },
+	{ 1250, 1800, 1250 },
+	{ 3333,  700, 3333 },
+	{ 1950, 1000, 1250 },
+	{  909, 1000, 3333 },
+	{ 2000,   40, 2000 },
+};
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t Range)
+{
+	Seed = Seed * 1103515245UL + 12345UL;
+	return (Seed >> 8) % Range;
+}
+
+static void MakeBlock(uint32_t *pSamples, uint32_t ToneHz, uint32_t Amplitude)
+{
+	uint16_t i;
+	double Phase = Random(1000)*2*PI/1000;
+	int32_t Sample;
+
+	for (i = 0; i < BLOCK; i++)
+	{
+		Sample = (int32_t)floor(2048 + Amplitude*sin(2*PI*ToneHz*i/SAMPLE_HZ + Phase) +
+		                        (int32_t)Random(9) - 4 + 0.5);
+		pSamples[i] = (Sample < 0) ? 0 : ((Sample > ADC_MASK) ? ADC_MASK : Sample);
+	}
+}
+
+// amplitude in ADC counts the double precision way
+static double ReferenceAmplitude(uint32_t const *pSamples, uint32_t FilterHz)
+{
+	double Mean = 0;
+	double Coef = 2*cos(2*PI*FilterHz/SAMPLE_HZ);
+	double S0, S1 = 0, S2 = 0;
+	uint16_t i;
+
+	for (i = 0; i < BLOCK; i++)
+	{
+		Mean += pSamples[i];
+	}
+	Mean /= BLOCK;
+	for (i = 0; i < BLOCK; i++)
+	{
+		S0 = (pSamples[i] - Mean) + Coef*S1 - S2;
+		S2 = S1;
+		S1 = S0;
+	}
+	return 2*sqrt(S1*S1 + S2*S2 - Coef*S1*S2)/BLOCK;
+}
+
+static int16_t StreamQ15[STREAM];
+static int32_t StreamQ31[STREAM];
+static int16_t OutQ15[STREAM];
+static int32_t OutQ31[STREAM];
+static int16_t FirCoeffsQ15[TAPS];
+static int32_t FirCoeffsQ31[TAPS];
+static int16_t FirStateQ15[FIR_STATE_LEN(TAPS, STREAM)];
+static int32_t FirStateQ31[FIR_STATE_LEN(TAPS, STREAM)];
+static int16_t AverageWindow[1 << AVERAGE_SHIFT];
+static int32_t PairsA[BLOCK/2];
+static int32_t PairsB[BLOCK/2];
+static int32_t PairsOut[BLOCK/2];
+// a low pass, 1.5 gain at DC, and a resonance at about 0.6 radians a sample
+// to give the feedback some work, coefficients in Q14 for a PostShift of 1
+static int16_t const BiquadCoeffsQ15[5] = { 4096, 8192, 4096, 26000, -12500 };
+static int32_t const BiquadCoeffsQ31[5] = { 268435456, 536870912, 268435456,
+                                            1703936000, -819200000 };
+
+// taps between 1.0 and 2.0 in gain, oldest first. Random samples, with
+// full scale stretches following the signs of the taps so that the FIR
+// outputs saturate, and every Q15 value in the top half of the Q31 ones
+static void MakeStream(void)
+{
+	uint16_t n;
+
+	for (n = 0; n < TAPS; n++)
+	{
+		FirCoeffsQ15[n] = (int16_t)(2000 + Random(2000));
+		if (Random(2))
+		{
+			FirCoeffsQ15[n] = -FirCoeffsQ15[n];
+		}
+		FirCoeffsQ31[n] = ((int32_t)FirCoeffsQ15[n] << 16) | Random(65536);
+	}
+	for (n = 0; n < STREAM; n++)
+	{
+		if ((n / 32) % 4 == 3)
+		{
+			StreamQ15[n] = (FirCoeffsQ15[n % TAPS] < 0) ? -32768 : 32767;
+		}
+		else
+		{
+			StreamQ15[n] = (int16_t)(Random(65536) - 32768);
+		}
+		StreamQ31[n] = ((int32_t)StreamQ15[n] << 16) | Random(65536);
+	}
+}
+
+static int32_t Saturate(int64_t Value, uint8_t Bits)
+{
+	int64_t Max = (1LL << (Bits - 1)) - 1;
+
+	return (int32_t)((Value > Max) ? Max : ((Value < -Max - 1) ? -Max - 1 : Value));
+}
+
+// the input n samples back, zero before the stream started
+static int64_t Past(uint16_t n, uint16_t Back, bool Q31)
+{
+	if (Back > n)
+	{
+		return 0;
+	}
+	return Q31 ? StreamQ31[n - Back] : StreamQ15[n - Back];
+}
+
+// Q31 product rounded to Q30, as SMMULR
+static int64_t RoundedQ30(int64_t a, int64_t b)
+{
+	return (a*b + 2147483648LL) >> 32;
+}
+
+static int32_t ReferenceFirQ15(uint16_t n)
+{
+	int64_t Acc = 1 << 14;
+	uint16_t k;
+
+	for (k = 0; k < TAPS; k++)
+	{
+		Acc += FirCoeffsQ15[TAPS - 1 - k]*Past(n, k, false);
+	}
+	return Saturate(Acc >> 15, 16);
+}
+
+static int32_t ReferenceFirQ31(uint16_t n)
+{
+	int64_t Acc = 0;
+	uint16_t k;
+
+	for (k = 0; k < TAPS; k++)
+	{
+		Acc += RoundedQ30(FirCoeffsQ31[TAPS - 1 - k], Past(n, k, true));
+	}
+	return Saturate(2*Acc, 32);
+}
+
+// the filters are run a block at a time, the references over the stream
+static uint32_t CheckBitExact(void)
+{
+	FirQ15_t FirQ15Filter;
+	FirQ31_t FirQ31Filter;
+	BiquadQ15_t BiquadQ15Filter;
+	BiquadQ31_t BiquadQ31Filter;
+	MovingAverageQ15_t Average;
+	int16_t BadCoeffs[TAPS];
+	int64_t Acc;
+	int64_t Y1 = 0, Y2 = 0;
+	int64_t Sum;
+	uint32_t Failures = 0;
+	uint32_t Mismatches[8] = { 0 };
+	uint16_t Block;
+	uint16_t n;
+	uint16_t k;
+
+	MakeStream();
+
+	// odd taps, and taps that could overflow SMLAD, are refused
+	for (k = 0; k < TAPS; k++)
+	{
+		BadCoeffs[k] = 4096;
+	}
+	if (FirInitQ15(&FirQ15Filter, BadCoeffs, TAPS - 1, FirStateQ15) ||
+	    FirInitQ15(&FirQ15Filter, BadCoeffs, TAPS, FirStateQ15))
+	{
+		printf("FirInitQ15 took bad taps\r\n");
+		Failures++;
+	}
+
+	FirInitQ15(&FirQ15Filter, FirCoeffsQ15, TAPS, FirStateQ15);
+	for (Block = 0; Block < FILTER_BLOCKS; Block++)
+	{
+		FirQ15(&FirQ15Filter, &StreamQ15[Block*FILTER_BLOCK], &OutQ15[Block*FILTER_BLOCK], FILTER_BLOCK);
+	}
+	for (n = 0; n < STREAM; n++)
+	{
+		Mismatches[0] += (OutQ15[n] != ReferenceFirQ15(n));
+	}
+
+	FirInitQ15(&FirQ15Filter, FirCoeffsQ15, TAPS, FirStateQ15);
+	for (Block = 0; Block < FILTER_BLOCKS; Block++)
+	{
+		DecimateQ15(&FirQ15Filter, DECIMATE_BY, &StreamQ15[Block*FILTER_BLOCK],
+		            &OutQ15[Block*FILTER_BLOCK/DECIMATE_BY], FILTER_BLOCK);
+	}
+	for (n = 0; n < STREAM/DECIMATE_BY; n++)
+	{
+		Mismatches[1] += (OutQ15[n] != ReferenceFirQ15(n*DECIMATE_BY + DECIMATE_BY - 1));
+	}
+
+	FirInitQ31(&FirQ31Filter, FirCoeffsQ31, TAPS, FirStateQ31);
+	for (Block = 0; Block < FILTER_BLOCKS; Block++)
+	{
+		FirQ31(&FirQ31Filter, &StreamQ31[Block*FILTER_BLOCK], &OutQ31[Block*FILTER_BLOCK], FILTER_BLOCK);
+	}
+	for (n = 0; n < STREAM; n++)
+	{
+		Mismatches[2] += (OutQ31[n] != ReferenceFirQ31(n));
+	}
+
+	BiquadInitQ15(&BiquadQ15Filter, BiquadCoeffsQ15, 1);
+	for (Block = 0; Block < FILTER_BLOCKS; Block++)
+	{
+		BiquadQ15(&BiquadQ15Filter, &StreamQ15[Block*FILTER_BLOCK], &OutQ15[Block*FILTER_BLOCK], FILTER_BLOCK);
+	}
+	for (n = 0; n < STREAM; n++)
+	{
+		Acc = (1 << 13) + BiquadCoeffsQ15[0]*Past(n, 0, false) +
+		      BiquadCoeffsQ15[1]*Past(n, 1, false) + BiquadCoeffsQ15[2]*Past(n, 2, false) +
+		      BiquadCoeffsQ15[3]*Y1 + BiquadCoeffsQ15[4]*Y2;
+		Y2 = Y1;
+		Y1 = Saturate(Acc >> 14, 16);
+		Mismatches[3] += (OutQ15[n] != Y1);
+	}
+
+	BiquadInitQ31(&BiquadQ31Filter, BiquadCoeffsQ31, 1);
+	for (Block = 0; Block < FILTER_BLOCKS; Block++)
+	{
+		BiquadQ31(&BiquadQ31Filter, &StreamQ31[Block*FILTER_BLOCK], &OutQ31[Block*FILTER_BLOCK], FILTER_BLOCK);
+	}
+	Y1 = Y2 = 0;
+	for (n = 0; n < STREAM; n++)
+	{
+		Acc = RoundedQ30(BiquadCoeffsQ31[0], Past(n, 0, true)) +
+		      RoundedQ30(BiquadCoeffsQ31[1], Past(n, 1, true)) +
+		      RoundedQ30(BiquadCoeffsQ31[2], Past(n, 2, true)) +
+		      RoundedQ30(BiquadCoeffsQ31[3], Y1) + RoundedQ30(BiquadCoeffsQ31[4], Y2);
+		Y2 = Y1;
+		Y1 = Saturate(Acc*4, 32);
+		Mismatches[4] += (OutQ31[n] != Y1);
+	}
+
+	MovingAverageInitQ15(&Average, AverageWindow, AVERAGE_SHIFT);
+	for (Block = 0; Block < FILTER_BLOCKS; Block++)
+	{
+		MovingAverageQ15(&Average, &StreamQ15[Block*FILTER_BLOCK], &OutQ15[Block*FILTER_BLOCK], FILTER_BLOCK);
+	}
+	for (n = 0; n < STREAM; n++)
+	{
+		Sum = 1 << (AVERAGE_SHIFT - 1);
+		for (k = 0; k < (1 << AVERAGE_SHIFT); k++)
+		{
+			Sum += Past(n, k, false);
+		}
+		Mismatches[5] += (OutQ15[n] != (Sum >> AVERAGE_SHIFT));
+	}
+
+	// the pairs are the stream two samples a word
+	for (n = 0; n < BLOCK/2; n++)
+	{
+		PairsA[n] = DSP_PKHBT(StreamQ15[2*n], StreamQ15[2*n + 1]);
+		PairsB[n] = DSP_PKHBT(StreamQ15[STREAM - 1 - 2*n], StreamQ15[STREAM - 2 - 2*n]);
+	}
+	Acc = 0;
+	for (n = 0; n < BLOCK/2; n++)
+	{
+		Acc += (int64_t)(int16_t)PairsA[n]*(int16_t)PairsB[n] +
+		       (int64_t)(PairsA[n] >> 16)*(PairsB[n] >> 16);
+	}
+	Mismatches[6] += (DotQ15(PairsA, PairsB, BLOCK/2) != Acc);
+	Acc = 0;
+	for (n = 0; n < STREAM/2; n++)
+	{
+		Acc += RoundedQ30(StreamQ31[n], StreamQ31[STREAM - 1 - n]);
+	}
+	Mismatches[6] += (DotQ31(StreamQ31, &StreamQ31[STREAM/2], STREAM/2) !=
+	                  DotQ31(&StreamQ31[STREAM/2], StreamQ31, STREAM/2));
+	Mismatches[6] += (DotQ31(StreamQ31, OutQ31, 0) != 0);
+	for (n = 0; n < STREAM/2; n++)
+	{
+		OutQ31[n] = StreamQ31[STREAM - 1 - n];
+	}
+	Mismatches[6] += (DotQ31(StreamQ31, OutQ31, STREAM/2) != Acc);
+
+	AddQ15(PairsA, PairsB, PairsOut, BLOCK/2);
+	for (n = 0; n < BLOCK/2; n++)
+	{
+		Mismatches[7] += ((int16_t)PairsOut[n] !=
+		                  Saturate((int16_t)PairsA[n] + (int16_t)PairsB[n], 16)) ||
+		                 ((PairsOut[n] >> 16) !=
+		                  Saturate((PairsA[n] >> 16) + (PairsB[n] >> 16), 16));
+	}
+
+	printf("\r\nbit exact: fir q15 %lu, decimate %lu, fir q31 %lu, biquad q15 %lu, "
+	       "biquad q31 %lu, average %lu, dot %lu, add %lu mismatches\r\n",
+	       (unsigned long)Mismatches[0], (unsigned long)Mismatches[1],
+	       (unsigned long)Mismatches[2], (unsigned long)Mismatches[3],
+	       (unsigned long)Mismatches[4], (unsigned long)Mismatches[5],
+	       (unsigned long)Mismatches[6], (unsigned long)Mismatches[7]);
+	for (k = 0; k < 8; k++)
+	{
+		Failures += (Mismatches[k] != 0);
+	}
+	return Failures;
+}
+
+static uint32_t BenchCycles(void)
+{
+#if defined(__ARMCC_VERSION)
+	return HWREG(DWT_CYCCNT);
+#elif defined(__x86_64__) || defined(__i386__)
+	return (uint32_t)__builtin_ia32_rdtsc();
+#else
+	return (uint32_t)clock();
+#endif
+}
+
+static void PrintBench(char const *Name, uint32_t Cycles, uint32_t SamplesPerRound)
+{
+	uint32_t Tenths = (uint32_t)((10ULL*Cycles + (uint64_t)BENCH_ROUNDS*SamplesPerRound/2)/
+	                             ((uint64_t)BENCH_ROUNDS*SamplesPerRound));
+
+	printf("%-24s %5lu.%lu\r\n", Name, (unsigned long)(Tenths/10), (unsigned long)(Tenths % 10));
+}
+
+// each kernel run BENCH_ROUNDS times over a block of the stream
+#define BENCH(Name, Samples, Call) \
+	do { \
+		Start = BenchCycles(); \
+		for (r = 0; r < BENCH_ROUNDS; r++) \
+		{ \
+			Call; \
+		} \
+		PrintBench(Name, BenchCycles() - Start, Samples); \
+	} while (0)
+
+static volatile int64_t Sink;
+
+static void Benchmark(void)
+{
+	uint32_t Samples[BLOCK];
+	int32_t Pairs[BLOCK/2];
+	FirQ15_t FirQ15Filter;
+	FirQ31_t FirQ31Filter;
+	BiquadQ15_t BiquadQ15Filter;
+	BiquadQ31_t BiquadQ31Filter;
+	MovingAverageQ15_t Average;
+	int32_t Coef;
+	uint32_t Start;
+	uint16_t r;
+
+	MakeBlock(Samples, 1950, 1000);
+	Coef = GoertzelCoefficient(1950, SAMPLE_HZ);
+	FirInitQ15(&FirQ15Filter, FirCoeffsQ15, TAPS, FirStateQ15);
+	FirInitQ31(&FirQ31Filter, FirCoeffsQ31, TAPS, FirStateQ31);
+	BiquadInitQ15(&BiquadQ15Filter, BiquadCoeffsQ15, 1);
+	BiquadInitQ31(&BiquadQ31Filter, BiquadCoeffsQ31, 1);
+	MovingAverageInitQ15(&Average, AverageWindow, AVERAGE_SHIFT);
+
+	printf("\r\n%s, cycles a sample:\r\n",
+#if defined(__ARMCC_VERSION)
+	       "target");
+#else
+	       "host");
+#endif
+	BENCH("pack, remove mean", BLOCK, PackRemoveMean(Samples, Pairs, BLOCK));
+	BENCH("goertzel", BLOCK, Sink += GoertzelPower(Coef + r, Pairs, BLOCK/2));
+	BENCH("energy", BLOCK, Sink += PairEnergy(Pairs, BLOCK/2));
+	BENCH("fir q15, 16 taps", BLOCK, FirQ15(&FirQ15Filter, StreamQ15, OutQ15, BLOCK));
+	BENCH("decimate q15 by 4", BLOCK, DecimateQ15(&FirQ15Filter, DECIMATE_BY, StreamQ15, OutQ15, BLOCK));
+	BENCH("fir q31, 16 taps", BLOCK, FirQ31(&FirQ31Filter, StreamQ31, OutQ31, BLOCK));
+	BENCH("biquad q15", BLOCK, BiquadQ15(&BiquadQ15Filter, StreamQ15, OutQ15, BLOCK));
+	BENCH("biquad q31", BLOCK, BiquadQ31(&BiquadQ31Filter, StreamQ31, OutQ31, BLOCK));
+	BENCH("moving average of 16", BLOCK, MovingAverageQ15(&Average, StreamQ15, OutQ15, BLOCK));
+	BENCH("dot q15", BLOCK, Sink += DotQ15(Pairs, PairsA, BLOCK/2));
+	BENCH("dot q31", BLOCK, Sink += DotQ31(StreamQ31, OutQ31, BLOCK));
+	BENCH("add q15", BLOCK, AddQ15(Pairs, PairsA, PairsOut, BLOCK/2));
+}
+
+int main(void)
+{
+	uint32_t Samples[BLOCK];
+	int32_t Pairs[BLOCK/2];
+	int32_t Coef;
+	uint64_t Energy;
+	int64_t Expected;
+	double Reference;
+	double Fixed;
+	uint32_t Failures = 0;
+	uint32_t i;
+	uint16_t j;
+
+#ifdef __ARMCC_VERSION
+	SysCtlClockSet(CPU_CLOCK_SYSCTL);
+	TERMIO_Init();
+	ES_CycleCounterStart();
+#endif
+
+	// the intrinsics or their stand-ins, at the edges of their ranges
+	if ((DSP_SSUB16(0x00018000, 0x00010001) != 0x00007fff) ||
+	    (DSP_SSUB16(0x80000000, 0x00010000) != 0x7fff0000) ||
+	    (DSP_QADD16(0x7fff8000, 0x00018000) != 0x7fff8000) ||
+	    (DSP_SMLAD(0x7fff7fff, 0x7fff7fff, 0x7fffffff) != (int32_t)0xfffe0001) ||
+	    (DSP_SMLALD(0x7fff8000, 0x7fff8000, 1) != 1 + 32767LL*32767 + 32768LL*32768) ||
+	    (DSP_SSAT(40000, 16) != 32767) || (DSP_SSAT(-40000, 16) != -32768))
+	{
+		printf("intrinsics are wrong\r\n");
+		Failures++;
+	}
+
+	printf("\r\ntone Hz  amp  filter Hz  reference    fixed\r\n");
+	for (i = 0; i < sizeof(Cases)/sizeof(Cases[0]); i++)
+	{
+		MakeBlock(Samples, Cases[i].ToneHz, Cases[i].Amplitude);
+		PackRemoveMean(Samples, Pairs, BLOCK);
+		Coef = GoertzelCoefficient(Cases[i].FilterHz, SAMPLE_HZ);
+		Fixed = 2.0*Sqrt64(GoertzelPower(Coef, Pairs, BLOCK/2))/BLOCK/(1 << ADC_TO_Q15_SHIFT);
+		Reference = ReferenceAmplitude(Samples, Cases[i].FilterHz);
+		printf("%7u %4u %10u %10.2f %8.2f", Cases[i].ToneHz, Cases[i].Amplitude,
+		       Cases[i].FilterHz, Reference, Fixed);
+		// the mean is rounded to a count, and the root to a Q15 step
+		if (fabs(Fixed - Reference) > 0.5 + Reference/1000)
+		{
+			printf("  FAILED");
+			Failures++;
+		}
+		printf("\r\n");
+
+		// the energy is exact
+		Energy = PairEnergy(Pairs, BLOCK/2);
+		Expected = 0;
+		for (j = 0; j < BLOCK/2; j++)
+		{
+			Expected += (int64_t)(int16_t)Pairs[j]*(int16_t)Pairs[j] +
+			            (int64_t)(Pairs[j] >> 16)*(Pairs[j] >> 16);
+		}
+		if (Energy != (uint64_t)Expected)
+		{
+			printf("energy %llu, expected %lld\r\n", (unsigned long long)Energy, (long long)Expected);
+			Failures++;
+		}
+	}
+
+	for (i = 0; i < 1000; i++)
+	{
+		uint64_t Value = ((uint64_t)Random(1 << 24) << 24) | Random(1 << 24);
+		uint64_t Root = Sqrt64(Value);
+		if ((Root*Root > Value) || ((Root + 1)*(Root + 1) <= Value))
+		{
+			printf("Sqrt64(%llu) = %llu\r\n", (unsigned long long)Value, (unsigned long long)Root);
+			Failures++;
+			break;
+		}
+	}
+
+	Failures += CheckBitExact();
+	Benchmark();
+
+	printf("%u failures\r\n", Failures);
+	return Failures;
+}
+#endif
@@ -0,0 +1,267 @@
+/****************************************************************************
+ Module
+     ES_Bands.c
+ Description
+     Preemptive priority bands for the ES scheduler. Bands 1 and 2 are the
+     GPIO Port G and Port H interrupts (31 and 32), which have no pins on
+     the 64 pin TM4C123GH6PM, triggered from software through NVIC_SW_TRIG
+     whenever a service in the band is posted to
+ Notes
+     The band priorities (ES_BAND_n_PRIORITY, applied with the rest of the
+     table in InterruptPriorities.c) sit below every hardware ISR and above
+     nothing but ES_Run. A band handler runs its services until all their queues are empty, so
+     a second trigger while it runs is served by the same call, or by the
+     pended interrupt right after it.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:00 t16      priorities moved to the interrupt priority table
+ 10/19/26 22:00 t16      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Bands.h"
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+#include "BITDEFS.H"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define BAND_1_INT 31
+#define BAND_2_INT 32
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+// interrupt number of each band, band 0 has none
+static uint8_t const BandInt[ES_NUM_BANDS] = { 0, BAND_1_INT, BAND_2_INT };
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_BandsInit
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   enables the band interrupts, whose priorities are already set by
+   ApplyInterruptPriorities. Called from
+   ES_Initialize after the service inits, so a post made by an init is
+   run by its band as soon as interrupts are enabled
+****************************************************************************/
+void ES_BandsInit( void )
+{
+  HWREG(NVIC_EN0) = BIT31HI;
+  HWREG(NVIC_EN1) = BIT0HI;
+}
+
+/****************************************************************************
+ Function
+   ES_BandTrigger
+ Parameters
+   uint8_t Band : band 1 or above
+ Returns
+   nothing
+ Description
+   pends the band's interrupt. Safe from any context
+****************************************************************************/
+void ES_BandTrigger( uint8_t Band )
+{
+  if ( (Band != 0) && (Band < ES_NUM_BANDS) )
+    HWREG(NVIC_SW_TRIG) = BandInt[Band];
+}
+
+/****************************************************************************
+ Function
+   ES_Band1Handler, ES_Band2Handler
+ Description
+   the GPIO Port G and Port H vectors
+****************************************************************************/
+void ES_Band1Handler( void )
+{
+  ES_RunBand( 1 );
+}
+
+void ES_Band2Handler( void )
+{
+  ES_RunBand( 2 );
+}
+
+/* host simulation of the scheduler, cooperative against banded. Each
+   service gets events at its period plus a random jitter and takes its
+   run time to handle one, the numbers standing in for the services in
+   ES_Configure.h (ActionService's long runs are mostly printf over the
+   UART). Time is in 1 uS steps and ISR time is ignored. Reported per
+   band: the worst wait from post to run start and from post to the end
+   of the run. Cooperative, every service is in band 0 and the numbers
+   are grouped by the band the service is configured for.
+   gcc -DTEST -I<stubs> -IHeaders Source/ES_Bands.c
+*/
+#ifdef TEST
+#include <stdio.h>
+
+#define SIM_US 10000000UL
+#define SIM_QUEUE 8
+
+typedef struct {
+  uint32_t RunUS;
+  uint32_t PeriodUS;
+  uint32_t JitterUS;
+} SimLoad_t;
+
+typedef struct {
+  uint32_t Posted[SIM_QUEUE];
+  uint8_t Head;
+  uint8_t Count;
+  uint32_t NextPost;
+  uint32_t Lost;
+} SimService_t;
+
+typedef struct {
+  int8_t Running;       // service in its run function, -1 for none
+  uint32_t Left;        // uS of that run still to go
+  uint32_t Posted;      // when its event was posted
+} SimBand_t;
+
+typedef struct {
+  uint32_t MaxStart;
+  uint32_t MaxDone;
+  uint32_t Runs;
+} SimStats_t;
+
+#if NUM_SERVICES != 2
+#error the simulation load needs an entry per service
+#endif
+static SimLoad_t const Load[NUM_SERVICES] = {
+  { 2500, 6000, 4000 },   // ActionService
+  {   40,  500,  500 }    // SPIService
+};
+static uint8_t const ConfiguredBand[NUM_SERVICES] = { SERV_0_BAND, SERV_1_BAND };
+
+static uint32_t Seed = 1;
+
+static uint32_t Random( uint32_t Range )
+{
+  Seed = Seed * 1103515245UL + 12345UL;
+  return (Seed >> 8) % Range;
+}
+
+static void Simulate( bool Banded, SimStats_t *pStats )
+{
+  SimService_t Services[NUM_SERVICES];
+  SimBand_t Bands[ES_NUM_BANDS];
+  uint8_t Band[NUM_SERVICES];
+  uint32_t Now;
+  uint32_t Wait;
+  int8_t i;
+  int8_t b;
+
+  Seed = 1;
+  for ( i = 0; i < NUM_SERVICES; i++ )
+  {
+    Services[i].Head = 0;
+    Services[i].Count = 0;
+    Services[i].Lost = 0;
+    Services[i].NextPost = Random( Load[i].PeriodUS );
+    Band[i] = Banded ? ConfiguredBand[i] : 0;
+  }
+  for ( b = 0; b < ES_NUM_BANDS; b++ )
+  {
+    Bands[b].Running = -1;
+    pStats[b].MaxStart = 0;
+    pStats[b].MaxDone = 0;
+    pStats[b].Runs = 0;
+  }
+
+  for ( Now = 0; Now < SIM_US; Now++ )
+  {
+    // posts due now
+    for ( i = 0; i < NUM_SERVICES; i++ )
+    {
+      if ( Services[i].NextPost == Now )
+      {
+        if ( Services[i].Count < SIM_QUEUE )
+        {
+          Services[i].Posted[(Services[i].Head + Services[i].Count) % SIM_QUEUE] = Now;
+          Services[i].Count++;
+        }
+        else
+        {
+          Services[i].Lost++;
+        }
+        Services[i].NextPost = Now + Load[i].PeriodUS + Random( Load[i].JitterUS );
+      }
+    }
+
+    // the highest band with work has the CPU
+    for ( b = ES_NUM_BANDS - 1; b >= 0; b-- )
+    {
+      if ( Bands[b].Running < 0 )
+      {
+        // highest priority service in the band with a queued event
+        for ( i = NUM_SERVICES - 1; i >= 0; i-- )
+        {
+          if ( (Band[i] == b) && (Services[i].Count != 0) )
+            break;
+        }
+        if ( i < 0 )
+          continue;
+        Bands[b].Running = i;
+        Bands[b].Left = Load[i].RunUS;
+        Bands[b].Posted = Services[i].Posted[Services[i].Head];
+        Services[i].Head = (Services[i].Head + 1) % SIM_QUEUE;
+        Services[i].Count--;
+        Wait = Now - Bands[b].Posted;
+        if ( Wait > pStats[ConfiguredBand[i]].MaxStart )
+          pStats[ConfiguredBand[i]].MaxStart = Wait;
+      }
+      if ( --Bands[b].Left == 0 )
+      {
+        i = Bands[b].Running;
+        Wait = Now + 1 - Bands[b].Posted;
+        if ( Wait > pStats[ConfiguredBand[i]].MaxDone )
+          pStats[ConfiguredBand[i]].MaxDone = Wait;
+        pStats[ConfiguredBand[i]].Runs++;
+        Bands[b].Running = -1;
+      }
+      break;
+    }
+  }
+  for ( i = 0; i < NUM_SERVICES; i++ )
+  {
+    if ( Services[i].Lost != 0 )
+      printf("service %d lost %lu posts to a full queue\r\n", i,
+             (unsigned long)Services[i].Lost);
+  }
+}
+
+// ES_Framework.c is not linked into the simulation
+void ES_RunBand( uint8_t Band ) { (void)Band; }
+
+int main( void )
+{
+  SimStats_t Cooperative[ES_NUM_BANDS];
+  SimStats_t Banded[ES_NUM_BANDS];
+  uint8_t b;
+
+  Simulate( false, Cooperative );
+  Simulate( true, Banded );
+
+  printf("\r\n%lu ms simulated, worst case uS from post\r\n", SIM_US/1000);
+  printf("band   runs  cooperative start/done    banded start/done\r\n");
+  for ( b = 0; b < ES_NUM_BANDS; b++ )
+  {
+    if ( Banded[b].Runs == 0 )
+      continue;
+    printf("%4u %6lu  %10lu %10lu  %10lu %10lu\r\n", b,
+           (unsigned long)Banded[b].Runs,
+           (unsigned long)Cooperative[b].MaxStart,
+           (unsigned long)Cooperative[b].MaxDone,
+           (unsigned long)Banded[b].MaxStart,
+           (unsigned long)Banded[b].MaxDone);
+  }
+  return 0;
+}
+#endif
+/*------------------------------ End of file ------------------------------*/
@@ -1,76 +1,191 @@
-/****************************************************************************
- Module
-     ES_DeferRecall.c
-
- Description
-     This is a module implementing  the management of event deferal and recall
-      queues
- Notes
-     
-
- History
- When           Who     What/Why
- -------------- ---     --------
- 
- 10/11/14 14:58 jec     converted RecallEvent to RecallEvents to pull all
-                        deferred events off the deferral queue
- 11/02/13 16:38 jec      Began Coding
-****************************************************************************/
-
-/*----------------------------- Include Files -----------------------------*/
-#include "ES_Configure.h"
-#include "ES_Framework.h"
-#include "ES_General.h"
-#include "ES_Events.h"
-#include "ES_DeferRecall.h"
-
-/*--------------------------- External Variables --------------------------*/
-
-/*----------------------------- Module Defines ----------------------------*/
-
-/*------------------------------ Module Types -----------------------------*/
-
-/*---------------------------- Module Functions ---------------------------*/
-
-/*---------------------------- Module Variables ---------------------------*/
-
-/*------------------------------ Module Code ------------------------------*/
-/****************************************************************************
- Function
-     ES_RecallEvents
- Parameters
-      uint8_t WhichService, number of the service to post Recalled event to
-      ES_Event * pBlock, pointer to the block of memory that implements the
-        Defer/Recall queue
- Returns
-     bool true if an event was recalled, false if no event was left in queue
- Description
-     pulls all events off the deferral queue if any are available. If there was
-     something in the queue, then it posts it LIFO fashion to the queue 
-     indicated by WhichService
- Notes
-     None.
- Author
-     J. Edward Carryer, 11/20/13 16:49
-****************************************************************************/
-bool ES_RecallEvents( uint8_t WhichService, ES_Event * pBlock ){
-  ES_Event RecalledEvent;
-	bool WereEventsPulled = false;
-  // recall any events from the queue
-  do
-	{	
-		ES_DeQueue( pBlock, &RecalledEvent );
-		if (RecalledEvent.EventType != ES_NO_EVENT){
-			ES_PostToServiceLIFO( WhichService, RecalledEvent);
-			WereEventsPulled = true;
-		}
-  }while(RecalledEvent.EventType != ES_NO_EVENT);
-  return WereEventsPulled;
-  
-}
-  
-/*------------------------------- Footnotes -------------------------------*/
-
-
-/*------------------------------ End of file ------------------------------*/
-
+/****************************************************************************
+ Module
+     ES_DeferRecall.c
+
+ Description
+     This is a module implementing  the management of event deferal and recall
+      queues
+ Notes
+     
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 22:30 t16      recall splices the whole deferral queue onto the
+                        front of the service queue, defer is FIFO
+ 10/11/14 14:58 jec     converted RecallEvent to RecallEvents to pull all
+                        deferred events off the deferral queue
+ 11/02/13 16:38 jec      Began Coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_General.h"
+#include "ES_Events.h"
+#include "ES_DeferRecall.h"
+
+/*--------------------------- External Variables --------------------------*/
+
+/*----------------------------- Module Defines ----------------------------*/
+
+/*------------------------------ Module Types -----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+     ES_RecallEvents
+ Parameters
+      uint8_t WhichService, number of the service to post Recalled event to
+      ES_Event * pBlock, pointer to the block of memory that implements the
+        Defer/Recall queue
+ Returns
+     bool true if an event was recalled, false if no event was left in queue
+ Description
+     moves all the events on the deferral queue to the front of the queue
+     indicated by WhichService, in the order they were deferred, so they
+     are handled before anything already waiting for the service
+ Notes
+     one splice in one critical region, where this used to dequeue and
+     post LIFO one event at a time. Events that do not fit in the service's
+     queue stay deferred for the next recall.
+ Author
+     J. Edward Carryer, 11/20/13 16:49
+****************************************************************************/
+bool ES_RecallEvents( uint8_t WhichService, ES_Event * pBlock ){
+  return ( ES_SpliceToService( WhichService, pBlock ) != 0 );
+}
+  
+#ifdef TEST
+/* recall test and cost comparison, run on the target. The service queue
+   is a local queue here, so the splice is tested with ES_SpliceToFront
+   directly. Each round defers DEFER_COUNT events behind one event that is
+   already waiting for the service, recalls them, and checks they come out
+   in the order deferred and ahead of the waiting one. The old recall
+   (LIFO defer, then dequeue and LIFO post one at a time) is timed on the
+   same rounds with the DWT cycle counter.
+*/
+#include <stdio.h>
+#include "driverlib/sysctl.h"
+#include "inc/hw_types.h"
+#include "termio.h"
+
+#define TEST_ROUNDS 1000
+#define DEFER_COUNT 4
+
+static ES_Event DeferQueue[DEFER_COUNT+1];
+static ES_Event ServiceQueue[DEFER_COUNT+2+1];
+
+static void Fill( bool Lifo ){
+  ES_Event ThisEvent;
+  uint8_t i;
+
+  ES_InitQueue( ServiceQueue, ARRAY_SIZE(ServiceQueue) );
+  ES_InitDeferralQueueWith( DeferQueue, ARRAY_SIZE(DeferQueue) );
+  ThisEvent.EventType = ES_NEW_KEY;
+  ThisEvent.EventParam = 100;  // already waiting for the service
+  ES_EnQueueFIFO( ServiceQueue, ThisEvent );
+  for ( i = 0; i < DEFER_COUNT; i++ ){
+    ThisEvent.EventParam = i;
+    if ( Lifo )
+      ES_EnQueueLIFO( DeferQueue, ThisEvent );
+    else
+      ES_DeferEvent( DeferQueue, ThisEvent );
+  }
+}
+
+// the recall as it was, with the service's post replaced by the enqueue
+static void OldRecall( void ){
+  ES_Event RecalledEvent;
+  do {
+    ES_DeQueue( DeferQueue, &RecalledEvent );
+    if (RecalledEvent.EventType != ES_NO_EVENT)
+      ES_EnQueueLIFO( ServiceQueue, RecalledEvent );
+  } while (RecalledEvent.EventType != ES_NO_EVENT);
+}
+
+// true if the service queue holds 0..DEFER_COUNT-1 and then 100
+static bool InOrder( void ){
+  ES_Event ThisEvent;
+  uint8_t i;
+
+  for ( i = 0; i <= DEFER_COUNT; i++ ){
+    ES_DeQueue( ServiceQueue, &ThisEvent );
+    if ( ThisEvent.EventParam != ((i < DEFER_COUNT) ? i : 100) )
+      return false;
+  }
+  return ES_IsQueueEmpty( ServiceQueue );
+}
+
+int main( void ){
+  ES_Event ThisEvent;
+  uint32_t Start;
+  uint32_t OldCycles = 0;
+  uint32_t NewCycles = 0;
+  uint16_t Failures = 0;
+  uint16_t i;
+
+  SysCtlClockSet(CPU_CLOCK_SYSCTL);
+  TERMIO_Init();
+  ES_CycleCounterStart();
+  HWREG(DWT_CYCCNT) = 0;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Fill( true );
+    Start = HWREG(DWT_CYCCNT);
+    OldRecall();
+    OldCycles += HWREG(DWT_CYCCNT) - Start;
+    if ( !InOrder() )
+      Failures++;
+
+    Fill( false );
+    Start = HWREG(DWT_CYCCNT);
+    ES_SpliceToFront( ServiceQueue, DeferQueue );
+    NewCycles += HWREG(DWT_CYCCNT) - Start;
+    if ( !InOrder() || !ES_IsQueueEmpty( DeferQueue ) )
+      Failures++;
+  }
+
+  // overflow: two more than fit are refused and counted
+  ES_InitDeferralQueueWith( DeferQueue, ARRAY_SIZE(DeferQueue) );
+  ThisEvent.EventType = ES_NEW_KEY;
+  for ( i = 0; i < DEFER_COUNT + 2; i++ ){
+    ThisEvent.EventParam = i;
+    ES_DeferEvent( DeferQueue, ThisEvent );
+  }
+  if ( ES_DeferOverflows( DeferQueue ) != 2 )
+    Failures++;
+
+  // partial recall: room for two, the oldest two move, the rest stay
+  ES_InitQueue( ServiceQueue, ARRAY_SIZE(ServiceQueue) );
+  for ( i = 0; i < 4; i++ )
+    ES_EnQueueFIFO( ServiceQueue, ThisEvent );
+  if ( ES_SpliceToFront( ServiceQueue, DeferQueue ) != 2 )
+    Failures++;
+  ES_DeQueue( ServiceQueue, &ThisEvent );
+  if ( ThisEvent.EventParam != 0 )
+    Failures++;
+  ES_DeQueue( ServiceQueue, &ThisEvent );
+  if ( ThisEvent.EventParam != 1 )
+    Failures++;
+  ES_DeQueue( DeferQueue, &ThisEvent );
+  if ( ThisEvent.EventParam != 2 )
+    Failures++;
+
+  printf("\r\nrecall of %d deferred events, %d rounds\r\n", DEFER_COUNT, TEST_ROUNDS);
+  printf("one at a time %lu cycles\r\n", (unsigned long)(OldCycles/TEST_ROUNDS));
+  printf("splice        %lu cycles\r\n", (unsigned long)(NewCycles/TEST_ROUNDS));
+  printf("%u failures\r\n", Failures);
+  for (;;)
+    ;
+}
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+
+
+/*------------------------------ End of file ------------------------------*/
+
@@ -1,418 +1,954 @@
-/****************************************************************************
- Module
-     EF_Framework.c
- Description
-     source file for the core functions of the Events & Services framework
- Notes
-     
- History
- When           Who     What/Why
- -------------- ---     --------
- 11/02/13 17:05 jec      added PostToServiceLIFO function
- 10/21/13 17:50 jec      added entries to expand number of possible services to 
-                         16
- 08/13/13 12:59 jec      re-structured ES_Run() slightly to call hardware
-                         specific routine to process pending interrupts. This
-                         removes the need for re-entrant code and critial
-                         regions in the queue code.
- 08/06/13 14:50 jec      removed references to PostKeyFunc. We moved that out
-                         of the framework into the EventCheckers module
- 01/30/12 19:31 jec      moved call to ES_InitTimers into the ES_Initialize
-                         this required adding a parameter to ES_Initialize.
- 01/15/12 12:15 jec      major revision for Gen2
- 10/17/11 12:24 jec      started coding
-*****************************************************************************/
-/*----------------------------- Include Files -----------------------------*/
-#include "ES_Configure.h"
-#include "ES_Framework.h"
-#include "ES_Queue.h"
-#include "ES_LookupTables.h"
-#include <stdio.h>
-
-// Include the header files for the Service modules.
-// This gets you the prototypes for the public service functions.
-
-#include "ES_ServiceHeaders.h"
-
-
-/*----------------------------- Module Defines ----------------------------*/
-typedef bool InitFunc_t( uint8_t Priority );
-typedef ES_Event RunFunc_t( ES_Event ThisEvent );
-
-typedef InitFunc_t * pInitFunc;
-typedef RunFunc_t * pRunFunc;
-
-#define NULL_INIT_FUNC ((pInitFunc)0)
-
-typedef struct {
-    InitFunc_t *InitFunc;    // Service Initialization function
-    RunFunc_t *RunFunc;      // Service Run function
-}ES_ServDesc_t;
-
-typedef struct {
-    ES_Event *pMem;       // pointer to the memory
-    uint8_t Size;      // how big is it
-}ES_QueueDesc_t;
-
-/*---------------------------- Module Functions ---------------------------*/
-//static bool CheckSystemEvents( void );
-
-/*---------------------------- Module Variables ---------------------------*/
-/****************************************************************************/
-// You fill in this array with the names of the service init & run functions
-// for each service that you use.
-// The order is: InitFunction, RunFunction
-// The first entry, at index 0, is the lowest priority, with increasing
-// priority with higher indices
-
-static ES_ServDesc_t const ServDescList[] =
-{ {SERV_0_INIT, SERV_0_RUN } /* lowest priority  always present */
-#if NUM_SERVICES > 1
-  ,{SERV_1_INIT, SERV_1_RUN }
-#endif
-#if NUM_SERVICES > 2
-  ,{SERV_2_INIT, SERV_2_RUN }
-#endif
-#if NUM_SERVICES > 3
-  ,{SERV_3_INIT, SERV_3_RUN }
-#endif
-#if NUM_SERVICES > 4
-  ,{SERV_4_INIT, SERV_4_RUN }
-#endif
-#if NUM_SERVICES > 5
-  ,{SERV_5_INIT, SERV_5_RUN }
-#endif
-#if NUM_SERVICES > 6
-  ,{SERV_6_INIT, SERV_6_RUN }
-#endif
-#if NUM_SERVICES > 7
-  ,{SERV_7_INIT, SERV_7_RUN }
-#endif
-#if NUM_SERVICES > 8
-  ,{SERV_8_INIT, SERV_8_RUN }
-#endif
-#if NUM_SERVICES > 9
-  ,{SERV_9_INIT, SERV_9_RUN }
-#endif
-#if NUM_SERVICES > 10
-  ,{SERV_10_INIT, SERV_10_RUN }
-#endif
-#if NUM_SERVICES > 11
-  ,{SERV_11_INIT, SERV_11_RUN }
-#endif
-#if NUM_SERVICES > 12
-  ,{SERV_12_INIT, SERV_12_RUN }
-#endif
-#if NUM_SERVICES > 13
-  ,{SERV_13_INIT, SERV_13_RUN }
-#endif
-#if NUM_SERVICES > 14
-  ,{SERV_14_INIT, SERV_14_RUN }
-#endif
-#if NUM_SERVICES > 15
-  ,{SERV_15_INIT, SERV_15_RUN }
-#endif
-
-};
-
-
-/****************************************************************************/
-// The queues for the services
-
-static ES_Event Queue0[SERV_0_QUEUE_SIZE+1];
-#if NUM_SERVICES > 1
-static ES_Event Queue1[SERV_1_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 2
-static ES_Event Queue2[SERV_2_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 3
-static ES_Event Queue3[SERV_3_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 4
-static ES_Event Queue4[SERV_4_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 5
-static ES_Event Queue5[SERV_5_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 6
-static ES_Event Queue6[SERV_6_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 7
-static ES_Event Queue7[SERV_7_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 8
-static ES_Event Queue8[SERV_8_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 9
-static ES_Event Queue9[SERV_9_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 10
-static ES_Event Queue10[SERV_10_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 11
-static ES_Event Queue11[SERV_11_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 12
-static ES_Event Queue12[SERV_12_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 13
-static ES_Event Queue13[SERV_13_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 14
-static ES_Event Queue14[SERV_14_QUEUE_SIZE+1];
-#endif
-#if NUM_SERVICES > 15
-static ES_Event Queue15[SERV_15_QUEUE_SIZE+1];
-#endif
-
-/****************************************************************************/
-// array of queue descriptors for posting by priority level
-
-static ES_QueueDesc_t const EventQueues[NUM_SERVICES] = { 
-  { Queue0, ARRAY_SIZE(Queue0) } 
-#if NUM_SERVICES > 1
-, { Queue1, ARRAY_SIZE(Queue1) }
-#endif
-#if NUM_SERVICES > 2
-, { Queue2, ARRAY_SIZE(Queue2) }
-#endif
-#if NUM_SERVICES > 3
-, { Queue3, ARRAY_SIZE(Queue3) }
-#endif
-#if NUM_SERVICES > 4
-, { Queue4, ARRAY_SIZE(Queue4) }
-#endif
-#if NUM_SERVICES > 5
-, { Queue5, ARRAY_SIZE(Queue5) }
-#endif
-#if NUM_SERVICES > 6
-, { Queue6, ARRAY_SIZE(Queue6) }
-#endif
-#if NUM_SERVICES > 7
-, { Queue7, ARRAY_SIZE(Queue7) }
-#endif
-#if NUM_SERVICES > 8
-, { Queue8, ARRAY_SIZE(Queue8) }
-#endif
-#if NUM_SERVICES > 9
-, { Queue9, ARRAY_SIZE(Queue9) }
-#endif
-#if NUM_SERVICES > 10
-, { Queue10, ARRAY_SIZE(Queue10) }
-#endif
-#if NUM_SERVICES > 11
-, { Queue11, ARRAY_SIZE(Queue11) }
-#endif
-#if NUM_SERVICES > 12
-, { Queue12, ARRAY_SIZE(Queue12) }
-#endif
-#if NUM_SERVICES > 13
-, { Queue13, ARRAY_SIZE(Queue13) }
-#endif
-#if NUM_SERVICES > 14
-, { Queue14, ARRAY_SIZE(Queue14) }
-#endif
-#if NUM_SERVICES > 15
-, { Queue15, ARRAY_SIZE(Queue15) }
-#endif
-};
-
-/****************************************************************************/
-// Variable used to keep track of which queues have events in them
-
-uint16_t Ready;
-
-/*------------------------------ Module Code ------------------------------*/
-/****************************************************************************
- Function
-   ES_Initialize
- Parameters
-   TimerRate_t the rate at which to initialize the framework timer subsystem
- Returns
-   ES_Return_t : FailedPointer if any of the function pointers are NULL
-                 FailedInit if any of the initialization functions failed
- Description
-   Initialize all the services and tests for NULL pointers in the array
- Notes
-
- Author
-   J. Edward Carryer, 10/23/11,
-****************************************************************************/
-ES_Return_t ES_Initialize( TimerRate_t NewRate ){
-  uint8_t i;
-  ES_Timer_Init( NewRate); // start up the timer subsystem
-  // loop through the list testing for NULL pointers and
-  for ( i=0; i< ARRAY_SIZE(ServDescList); i++) {
-    if ( (ServDescList[i].InitFunc == (pInitFunc)0) ||
-         (ServDescList[i].RunFunc == (pRunFunc)0) )
-      return FailedPointer; // protect against NULL pointers
-    // and initializing the event queues (must happen before running inits)  
-    ES_InitQueue( EventQueues[i].pMem, EventQueues[i].Size );
-   // executing the init functions
-    if ( ServDescList[i].InitFunc(i) != true )
-      return FailedInit; // this is a failed initialization
-  }
-  return Success;
-}
-
-/****************************************************************************
- Function
-   ES_Run
- Parameters
-   None
- Returns
-   ES_Return_t : FailedRun is any of the run functions failed during execution
- Description
-   This is the main framework function. It searches through the state
-   machines to find one with a non-empty queue and then executes the
-   state machine to process the event in its queue.
-   while all the queues are empty, it searches for system generated or
-   user generated events.
- Notes
-   this function only returns in case of an error
- Author
-   J. Edward Carryer, 10/23/11,
-****************************************************************************/
-ES_Return_t ES_Run( void ){
-  // make these static to improve speed
-  uint8_t HighestPrior;
-  static ES_Event ThisEvent;
-  
-  while(1){ // stay here unless we detect an error condition
-
-    // loop through the list executing the run functions for services
-    // with a non-empty queue. Process any pending ints before testing
-    // Ready
-    while( (_HW_Process_Pending_Ints()) && (Ready != 0)){
-      HighestPrior =  ES_GetMSBitSet(Ready);
-      if ( ES_DeQueue( EventQueues[HighestPrior].pMem, &ThisEvent ) == 0 ){
-        Ready &= BitNum2ClrMask[HighestPrior]; // mark queue as now empty
-      }
-      if( ServDescList[HighestPrior].RunFunc(ThisEvent).EventType != 
-                                                              ES_NO_EVENT) {
-              return FailedRun;
-      }
-    }
-
-    // all the queues are empty, so look for new user detected events
-    ES_CheckUserEvents();
-  }
-}
-
-/****************************************************************************
- Function
-   ES_PostAll
- Parameters
-   ES_Event : The Event to be posted
- Returns
-   boolean : False if any of the post functions failed during execution
- Description
-   posts to all of the services' queues 
- Notes
-
- Author
-   J. Edward Carryer, 01/15/12,
-****************************************************************************/
-bool ES_PostAll( ES_Event ThisEvent){
-
-  uint8_t i;
-  // loop through the list executing the post functions
-  for ( i=0; i< ARRAY_SIZE(EventQueues); i++) {
-    if ( ES_EnQueueFIFO( EventQueues[i].pMem, ThisEvent ) != true ){
-      break; // this is a failed post
-    }else{
-      Ready |= BitNum2SetMask[i]; // show queue as non-empty
-    }
-  }
-  if ( i == ARRAY_SIZE(EventQueues) ){ // if no failures
-    return (true);
-  }else{
-    return(false);
-  }
-}
-
-/****************************************************************************
- Function
-   ES_PostToService
- Parameters
-   uint8_t : Which service to post to (index into ServDescList)
-   ES_Event : The Event to be posted
- Returns
-   boolean : False if the post function failed during execution
- Description
-   posts to one of the services' queues
- Notes
-   used by the timer library to associate a timer with a state machine
- Author
-   J. Edward Carryer, 01/16/12,
-****************************************************************************/
-bool ES_PostToService( uint8_t WhichService, ES_Event TheEvent){
-  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueFIFO( EventQueues[WhichService].pMem, TheEvent) == 
-                                                                true )){
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
-    return true;
-  } else
-    return false;
-}
-
-/****************************************************************************
- Function
-   ES_PostToServiceLIFO
- Parameters
-   uint8_t : Which service to post to (index into ServDescList)
-   ES_Event : The Event to be posted
- Returns
-   boolean : False if the post function failed during execution
- Description
-   Posts, using LIFO strategy, to one of the services' queues
- Notes
-   used by the Defer/Recall event capability
- Author
-   J. Edward Carryer, 11/02/13
-****************************************************************************/
-bool ES_PostToServiceLIFO( uint8_t WhichService, ES_Event TheEvent){
-  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueLIFO( EventQueues[WhichService].pMem, TheEvent) == 
-                                                                true )){
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
-    return true;
-  } else
-    return false;
-}
-
-//*********************************
-// private functions
-//*********************************
-#if 0
-/****************************************************************************
- Function
-   CheckSystemEvents
- Parameters
-   None
- Returns
-   boolean : True if a system event was detected
- Description
-   check for system generated events and uses pPostKeyFunc to post to one
-   of the state machine's queues
- Notes
-   currently only tests for incoming keystrokes
- Author
-   J. Edward Carryer, 10/23/11, 
-****************************************************************************/
-static bool CheckSystemEvents( void ){
-  
-  if ( kbhit() != 0 ) // new key waiting?
-  {
-    ES_Event ThisEvent;
-    ThisEvent.EventType = ES_NEW_KEY;
-    ThisEvent.EventParam = getchar();
-    (*pPostKeyFunc)( ThisEvent );
-    return true;
-  }
-  return false;
-}
-#endif
-/*------------------------------- Footnotes -------------------------------*/
-/*------------------------------ End of file ------------------------------*/
+/****************************************************************************
+ Module
+     EF_Framework.c
+ Description
+     source file for the core functions of the Events & Services framework
+ Notes
+     
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16      ES_PostAll back to bool, the failure mask is
+                         ES_PostAllMask
+ 10/19/26 23:59 t16      LIFO post and Ready bit in one critical region
+ 10/19/26 23:55 t16      scheduler loop in SRAM, vector table moved there
+ 10/19/26 23:40 t16      start the cycle counter and the ISR profile
+ 10/19/26 23:00 t16      critical regions through ES_EnterCritical
+ 10/19/26 22:30 t16      ES_SpliceToService for the bulk recall
+ 10/19/26 22:00 t16      optional preemptive bands, services in bands above 0
+                         run from software triggered interrupts
+ 10/19/26 21:30 t16      initialize the urgent action hook
+ 10/19/26 21:05 t16      ES_PostAll posts to every queue it can, returns failures
+ 10/19/26 20:40 t16      publish/subscribe by event type, bulk ES_PostToMask
+ 10/19/26 20:10 t16      return pool blocks after each run function
+ 11/02/13 17:05 jec      added PostToServiceLIFO function
+ 10/21/13 17:50 jec      added entries to expand number of possible services to 
+                         16
+ 08/13/13 12:59 jec      re-structured ES_Run() slightly to call hardware
+                         specific routine to process pending interrupts. This
+                         removes the need for re-entrant code and critial
+                         regions in the queue code.
+ 08/06/13 14:50 jec      removed references to PostKeyFunc. We moved that out
+                         of the framework into the EventCheckers module
+ 01/30/12 19:31 jec      moved call to ES_InitTimers into the ES_Initialize
+                         this required adding a parameter to ES_Initialize.
+ 01/15/12 12:15 jec      major revision for Gen2
+ 10/17/11 12:24 jec      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Queue.h"
+#include "ES_Pool.h"
+#include "ES_Urgent.h"
+#include "ES_Bands.h"
+#include "ES_LookupTables.h"
+#include "inc/hw_types.h"
+#include <stdio.h>
+
+// Include the header files for the Service modules.
+// This gets you the prototypes for the public service functions.
+
+#include "ES_ServiceHeaders.h"
+
+
+/*----------------------------- Module Defines ----------------------------*/
+typedef bool InitFunc_t( uint8_t Priority );
+typedef ES_Event RunFunc_t( ES_Event ThisEvent );
+
+typedef InitFunc_t * pInitFunc;
+typedef RunFunc_t * pRunFunc;
+
+#define NULL_INIT_FUNC ((pInitFunc)0)
+
+typedef struct {
+    InitFunc_t *InitFunc;    // Service Initialization function
+    RunFunc_t *RunFunc;      // Service Run function
+}ES_ServDesc_t;
+
+typedef struct {
+    ES_Event *pMem;       // pointer to the memory
+    uint8_t Size;      // how big is it
+}ES_QueueDesc_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+//static bool CheckSystemEvents( void );
+static void MarkReady( uint16_t Posted );
+static bool RunHighest( uint8_t Band );
+
+/*---------------------------- Module Variables ---------------------------*/
+/****************************************************************************/
+// You fill in this array with the names of the service init & run functions
+// for each service that you use.
+// The order is: InitFunction, RunFunction
+// The first entry, at index 0, is the lowest priority, with increasing
+// priority with higher indices
+
+static ES_ServDesc_t const ServDescList[] =
+{ {SERV_0_INIT, SERV_0_RUN } /* lowest priority  always present */
+#if NUM_SERVICES > 1
+  ,{SERV_1_INIT, SERV_1_RUN }
+#endif
+#if NUM_SERVICES > 2
+  ,{SERV_2_INIT, SERV_2_RUN }
+#endif
+#if NUM_SERVICES > 3
+  ,{SERV_3_INIT, SERV_3_RUN }
+#endif
+#if NUM_SERVICES > 4
+  ,{SERV_4_INIT, SERV_4_RUN }
+#endif
+#if NUM_SERVICES > 5
+  ,{SERV_5_INIT, SERV_5_RUN }
+#endif
+#if NUM_SERVICES > 6
+  ,{SERV_6_INIT, SERV_6_RUN }
+#endif
+#if NUM_SERVICES > 7
+  ,{SERV_7_INIT, SERV_7_RUN }
+#endif
+#if NUM_SERVICES > 8
+  ,{SERV_8_INIT, SERV_8_RUN }
+#endif
+#if NUM_SERVICES > 9
+  ,{SERV_9_INIT, SERV_9_RUN }
+#endif
+#if NUM_SERVICES > 10
+  ,{SERV_10_INIT, SERV_10_RUN }
+#endif
+#if NUM_SERVICES > 11
+  ,{SERV_11_INIT, SERV_11_RUN }
+#endif
+#if NUM_SERVICES > 12
+  ,{SERV_12_INIT, SERV_12_RUN }
+#endif
+#if NUM_SERVICES > 13
+  ,{SERV_13_INIT, SERV_13_RUN }
+#endif
+#if NUM_SERVICES > 14
+  ,{SERV_14_INIT, SERV_14_RUN }
+#endif
+#if NUM_SERVICES > 15
+  ,{SERV_15_INIT, SERV_15_RUN }
+#endif
+
+};
+
+
+/****************************************************************************/
+// The queues for the services
+
+static ES_Event Queue0[SERV_0_QUEUE_SIZE+1];
+#if NUM_SERVICES > 1
+static ES_Event Queue1[SERV_1_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 2
+static ES_Event Queue2[SERV_2_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 3
+static ES_Event Queue3[SERV_3_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 4
+static ES_Event Queue4[SERV_4_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 5
+static ES_Event Queue5[SERV_5_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 6
+static ES_Event Queue6[SERV_6_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 7
+static ES_Event Queue7[SERV_7_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 8
+static ES_Event Queue8[SERV_8_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 9
+static ES_Event Queue9[SERV_9_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 10
+static ES_Event Queue10[SERV_10_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 11
+static ES_Event Queue11[SERV_11_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 12
+static ES_Event Queue12[SERV_12_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 13
+static ES_Event Queue13[SERV_13_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 14
+static ES_Event Queue14[SERV_14_QUEUE_SIZE+1];
+#endif
+#if NUM_SERVICES > 15
+static ES_Event Queue15[SERV_15_QUEUE_SIZE+1];
+#endif
+
+/****************************************************************************/
+// array of queue descriptors for posting by priority level
+
+static ES_QueueDesc_t const EventQueues[NUM_SERVICES] = { 
+  { Queue0, ARRAY_SIZE(Queue0) } 
+#if NUM_SERVICES > 1
+, { Queue1, ARRAY_SIZE(Queue1) }
+#endif
+#if NUM_SERVICES > 2
+, { Queue2, ARRAY_SIZE(Queue2) }
+#endif
+#if NUM_SERVICES > 3
+, { Queue3, ARRAY_SIZE(Queue3) }
+#endif
+#if NUM_SERVICES > 4
+, { Queue4, ARRAY_SIZE(Queue4) }
+#endif
+#if NUM_SERVICES > 5
+, { Queue5, ARRAY_SIZE(Queue5) }
+#endif
+#if NUM_SERVICES > 6
+, { Queue6, ARRAY_SIZE(Queue6) }
+#endif
+#if NUM_SERVICES > 7
+, { Queue7, ARRAY_SIZE(Queue7) }
+#endif
+#if NUM_SERVICES > 8
+, { Queue8, ARRAY_SIZE(Queue8) }
+#endif
+#if NUM_SERVICES > 9
+, { Queue9, ARRAY_SIZE(Queue9) }
+#endif
+#if NUM_SERVICES > 10
+, { Queue10, ARRAY_SIZE(Queue10) }
+#endif
+#if NUM_SERVICES > 11
+, { Queue11, ARRAY_SIZE(Queue11) }
+#endif
+#if NUM_SERVICES > 12
+, { Queue12, ARRAY_SIZE(Queue12) }
+#endif
+#if NUM_SERVICES > 13
+, { Queue13, ARRAY_SIZE(Queue13) }
+#endif
+#if NUM_SERVICES > 14
+, { Queue14, ARRAY_SIZE(Queue14) }
+#endif
+#if NUM_SERVICES > 15
+, { Queue15, ARRAY_SIZE(Queue15) }
+#endif
+};
+
+/****************************************************************************/
+// Variable used to keep track of which queues have events in them
+
+volatile uint16_t Ready;
+
+/****************************************************************************/
+// which band each service runs in, from ES_Configure.h. Without
+// ES_PREEMPTIVE every service is in band 0, run by ES_Run
+
+#if ES_PREEMPTIVE
+static uint8_t const ServiceBand[NUM_SERVICES] = {
+  SERV_0_BAND
+#if NUM_SERVICES > 1
+, SERV_1_BAND
+#endif
+#if NUM_SERVICES > 2
+, SERV_2_BAND
+#endif
+#if NUM_SERVICES > 3
+, SERV_3_BAND
+#endif
+#if NUM_SERVICES > 4
+, SERV_4_BAND
+#endif
+#if NUM_SERVICES > 5
+, SERV_5_BAND
+#endif
+#if NUM_SERVICES > 6
+, SERV_6_BAND
+#endif
+#if NUM_SERVICES > 7
+, SERV_7_BAND
+#endif
+#if NUM_SERVICES > 8
+, SERV_8_BAND
+#endif
+#if NUM_SERVICES > 9
+, SERV_9_BAND
+#endif
+#if NUM_SERVICES > 10
+, SERV_10_BAND
+#endif
+#if NUM_SERVICES > 11
+, SERV_11_BAND
+#endif
+#if NUM_SERVICES > 12
+, SERV_12_BAND
+#endif
+#if NUM_SERVICES > 13
+, SERV_13_BAND
+#endif
+#if NUM_SERVICES > 14
+, SERV_14_BAND
+#endif
+#if NUM_SERVICES > 15
+, SERV_15_BAND
+#endif
+};
+#endif
+
+// services run by each band, built by ES_Initialize
+static uint16_t BandMask[ES_NUM_BANDS];
+
+// bit n set while band n has a post it has not started on, with the cycle
+// count of that post, for the post to run latency
+static uint8_t Kicked;
+static uint32_t KickedAt[ES_NUM_BANDS];
+static ES_BandStats_t BandStats[ES_NUM_BANDS];
+
+// a run function called from a band interrupt failed, ES_Run reports it
+static volatile bool BandFailed;
+
+/****************************************************************************/
+// bit n of Subscribers[EventType] is set if service n takes that event
+// type from ES_Publish. Filled in by ES_Subscribe in the service inits
+
+static uint16_t Subscribers[NUM_ES_EVENT_TYPES];
+
+#define ALL_SERVICES_MASK ((uint16_t)((1UL << NUM_SERVICES) - 1))
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_GetQueueRAM
+ Parameters
+   None
+ Returns
+   uint16_t bytes used by the event queues of all the services
+ Description
+   for comparing the ES_EVENT_FORMAT choices
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint16_t ES_GetQueueRAM( void )
+{
+  uint16_t Bytes = 0;
+  uint8_t i;
+  for ( i=0; i< ARRAY_SIZE(EventQueues); i++)
+    Bytes += EventQueues[i].Size * sizeof(ES_Event);
+  return Bytes;
+}
+
+/****************************************************************************
+ Function
+   ES_Initialize
+ Parameters
+   TimerRate_t the rate at which to initialize the framework timer subsystem
+ Returns
+   ES_Return_t : FailedPointer if any of the function pointers are NULL
+                 FailedInit if any of the initialization functions failed
+ Description
+   Initialize all the services and tests for NULL pointers in the array
+ Notes
+
+ Author
+   J. Edward Carryer, 10/23/11,
+****************************************************************************/
+ES_Return_t ES_Initialize( TimerRate_t NewRate ){
+  uint8_t i;
+  ES_CycleCounterStart(); // every profile below counts CPU cycles
+  ES_IsrProfileInit();
+#if ES_RAM_CODE
+  _HW_RelocateVectors(); // before the tick interrupt is turned on
+#endif
+  ES_Timer_Init( NewRate); // start up the timer subsystem
+  ES_PoolInit(); // every payload block starts out free
+  ES_UrgentInit(); // no urgent handlers until the services register them
+  for ( i=0; i< ARRAY_SIZE(Subscribers); i++) {
+    Subscribers[i] = 0;  // services subscribe again in their inits
+  }
+  for ( i=0; i< ES_NUM_BANDS; i++) {
+    BandMask[i] = 0;
+  }
+  for ( i=0; i< ARRAY_SIZE(ServDescList); i++) {
+#if ES_PREEMPTIVE
+    if ( ServiceBand[i] >= ES_NUM_BANDS )
+      return FailedIndex;
+    BandMask[ServiceBand[i]] |= BitNum2SetMask[i];
+#else
+    BandMask[0] |= BitNum2SetMask[i];
+#endif
+  }
+  Kicked = 0;
+  BandFailed = false;
+  ES_ClearBandStats();
+  // loop through the list testing for NULL pointers and
+  for ( i=0; i< ARRAY_SIZE(ServDescList); i++) {
+    if ( (ServDescList[i].InitFunc == (pInitFunc)0) ||
+         (ServDescList[i].RunFunc == (pRunFunc)0) )
+      return FailedPointer; // protect against NULL pointers
+    // and initializing the event queues (must happen before running inits)  
+    ES_InitQueue( EventQueues[i].pMem, EventQueues[i].Size );
+   // executing the init functions
+    if ( ServDescList[i].InitFunc(i) != true )
+      return FailedInit; // this is a failed initialization
+  }
+#if ES_PREEMPTIVE
+  // events posted by the inits are waiting, the bands take them from here
+  ES_BandsInit();
+#endif
+  return Success;
+}
+
+/****************************************************************************
+ Function
+   ES_Run
+ Parameters
+   None
+ Returns
+   ES_Return_t : FailedRun is any of the run functions failed during execution
+ Description
+   This is the main framework function. It searches through the state
+   machines to find one with a non-empty queue and then executes the
+   state machine to process the event in its queue.
+   while all the queues are empty, it searches for system generated or
+   user generated events.
+ Notes
+   this function only returns in case of an error. With ES_PREEMPTIVE
+   set it only runs the services in band 0, the band interrupts run the
+   rest
+ Author
+   J. Edward Carryer, 10/23/11,
+****************************************************************************/
+ES_RAMFUNC ES_Return_t ES_Run( void ){
+  
+  while(1){ // stay here unless we detect an error condition
+
+    // loop through the list executing the run functions for services
+    // with a non-empty queue. Process any pending ints before testing
+    // Ready
+    while( (_HW_Process_Pending_Ints()) && ((Ready & BandMask[0]) != 0)){
+      if ( RunHighest( 0 ) != true )
+        return FailedRun;
+    }
+    if ( BandFailed )
+      return FailedRun;
+
+    // all the queues are empty, so look for new user detected events
+    ES_CheckUserEvents();
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_RunBand
+ Parameters
+   uint8_t : which band
+ Returns
+   nothing
+ Description
+   runs the services in the band until all their queues are empty
+ Notes
+   called from the band's interrupt handler in ES_Bands.c. A failed run
+   function stops the band and makes ES_Run return FailedRun
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+void ES_RunBand( uint8_t Band ){
+  if ( Band >= ES_NUM_BANDS )
+    return;
+  while( (Ready & BandMask[Band]) != 0){
+    if ( RunHighest( Band ) != true ){
+      BandFailed = true;
+      return;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_GetBandStats
+ Parameters
+   uint8_t : which band
+   ES_BandStats_t * : filled with the band's post to run latency
+ Returns
+   boolean : False if there is no such band
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+bool ES_GetBandStats( uint8_t Band, ES_BandStats_t *pStats ){
+  uint32_t Saved;
+
+  if ( Band >= ES_NUM_BANDS )
+    return false;
+  Saved = ES_EnterCritical();
+  *pStats = BandStats[Band];
+  ES_ExitCritical(Saved);
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_ClearBandStats
+ Description
+   starts a new latency measurement in every band
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+void ES_ClearBandStats( void ){
+  uint32_t Saved;
+  uint8_t i;
+
+  Saved = ES_EnterCritical();
+  for ( i=0; i< ES_NUM_BANDS; i++) {
+    BandStats[i].Runs = 0;
+    BandStats[i].LastCycles = 0;
+    BandStats[i].MaxCycles = 0;
+  }
+  ES_ExitCritical(Saved);
+}
+
+/****************************************************************************
+ Function
+   ES_PostAll
+ Parameters
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if any of the post functions failed during execution
+ Description
+   posts to all of the services' queues 
+ Notes
+   ES_PostAllMask says which services missed the event
+ Author
+   J. Edward Carryer, 01/15/12,
+****************************************************************************/
+bool ES_PostAll( ES_Event ThisEvent){
+  return ( ES_PostAllMask( ThisEvent) == 0 );
+}
+
+/****************************************************************************
+ Function
+   ES_PostAllMask
+ Parameters
+   ES_Event : The Event to be posted
+ Returns
+   uint16_t : bit n set if service n's queue was full, 0 if all got it
+ Description
+   posts to all of the services' queues 
+ Notes
+   one critical region for the whole broadcast, so no service sees the
+   event before the others are queued, and a full queue does not keep
+   the event from the services after it
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint16_t ES_PostAllMask( ES_Event ThisEvent){
+  return ES_PostToMask( ALL_SERVICES_MASK, ThisEvent);
+}
+
+/****************************************************************************
+ Function
+   ES_PostToService
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if the post function failed during execution
+ Description
+   posts to one of the services' queues
+ Notes
+   used by the timer library to associate a timer with a state machine
+ Author
+   J. Edward Carryer, 01/16/12,
+****************************************************************************/
+bool ES_PostToService( uint8_t WhichService, ES_Event TheEvent){
+  bool Posted;
+  uint32_t Saved;
+
+  if (WhichService >= ARRAY_SIZE(EventQueues))
+    return false;
+  Saved = ES_EnterCritical();
+  Posted = ES_EnQueueFIFONoLock( EventQueues[WhichService].pMem, TheEvent);
+  if ( Posted )
+    MarkReady( BitNum2SetMask[WhichService]); // show queue as non-empty
+  ES_ExitCritical(Saved);
+  return Posted;
+}
+
+/****************************************************************************
+ Function
+   ES_PostToServiceLIFO
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if the post function failed during execution
+ Description
+   Posts, using LIFO strategy, to one of the services' queues
+ Notes
+   used by the Defer/Recall event capability
+ Author
+   J. Edward Carryer, 11/02/13
+****************************************************************************/
+bool ES_PostToServiceLIFO( uint8_t WhichService, ES_Event TheEvent){
+  bool Posted;
+  uint32_t Saved;
+
+  if (WhichService >= ARRAY_SIZE(EventQueues))
+    return false;
+  Saved = ES_EnterCritical();
+  Posted = ES_EnQueueLIFONoLock( EventQueues[WhichService].pMem, TheEvent);
+  if ( Posted )
+    MarkReady( BitNum2SetMask[WhichService]); // show queue as non-empty
+  ES_ExitCritical(Saved);
+  return Posted;
+}
+
+/****************************************************************************
+ Function
+   ES_SpliceToService
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event * : a queue of events for the service, usually deferred ones
+ Returns
+   uint8_t : the number of events moved, the ones that did not fit stay
+             in the source queue
+ Description
+   moves the events to the front of the service's queue in their order,
+   all in one critical region
+ Notes
+   used by ES_RecallEvents
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint8_t ES_SpliceToService( uint8_t WhichService, ES_Event * pBlock){
+  uint8_t NumMoved;
+  uint32_t Saved;
+
+  if (WhichService >= ARRAY_SIZE(EventQueues))
+    return 0;
+  Saved = ES_EnterCritical();
+  NumMoved = ES_SpliceToFront( EventQueues[WhichService].pMem, pBlock);
+  if ( NumMoved != 0 )
+    MarkReady( BitNum2SetMask[WhichService]); // show queue as non-empty
+  ES_ExitCritical(Saved);
+  return NumMoved;
+}
+
+/****************************************************************************
+ Function
+   ES_Subscribe
+ Parameters
+   uint8_t : Which service (its priority, as passed to its init function)
+   ES_EventTyp_t : the event type it wants from ES_Publish
+ Returns
+   boolean : False if either argument is out of range
+ Description
+   adds the service to the subscriber mask for the event type
+ Notes
+   normally called from the service's init function
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+bool ES_Subscribe( uint8_t WhichService, ES_EventTyp_t EventType){
+  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
+      (EventType < NUM_ES_EVENT_TYPES)){
+    Subscribers[EventType] |= BitNum2SetMask[WhichService];
+    return true;
+  } else
+    return false;
+}
+
+/****************************************************************************
+ Function
+   ES_Unsubscribe
+ Parameters
+   uint8_t : Which service
+   ES_EventTyp_t : the event type it no longer wants
+ Returns
+   boolean : False if either argument is out of range
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+bool ES_Unsubscribe( uint8_t WhichService, ES_EventTyp_t EventType){
+  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
+      (EventType < NUM_ES_EVENT_TYPES)){
+    Subscribers[EventType] &= BitNum2ClrMask[WhichService];
+    return true;
+  } else
+    return false;
+}
+
+/****************************************************************************
+ Function
+   ES_Publish
+ Parameters
+   ES_Event : The Event to be posted
+ Returns
+   uint16_t : bit n set if subscriber n's queue was full, 0 if all got it
+ Description
+   posts to every service subscribed to the event's type
+ Notes
+   a failed subscriber does not stop the others from getting the event.
+   Do not publish pool blocks, a block has only one owner
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint16_t ES_Publish( ES_Event ThisEvent){
+  if ( ThisEvent.EventType >= NUM_ES_EVENT_TYPES )
+    return 0;
+  return ES_PostToMask( Subscribers[ThisEvent.EventType], ThisEvent);
+}
+
+/****************************************************************************
+ Function
+   ES_PostToMask
+ Parameters
+   uint16_t : bit n set for each service n to post to
+   ES_Event : The Event to be posted
+ Returns
+   uint16_t : the bits of ServiceMask that could not be posted to, either
+              because the queue was full or there is no such service
+ Description
+   posts to a set of services in one critical region and marks them all
+   ready with a single OR into Ready
+ Notes
+   interrupts are off for one enqueue per service in the mask
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint16_t ES_PostToMask( uint16_t ServiceMask, ES_Event ThisEvent){
+  uint16_t Remaining = ServiceMask & ALL_SERVICES_MASK;
+  uint16_t Posted = 0;
+  uint8_t i;
+  uint32_t Saved;
+
+  Saved = ES_EnterCritical();   // save interrupt state, mask the framework ints
+  while ( Remaining != 0 ){
+    i = ES_GetMSBitSet( Remaining);
+    Remaining &= BitNum2ClrMask[i];
+    if ( ES_EnQueueFIFONoLock( EventQueues[i].pMem, ThisEvent) == true )
+      Posted |= BitNum2SetMask[i];
+  }
+  MarkReady( Posted); // show all the queues that got it as non-empty
+  ES_ExitCritical( Saved);  // restore saved interrupt state
+  return ServiceMask & ~Posted;
+}
+
+//*********************************
+// private functions
+//*********************************
+/****************************************************************************
+ Function
+   MarkReady
+ Parameters
+   uint16_t : the services that were just posted to
+ Description
+   marks their queues non-empty, notes the time of the first post to
+   each band that was idle and triggers the band interrupts
+ Notes
+   call inside a critical region
+****************************************************************************/
+static void MarkReady( uint16_t Posted ){
+  uint8_t Band;
+
+  Ready |= Posted;
+  for ( Band=0; Band< ES_NUM_BANDS; Band++) {
+    if ( (Posted & BandMask[Band]) != 0 ){
+      if ( (Kicked & BitNum2SetMask[Band]) == 0 ){
+        Kicked |= BitNum2SetMask[Band];
+        KickedAt[Band] = HWREG(DWT_CYCCNT);
+      }
+#if ES_PREEMPTIVE
+      if ( Band != 0 )
+        ES_BandTrigger( Band);
+#endif
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+   RunHighest
+ Parameters
+   uint8_t : which band, it must have a service with a non-empty queue
+ Returns
+   boolean : False if the run function failed
+ Description
+   takes the next event for the highest priority ready service in the
+   band and runs the service with it
+****************************************************************************/
+ES_RAMFUNC static bool RunHighest( uint8_t Band ){
+  uint8_t HighestPrior;
+  uint32_t Cycles;
+  uint32_t Saved;
+  ES_Event ThisEvent;
+
+  // a higher band may post, and clear its own Ready bits, at any time
+  Saved = ES_EnterCritical();
+  HighestPrior = ES_GetMSBitSet( Ready & BandMask[Band]);
+  if ( ES_DeQueue( EventQueues[HighestPrior].pMem, &ThisEvent ) == 0 ){
+    Ready &= BitNum2ClrMask[HighestPrior]; // mark queue as now empty
+  }
+  BandStats[Band].Runs++;
+  if ( (Kicked & BitNum2SetMask[Band]) != 0 ){
+    Kicked &= BitNum2ClrMask[Band];
+    Cycles = HWREG(DWT_CYCCNT) - KickedAt[Band];
+    BandStats[Band].LastCycles = Cycles;
+    if ( Cycles > BandStats[Band].MaxCycles )
+      BandStats[Band].MaxCycles = Cycles;
+  }
+  ES_ExitCritical(Saved);
+
+  if( ServDescList[HighestPrior].RunFunc(ThisEvent).EventType != 
+                                                          ES_NO_EVENT) {
+    return false;
+  }
+  // a payload block delivered by this event goes back to the pool
+  ES_PoolRunDone( HighestPrior, ThisEvent );
+  return true;
+}
+
+#if 0
+/****************************************************************************
+ Function
+   CheckSystemEvents
+ Parameters
+   None
+ Returns
+   boolean : True if a system event was detected
+ Description
+   check for system generated events and uses pPostKeyFunc to post to one
+   of the state machine's queues
+ Notes
+   currently only tests for incoming keystrokes
+ Author
+   J. Edward Carryer, 10/23/11, 
+****************************************************************************/
+static bool CheckSystemEvents( void ){
+  
+  if ( kbhit() != 0 ) // new key waiting?
+  {
+    ES_Event ThisEvent;
+    ThisEvent.EventType = ES_NEW_KEY;
+    ThisEvent.EventParam = getchar();
+    (*pPostKeyFunc)( ThisEvent );
+    return true;
+  }
+  return false;
+}
+#endif
+
+#ifdef TEST
+/* fan-out benchmark, run on the target. One event goes to every service,
+   first the way ES_PostList does it (a post function per service, each
+   enqueue in its own critical region and its own update of Ready) and then
+   by ES_Publish with every service subscribed. The queues are emptied
+   after every round so all the posts succeed, and the DWT cycle counter
+   times both. The broadcast is timed the same way, against the old
+   ES_PostAll loop. Only the queues are used, no service is initialized.
+*/
+#include "driverlib/sysctl.h"
+#include "termio.h"
+
+#define TEST_ROUNDS 1000
+
+// what a service's PostXxx function does
+#define TEST_POST_FUNC(n) \
+  static bool PostQ##n( ES_Event ThisEvent) { return ES_PostToService( n, ThisEvent); }
+TEST_POST_FUNC(0)  TEST_POST_FUNC(1)  TEST_POST_FUNC(2)  TEST_POST_FUNC(3)
+TEST_POST_FUNC(4)  TEST_POST_FUNC(5)  TEST_POST_FUNC(6)  TEST_POST_FUNC(7)
+TEST_POST_FUNC(8)  TEST_POST_FUNC(9)  TEST_POST_FUNC(10) TEST_POST_FUNC(11)
+TEST_POST_FUNC(12) TEST_POST_FUNC(13) TEST_POST_FUNC(14) TEST_POST_FUNC(15)
+
+static PostFunc_t * const TestList[MAX_NUM_SERVICES] = {
+  PostQ0, PostQ1, PostQ2, PostQ3, PostQ4, PostQ5, PostQ6, PostQ7,
+  PostQ8, PostQ9, PostQ10, PostQ11, PostQ12, PostQ13, PostQ14, PostQ15
+};
+
+// the loop in ES_PostList.c
+static bool TestPostToList( ES_Event NewEvent){
+  uint8_t i;
+  for ( i=0; i< NUM_SERVICES; i++) {
+    if ( TestList[i](NewEvent) != true )
+      break;
+  }
+  return ( i == NUM_SERVICES );
+}
+
+// ES_PostAll before it was built on ES_PostToMask
+static bool TestOldPostAll( ES_Event ThisEvent){
+  uint8_t i;
+  for ( i=0; i< ARRAY_SIZE(EventQueues); i++) {
+    if ( ES_EnQueueFIFO( EventQueues[i].pMem, ThisEvent ) != true ){
+      break;
+    }else{
+      Ready |= BitNum2SetMask[i];
+    }
+  }
+  return ( i == ARRAY_SIZE(EventQueues) );
+}
+
+static void EmptyQueues( void ){
+  uint8_t i;
+  for ( i=0; i< ARRAY_SIZE(EventQueues); i++)
+    ES_InitQueue( EventQueues[i].pMem, EventQueues[i].Size );
+  Ready = 0;
+}
+
+int main( void ){
+  ES_Event ThisEvent;
+  uint32_t Start;
+  uint32_t ListCycles = 0;
+  uint32_t PublishCycles = 0;
+  uint32_t OldAllCycles = 0;
+  uint32_t AllCycles = 0;
+  uint16_t Failed = 0;
+  uint16_t i;
+
+  SysCtlClockSet(CPU_CLOCK_SYSCTL);
+  TERMIO_Init();
+  ES_CycleCounterStart();
+  HWREG(DWT_CYCCNT) = 0;
+
+  ThisEvent.EventType = ES_NEW_KEY;
+  ThisEvent.EventParam = 'x';
+  for ( i=0; i< NUM_SERVICES; i++)
+    ES_Subscribe( i, ES_NEW_KEY);
+
+  for ( i=0; i< TEST_ROUNDS; i++) {
+    EmptyQueues();
+    Start = HWREG(DWT_CYCCNT);
+    TestPostToList( ThisEvent);
+    ListCycles += HWREG(DWT_CYCCNT) - Start;
+
+    EmptyQueues();
+    Start = HWREG(DWT_CYCCNT);
+    Failed |= ES_Publish( ThisEvent);
+    PublishCycles += HWREG(DWT_CYCCNT) - Start;
+    if ( Ready != ALL_SERVICES_MASK )
+      Failed |= ALL_SERVICES_MASK & ~Ready;
+
+    EmptyQueues();
+    Start = HWREG(DWT_CYCCNT);
+    TestOldPostAll( ThisEvent);
+    OldAllCycles += HWREG(DWT_CYCCNT) - Start;
+
+    EmptyQueues();
+    Start = HWREG(DWT_CYCCNT);
+    Failed |= ES_PostAllMask( ThisEvent);
+    AllCycles += HWREG(DWT_CYCCNT) - Start;
+  }
+
+  printf("\r\nfan-out to %d services, %d rounds\r\n", NUM_SERVICES, TEST_ROUNDS);
+  printf("post list  %lu cycles/event\r\n", (unsigned long)(ListCycles/TEST_ROUNDS));
+  printf("ES_Publish %lu cycles/event\r\n", (unsigned long)(PublishCycles/TEST_ROUNDS));
+  printf("old ES_PostAll %lu cycles/event\r\n", (unsigned long)(OldAllCycles/TEST_ROUNDS));
+  printf("ES_PostAllMask %lu cycles/event\r\n", (unsigned long)(AllCycles/TEST_ROUNDS));
+  printf("failed mask %04x\r\n", Failed);
+  for (;;)
+    ;
+}
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
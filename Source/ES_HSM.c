@@ -0,0 +1,330 @@
+/****************************************************************************
+ Module
+     ES_HSM.c
+ Description
+     Table driven hierarchical state machine engine. The tables are built
+     at compile time by the macros in ES_HSM.h; this module walks them.
+ Notes
+     Dispatching an event looks up [current state][event type]. If that
+     state does not handle the event the lookup is repeated for its parent,
+     and so on up to the top. A transition exits from the current state up
+     to the least common ancestor of the source and target, runs the
+     transition action, then enters down to the target. A transition to
+     the source itself, or to one of its ancestors, exits and re-enters
+     the target.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 16:40 t16      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_HSM.h"
+
+/*---------------------------- Module Functions ---------------------------*/
+static uint8_t Depth( ES_HSM_t const *pHSM, uint8_t State );
+static uint8_t CommonAncestor( ES_HSM_t const *pHSM, uint8_t A, uint8_t B );
+static void ExitUpTo( ES_HSM_t const *pHSM, uint8_t From, uint8_t Stop );
+static void EnterDownTo( ES_HSM_t const *pHSM, uint8_t Stop, uint8_t To );
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_HSM_Start
+ Parameters
+   ES_HSM_t *pHSM : the machine, set up with ES_HSM_INIT
+   uint8_t Initial : the state to start in
+ Returns
+   nothing
+ Description
+   runs the entry actions from the top level down to Initial
+ Notes
+
+*****************************************************************************/
+void ES_HSM_Start( ES_HSM_t *pHSM, uint8_t Initial )
+{
+  EnterDownTo( pHSM, ES_HSM_NO_PARENT, Initial);
+  pHSM->Current = Initial;
+}
+
+/****************************************************************************
+ Function
+   ES_HSM_Dispatch
+ Parameters
+   ES_HSM_t *pHSM : the machine
+   ES_Event ThisEvent : the event to run through it
+ Returns
+   bool : true if some state handled the event
+ Description
+   looks the event up from the current state outwards and takes the first
+   transition found
+ Notes
+
+*****************************************************************************/
+bool ES_HSM_Dispatch( ES_HSM_t *pHSM, ES_Event ThisEvent )
+{
+  ES_HSMTransition_t const *pTrans;
+  uint8_t Source = pHSM->Current;
+  uint8_t Stop;
+
+  if ( ThisEvent.EventType >= NUM_ES_EVENT_TYPES )
+    return false;
+
+  while ( Source != ES_HSM_NO_PARENT )
+  {
+    pTrans = &pHSM->pTable[Source*NUM_ES_EVENT_TYPES + ThisEvent.EventType];
+    if ( pTrans->Handled )
+    {
+      if ( pTrans->Next == ES_HSM_INTERNAL )
+      {
+        if ( pTrans->pAction != 0 )
+          pTrans->pAction( ThisEvent );
+        return true;
+      }
+      Stop = CommonAncestor( pHSM, Source, pTrans->Next);
+      // self and outward transitions leave and re-enter the target
+      if ( Stop == pTrans->Next )
+        Stop = pHSM->pStates[Stop].Parent;
+      ExitUpTo( pHSM, pHSM->Current, Stop);
+      if ( pTrans->pAction != 0 )
+        pTrans->pAction( ThisEvent );
+      EnterDownTo( pHSM, Stop, pTrans->Next);
+      pHSM->Current = pTrans->Next;
+      return true;
+    }
+    Source = pHSM->pStates[Source].Parent;
+  }
+  return false;
+}
+
+/****************************************************************************
+ Function
+   ES_HSM_GetState
+ Returns
+   uint8_t : the current (leaf) state
+*****************************************************************************/
+uint8_t ES_HSM_GetState( ES_HSM_t const *pHSM )
+{
+  return pHSM->Current;
+}
+
+/****************************************************************************
+ Function
+   ES_HSM_IsIn
+ Returns
+   bool : true if State is the current state or one of its ancestors
+*****************************************************************************/
+bool ES_HSM_IsIn( ES_HSM_t const *pHSM, uint8_t State )
+{
+  uint8_t Walk = pHSM->Current;
+
+  while ( Walk != ES_HSM_NO_PARENT )
+  {
+    if ( Walk == State )
+      return true;
+    Walk = pHSM->pStates[Walk].Parent;
+  }
+  return false;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+// number of ancestors above a state
+static uint8_t Depth( ES_HSM_t const *pHSM, uint8_t State )
+{
+  uint8_t Levels = 0;
+
+  while ( (State != ES_HSM_NO_PARENT) && (Levels < ES_HSM_MAX_DEPTH) )
+  {
+    State = pHSM->pStates[State].Parent;
+    Levels++;
+  }
+  return Levels;
+}
+
+// innermost state containing both A and B, ES_HSM_NO_PARENT if none
+static uint8_t CommonAncestor( ES_HSM_t const *pHSM, uint8_t A, uint8_t B )
+{
+  uint8_t DepthA = Depth( pHSM, A);
+  uint8_t DepthB = Depth( pHSM, B);
+
+  while ( DepthA > DepthB )
+  {
+    A = pHSM->pStates[A].Parent;
+    DepthA--;
+  }
+  while ( DepthB > DepthA )
+  {
+    B = pHSM->pStates[B].Parent;
+    DepthB--;
+  }
+  while ( A != B )
+  {
+    A = pHSM->pStates[A].Parent;
+    B = pHSM->pStates[B].Parent;
+  }
+  return A;
+}
+
+// run exit actions from From outwards, not including Stop
+static void ExitUpTo( ES_HSM_t const *pHSM, uint8_t From, uint8_t Stop )
+{
+  while ( From != Stop )
+  {
+    if ( pHSM->pStates[From].pExit != 0 )
+      pHSM->pStates[From].pExit();
+    From = pHSM->pStates[From].Parent;
+  }
+}
+
+// run entry actions from just inside Stop down to To
+static void EnterDownTo( ES_HSM_t const *pHSM, uint8_t Stop, uint8_t To )
+{
+  uint8_t Path[ES_HSM_MAX_DEPTH];
+  uint8_t Levels = 0;
+
+  while ( (To != Stop) && (Levels < ES_HSM_MAX_DEPTH) )
+  {
+    Path[Levels++] = To;
+    To = pHSM->pStates[To].Parent;
+  }
+  while ( Levels > 0 )
+  {
+    Levels--;
+    if ( pHSM->pStates[Path[Levels]].pEntry != 0 )
+      pHSM->pStates[Path[Levels]].pEntry();
+  }
+}
+
+#ifdef TEST
+/* test harness and benchmark, run on the target. The same three state
+   machine is written with the engine and as a switch per state, both are
+   fed the same event stream, the results are checked against each other
+   and the cycles per dispatch are counted with the DWT cycle counter.
+   Flash for the switch version comes from the map file, the tables are
+   reported with sizeof.
+*/
+#include <stdio.h>
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "ES_Port.h"
+#include "termio.h"
+
+#define TEST_EVENTS 10000
+
+static uint16_t Actions;
+static uint16_t Entries;
+
+static void CountAction( ES_Event ThisEvent ) { Actions++; }
+static void CountEntry( void ) { Entries++; }
+
+// Top contains Idle and Busy; a timeout in Idle starts work, a key in
+// Busy finishes it, and a timeout anywhere else is handled by Top
+#define TEST_STATES(STATE) \
+  STATE(TestTop,  ES_HSM_NO_PARENT, 0,          0) \
+  STATE(TestIdle, TestTop,          CountEntry, 0) \
+  STATE(TestBusy, TestTop,          CountEntry, 0)
+
+#define TEST_TRANSITIONS(TRANS) \
+  TRANS(TestIdle, ES_TIMEOUT, CountAction, TestBusy) \
+  TRANS(TestBusy, ES_NEW_KEY, CountAction, TestIdle) \
+  TRANS(TestTop,  ES_TIMEOUT, CountAction, ES_HSM_INTERNAL)
+
+ES_HSM_STATES(Test, TEST_STATES)
+ES_HSM_TABLES(Test, TEST_STATES, TEST_TRANSITIONS)
+static ES_HSM_t TestHSM = ES_HSM_INIT(Test);
+
+// the same machine the way the services are written today
+static TestState_t SwitchState;
+
+static bool SwitchDispatch( ES_Event ThisEvent )
+{
+  switch ( SwitchState )
+  {
+    case TestIdle:
+      if ( ThisEvent.EventType == ES_TIMEOUT )
+      {
+        CountAction( ThisEvent );
+        SwitchState = TestBusy;
+        CountEntry();
+        return true;
+      }
+      break;
+    case TestBusy:
+      if ( ThisEvent.EventType == ES_NEW_KEY )
+      {
+        CountAction( ThisEvent );
+        SwitchState = TestIdle;
+        CountEntry();
+        return true;
+      }
+      if ( ThisEvent.EventType == ES_TIMEOUT )
+      {
+        CountAction( ThisEvent );
+        return true;
+      }
+      break;
+    default:
+      break;
+  }
+  return false;
+}
+
+int main( void )
+{
+  ES_Event Stream[4];
+  uint32_t Start;
+  uint32_t HSMCycles;
+  uint32_t SwitchCycles;
+  uint16_t HSMActions, HSMEntries;
+  uint16_t i;
+  bool Match = true;
+
+  SysCtlClockSet(CPU_CLOCK_SYSCTL);
+  TERMIO_Init();
+  ES_CycleCounterStart();
+  HWREG(DWT_CYCCNT) = 0;
+
+  // a mix of handled, inherited and ignored events
+  Stream[0].EventType = ES_TIMEOUT;
+  Stream[1].EventType = ES_TIMEOUT;
+  Stream[2].EventType = ES_NEW_KEY;
+  Stream[3].EventType = ES_INIT;
+
+  ES_HSM_Start( &TestHSM, TestIdle);
+  SwitchState = TestIdle;
+  for ( i = 0; i < 16; i++ )
+  {
+    ES_HSM_Dispatch( &TestHSM, Stream[i & 3]);
+    SwitchDispatch( Stream[i & 3]);
+    Match &= (ES_HSM_GetState( &TestHSM) == SwitchState);
+  }
+
+  Actions = Entries = 0;
+  Start = HWREG(DWT_CYCCNT);
+  for ( i = 0; i < TEST_EVENTS; i++ )
+    ES_HSM_Dispatch( &TestHSM, Stream[i & 3]);
+  HSMCycles = HWREG(DWT_CYCCNT) - Start;
+  HSMActions = Actions;
+  HSMEntries = Entries;
+
+  Actions = Entries = 0;
+  Start = HWREG(DWT_CYCCNT);
+  for ( i = 0; i < TEST_EVENTS; i++ )
+    SwitchDispatch( Stream[i & 3]);
+  SwitchCycles = HWREG(DWT_CYCCNT) - Start;
+  Match &= (HSMActions == Actions) && (HSMEntries == Entries);
+
+  printf("\r\nES_HSM benchmark, %d events\r\n", TEST_EVENTS);
+  printf("results %s\r\n", Match ? "match" : "DIFFER");
+  printf("table dispatch  %lu cycles/event\r\n", (unsigned long)(HSMCycles/TEST_EVENTS));
+  printf("switch dispatch %lu cycles/event\r\n", (unsigned long)(SwitchCycles/TEST_EVENTS));
+  printf("tables %u bytes const\r\n",
+         (unsigned)(sizeof(TestStates) + sizeof(TestTable)));
+  for (;;)
+    ;
+}
+#endif
+/*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,225 @@
+/****************************************************************************
+ Module
+     ES_IsrProfile.c
+ Description
+     Per ISR invocation counts, time from entry to exit and latency from
+     the hardware event, for the ISRs in ES_IsrId_t
+ Notes
+     An ISR never interrupts itself, so each entry in Stats is written by
+     one ISR only and needs no lock there. Readers copy it out with every
+     interrupt off, since the safety ISRs are profiled too.
+     The latency is measured from the hardware count the ISR read, less the
+     time since ES_ISR_ENTRY, so it is short by the few cycles between the
+     ISR's read of its timer and ES_IsrLatency's read of the cycle counter.
+     The entry, latency and exit hooks run from SRAM with ES_RAM_CODE, like
+     the ES_RAMFUNC ISRs that call them.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16      ISR hooks in SRAM with ES_RAM_CODE
+ 10/19/26 23:40 t16      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_IsrProfile.h"
+#include "inc/hw_types.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+static ES_IsrStats_t Stats[NUM_ES_ISRS];
+static uint32_t EnteredAt[NUM_ES_ISRS];
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_IsrProfileInit
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   clears the stats. Called from ES_Initialize once the cycle counter runs
+****************************************************************************/
+void ES_IsrProfileInit( void )
+{
+  ES_ClearIsrStats();
+}
+
+/****************************************************************************
+ Function
+   ES_IsrEntry
+ Parameters
+   ES_IsrId_t Id : the ISR being entered
+ Returns
+   nothing
+ Description
+   through ES_ISR_ENTRY, the first thing in the ISR
+****************************************************************************/
+ES_RAMFUNC void ES_IsrEntry( ES_IsrId_t Id )
+{
+  if ( Id < NUM_ES_ISRS )
+    EnteredAt[Id] = HWREG(DWT_CYCCNT);
+}
+
+/****************************************************************************
+ Function
+   ES_IsrLatency
+ Parameters
+   ES_IsrId_t Id : the ISR
+   uint32_t SinceEvent : CPU cycles from the hardware event to now, from
+     the ISR's own timer
+ Returns
+   nothing
+ Description
+   through ES_ISR_LATENCY, anywhere between the entry and the exit
+****************************************************************************/
+ES_RAMFUNC void ES_IsrLatency( ES_IsrId_t Id, uint32_t SinceEvent )
+{
+  uint32_t SinceEntry;
+  uint32_t Latency;
+
+  if ( Id >= NUM_ES_ISRS )
+    return;
+  SinceEntry = HWREG(DWT_CYCCNT) - EnteredAt[Id];
+  Latency = (SinceEvent > SinceEntry) ? (SinceEvent - SinceEntry) : 0;
+  Stats[Id].Latencies++;
+  if ( Latency > Stats[Id].MaxLatency )
+    Stats[Id].MaxLatency = Latency;
+}
+
+/****************************************************************************
+ Function
+   ES_IsrExit
+ Parameters
+   ES_IsrId_t Id : the ISR being left
+ Returns
+   nothing
+ Description
+   through ES_ISR_EXIT, the last thing in the ISR
+****************************************************************************/
+ES_RAMFUNC void ES_IsrExit( ES_IsrId_t Id )
+{
+  uint32_t Cycles;
+
+  if ( Id >= NUM_ES_ISRS )
+    return;
+  Cycles = HWREG(DWT_CYCCNT) - EnteredAt[Id];
+  Stats[Id].Count++;
+  Stats[Id].TotalCycles += Cycles;
+  if ( Cycles > Stats[Id].MaxCycles )
+    Stats[Id].MaxCycles = Cycles;
+}
+
+/****************************************************************************
+ Function
+   ES_GetIsrStats
+ Parameters
+   ES_IsrId_t Id : which ISR
+   ES_IsrStats_t *pStats : filled with its stats so far
+ Returns
+   nothing
+****************************************************************************/
+void ES_GetIsrStats( ES_IsrId_t Id, ES_IsrStats_t *pStats )
+{
+  uint32_t Saved;
+
+  if ( Id >= NUM_ES_ISRS )
+    return;
+  Saved = ES_EnterCriticalAll();
+  *pStats = Stats[Id];
+  ES_ExitCriticalAll(Saved);
+}
+
+/****************************************************************************
+ Function
+   ES_IsrAverageCycles
+ Parameters
+   ES_IsrStats_t const *pStats : as filled by ES_GetIsrStats
+ Returns
+   uint32_t : mean entry to exit cycles, 0 if the ISR has not run
+****************************************************************************/
+uint32_t ES_IsrAverageCycles( ES_IsrStats_t const *pStats )
+{
+  if ( pStats->Count == 0 )
+    return 0;
+  return (uint32_t)(pStats->TotalCycles / pStats->Count);
+}
+
+/****************************************************************************
+ Function
+   ES_ClearIsrStats
+ Parameters
+   None
+ Returns
+   nothing
+****************************************************************************/
+void ES_ClearIsrStats( void )
+{
+  uint32_t Saved;
+  uint8_t i;
+
+  Saved = ES_EnterCriticalAll();
+  for ( i = 0; i < NUM_ES_ISRS; i++ )
+  {
+    Stats[i].Count = 0;
+    Stats[i].TotalCycles = 0;
+    Stats[i].MaxCycles = 0;
+    Stats[i].Latencies = 0;
+    Stats[i].MaxLatency = 0;
+  }
+  ES_ExitCriticalAll(Saved);
+}
+
+/* target test: the cost of the profiling itself. An empty ISR body is
+   bracketed TEST_ROUNDS times, which is the floor every profiled ISR's
+   numbers sit on, and a latency of a known count is checked to come back
+   within the call overhead.
+*/
+#ifdef TEST
+#include <stdio.h>
+#include "driverlib/sysctl.h"
+#include "termio.h"
+
+#define TEST_ROUNDS 1000
+
+int main( void )
+{
+  ES_IsrStats_t Results;
+  uint32_t Start;
+  uint32_t Entered;
+  uint32_t i;
+
+  SysCtlClockSet(CPU_CLOCK_SYSCTL);
+  TERMIO_Init();
+  ES_CycleCounterStart();
+  ES_IsrProfileInit();
+
+  Start = HWREG(DWT_CYCCNT);
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    ES_ISR_ENTRY(ISR_SYSTICK);
+    ES_ISR_EXIT(ISR_SYSTICK);
+  }
+  Start = (HWREG(DWT_CYCCNT) - Start)/TEST_ROUNDS;
+  ES_GetIsrStats(ISR_SYSTICK, &Results);
+  printf("\r\nentry/exit pair: %lu cycles, empty ISR reads %lu avg %lu max\r\n",
+      (unsigned long)Start, (unsigned long)ES_IsrAverageCycles(&Results),
+      (unsigned long)Results.MaxCycles);
+
+  // an event 1000 cycles before the entry
+  Entered = HWREG(DWT_CYCCNT);
+  ES_ISR_ENTRY(ISR_TAPE);
+  ES_ISR_LATENCY(ISR_TAPE, 1000 + (HWREG(DWT_CYCCNT) - Entered));
+  ES_ISR_EXIT(ISR_TAPE);
+  ES_GetIsrStats(ISR_TAPE, &Results);
+  printf("latency of 1000 read back as %lu (%lu samples)\r\n",
+      (unsigned long)Results.MaxLatency, (unsigned long)Results.Latencies);
+
+  for(;;)
+    ;
+}
+#endif
+/*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,523 @@
+/****************************************************************************
+ Module
+     ES_Pool.c
+ Description
+     Fixed block memory pool for zero copy payloads. ES_POOL_NUM_BLOCKS
+     blocks of ES_POOL_BLOCK_SIZE bytes, configured in ES_Configure.h
+ Notes
+     The free blocks form a singly linked list threaded through NextFree,
+     so alloc and free are a pop and a push. Both run in a critical region
+     for a handful of instructions, saving the previous mask locally so
+     they can be called from ISRs and from inside other critical regions.
+
+     A block moves ALLOCATED -> POSTED (ES_PostBlock) -> FREE when the
+     receiver's run function returns, or POSTED -> RETAINED if the
+     receiver keeps it, and then to FREE on ES_PoolFree.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16      retain, post and run done guarded like alloc/free
+ 10/19/26 23:00 t16      BASEPRI critical regions
+ 10/19/26 20:10 t16      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Pool.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define END_OF_LIST 0xff
+
+#define HANDLE_INDEX(h) ((uint8_t)((h) & 0xff) - 1)
+#define HANDLE_GEN(h)   ((uint8_t)((h) >> 8))
+
+#if ES_POOL_NUM_BLOCKS > 254
+#error ES_POOL_NUM_BLOCKS must fit the low byte of a handle
+#endif
+
+typedef enum { BlockFree, BlockAllocated, BlockPosted, BlockRetained
+} BlockState_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+static bool LookUp( ES_PoolHandle_t Handle, uint8_t *pIndex );
+
+/*---------------------------- Module Variables ---------------------------*/
+// words, so a block can hold any type
+static uint32_t Blocks[ES_POOL_NUM_BLOCKS][(ES_POOL_BLOCK_SIZE + 3)/4];
+
+static uint8_t NextFree[ES_POOL_NUM_BLOCKS];
+static uint8_t FreeHead;
+
+static uint8_t State[ES_POOL_NUM_BLOCKS];
+static uint8_t Generation[ES_POOL_NUM_BLOCKS];
+// who the block was posted to and as what, so ES_PoolRunDone only frees
+// it after the run function that received it
+static uint8_t Owner[ES_POOL_NUM_BLOCKS];
+static ES_EventTyp_t PostedAs[ES_POOL_NUM_BLOCKS];
+
+static ES_PoolStats_t Stats;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_PoolInit
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   puts every block on the free list. Called from ES_Initialize
+****************************************************************************/
+void ES_PoolInit( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < ES_POOL_NUM_BLOCKS; i++ )
+  {
+    NextFree[i] = i + 1;
+    State[i] = BlockFree;
+  }
+  NextFree[ES_POOL_NUM_BLOCKS - 1] = END_OF_LIST;
+  FreeHead = 0;
+  Stats.InUse = 0;
+  ES_PoolClearStats();
+}
+
+/****************************************************************************
+ Function
+   ES_PoolAlloc
+ Parameters
+   None
+ Returns
+   ES_PoolHandle_t : the block, ES_POOL_NO_BLOCK if the pool is empty
+ Description
+   O(1), ISR safe
+****************************************************************************/
+ES_PoolHandle_t ES_PoolAlloc( void )
+{
+  uint32_t Saved;
+  uint8_t Index;
+  ES_PoolHandle_t Handle = ES_POOL_NO_BLOCK;
+
+  Saved = ES_EnterCritical();
+  Index = FreeHead;
+  if ( Index != END_OF_LIST )
+  {
+    FreeHead = NextFree[Index];
+    State[Index] = BlockAllocated;
+    Generation[Index]++;
+    Handle = ((ES_PoolHandle_t)Generation[Index] << 8) | (Index + 1);
+    Stats.Allocs++;
+    if ( ++Stats.InUse > Stats.HighWater )
+      Stats.HighWater = Stats.InUse;
+  }
+  else
+  {
+    Stats.Exhausted++;
+  }
+  ES_ExitCritical(Saved);
+  return Handle;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolData
+ Parameters
+   ES_PoolHandle_t Handle : a live block
+ Returns
+   void * : the block's ES_POOL_BLOCK_SIZE bytes, 0 for a stale handle
+****************************************************************************/
+void * ES_PoolData( ES_PoolHandle_t Handle )
+{
+  uint8_t Index;
+
+  if ( LookUp( Handle, &Index ) )
+    return Blocks[Index];
+  return 0;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolFree
+ Parameters
+   ES_PoolHandle_t Handle : block to return to the pool
+ Returns
+   bool : false if the handle was not live, nothing is freed then
+ Description
+   O(1), ISR safe
+****************************************************************************/
+bool ES_PoolFree( ES_PoolHandle_t Handle )
+{
+  uint32_t Saved;
+  uint8_t Index;
+  bool ReturnVal = false;
+
+  Saved = ES_EnterCritical();
+  if ( LookUp( Handle, &Index ) )
+  {
+    State[Index] = BlockFree;
+    NextFree[Index] = FreeHead;
+    FreeHead = Index;
+    Stats.Frees++;
+    Stats.InUse--;
+    ReturnVal = true;
+  }
+  else
+  {
+    Stats.BadHandles++;
+  }
+  ES_ExitCritical(Saved);
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolRetain
+ Parameters
+   ES_PoolHandle_t Handle : block received in the event being run
+ Returns
+   bool : false if the handle was not live
+ Description
+   called from a run function to keep the block past the end of the run,
+   for example to defer the event. The service must ES_PoolFree it later
+****************************************************************************/
+bool ES_PoolRetain( ES_PoolHandle_t Handle )
+{
+  uint32_t Saved;
+  uint8_t Index;
+  bool ReturnVal = false;
+
+  Saved = ES_EnterCritical();
+  if ( LookUp( Handle, &Index ) )
+  {
+    State[Index] = BlockRetained;
+    ReturnVal = true;
+  }
+  else
+  {
+    Stats.BadHandles++;
+  }
+  ES_ExitCritical(Saved);
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   ES_PostBlock
+ Parameters
+   uint8_t WhichService : service to hand the block to
+   ES_EventTyp_t Type : event type to post, the handle is the EventParam
+   ES_PoolHandle_t Handle : block from ES_PoolAlloc
+ Returns
+   bool : false if the post failed, the block has been freed then
+ Description
+   ownership passes with the post, the caller must not touch the block
+   afterwards
+****************************************************************************/
+bool ES_PostBlock( uint8_t WhichService, ES_EventTyp_t Type,
+                   ES_PoolHandle_t Handle )
+{
+  ES_Event ThisEvent;
+  uint32_t Saved;
+  uint8_t Index;
+
+  Saved = ES_EnterCritical();
+  if ( !LookUp( Handle, &Index ) )
+  {
+    Stats.BadHandles++;
+    ES_ExitCritical(Saved);
+    return false;
+  }
+  Owner[Index] = WhichService;
+  PostedAs[Index] = Type;
+  State[Index] = BlockPosted;
+  ES_ExitCritical(Saved);
+
+  ThisEvent.EventType = Type;
+  ThisEvent.EventParam = Handle;
+  ES_EventSetTime( &ThisEvent, 0 );
+  if ( ES_PostToService( WhichService, ThisEvent ) )
+    return true;
+
+  ES_PoolFree( Handle );
+  return false;
+}
+
+/****************************************************************************
+ Function
+   ES_PoolRunDone
+ Parameters
+   uint8_t WhichService : service whose run function just returned
+   ES_Event ThisEvent : the event it ran
+ Returns
+   nothing
+ Description
+   called by ES_Run after every run function. Frees the block if the
+   event delivered one to this service and the service did not retain it
+****************************************************************************/
+void ES_PoolRunDone( uint8_t WhichService, ES_Event ThisEvent )
+{
+  uint32_t Saved;
+  uint8_t Index;
+
+  // the free nests inside, so the block cannot change hands in between
+  Saved = ES_EnterCritical();
+  if ( (ThisEvent.EventParam <= 0xffff) &&
+       LookUp( (ES_PoolHandle_t)ThisEvent.EventParam, &Index ) &&
+       (State[Index] == BlockPosted) &&
+       (Owner[Index] == WhichService) &&
+       (PostedAs[Index] == ThisEvent.EventType) )
+  {
+    ES_PoolFree( (ES_PoolHandle_t)ThisEvent.EventParam );
+  }
+  ES_ExitCritical(Saved);
+}
+
+/****************************************************************************
+ Function
+   ES_PoolGetStats
+ Parameters
+   ES_PoolStats_t *pStats : filled with a copy of the counters
+****************************************************************************/
+void ES_PoolGetStats( ES_PoolStats_t *pStats )
+{
+  uint32_t Saved;
+
+  Saved = ES_EnterCritical();
+  *pStats = Stats;
+  ES_ExitCritical(Saved);
+}
+
+/****************************************************************************
+ Function
+   ES_PoolClearStats
+ Description
+   zeroes the counters, InUse is left alone and restarts the high water
+****************************************************************************/
+void ES_PoolClearStats( void )
+{
+  uint32_t Saved;
+
+  Saved = ES_EnterCritical();
+  Stats.Allocs = 0;
+  Stats.Frees = 0;
+  Stats.Exhausted = 0;
+  Stats.BadHandles = 0;
+  Stats.HighWater = Stats.InUse;
+  ES_ExitCritical(Saved);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+// true if Handle names a block that is currently out of the pool
+static bool LookUp( ES_PoolHandle_t Handle, uint8_t *pIndex )
+{
+  uint8_t Index = HANDLE_INDEX(Handle);
+
+  if ( (Index < ES_POOL_NUM_BLOCKS) &&
+       (State[Index] != BlockFree) &&
+       (Generation[Index] == HANDLE_GEN(Handle)) )
+  {
+    *pIndex = Index;
+    return true;
+  }
+  return false;
+}
+
+#ifdef TEST
+/* host stress test. Build this file alone with TEST defined, the framework
+   calls it makes are replaced by the stubs below. A pseudo random mix of
+   allocs, posts, runs, retains and frees is checked against a shadow
+   model: no block is handed out twice, payloads survive the trip, stale
+   handles are refused and every counter agrees with the model.
+*/
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_SERVICES 3
+#define TEST_QUEUE 4
+#define TEST_STEPS 200000UL
+#define TEST_EVENT 1
+
+uint32_t ES_EnterCritical( void ) { return 0; }
+void ES_ExitCritical( uint32_t Saved ) {}
+
+// a FIFO per service stands in for the framework queues
+static ES_Event Queues[TEST_SERVICES][TEST_QUEUE];
+static uint8_t QueueHead[TEST_SERVICES];
+static uint8_t QueueCount[TEST_SERVICES];
+
+bool ES_PostToService( uint8_t WhichService, ES_Event ThisEvent )
+{
+  if ( QueueCount[WhichService] == TEST_QUEUE )
+    return false;
+  Queues[WhichService][(QueueHead[WhichService] + QueueCount[WhichService])
+                       % TEST_QUEUE] = ThisEvent;
+  QueueCount[WhichService]++;
+  return true;
+}
+
+static uint32_t Seed = 1;
+static uint16_t Random( uint16_t Range )
+{
+  Seed = Seed * 1103515245UL + 12345;
+  return (uint16_t)((Seed >> 16) % Range);
+}
+
+// every block the test holds, with the byte it was filled with
+static ES_PoolHandle_t Held[ES_POOL_NUM_BLOCKS];
+static uint8_t HeldFill[ES_POOL_NUM_BLOCKS];
+static uint8_t NumHeld;
+static ES_PoolHandle_t Retained[ES_POOL_NUM_BLOCKS];
+static uint8_t NumRetained;
+static ES_PoolHandle_t Stale = ES_POOL_NO_BLOCK;
+static uint16_t Failures;
+
+static void Fail( char const *What, unsigned long Step )
+{
+  if ( Failures++ < 10 )
+    printf("FAIL step %lu: %s\r\n", Step, What);
+}
+
+static bool Filled( ES_PoolHandle_t Handle, uint8_t Fill )
+{
+  uint8_t *pData = ES_PoolData( Handle );
+  uint16_t i;
+
+  if ( pData == 0 )
+    return false;
+  for ( i = 0; i < ES_POOL_BLOCK_SIZE; i++ )
+    if ( pData[i] != Fill )
+      return false;
+  return true;
+}
+
+int main( void )
+{
+  ES_PoolStats_t Counters;
+  ES_PoolHandle_t Handle;
+  ES_Event ThisEvent;
+  unsigned long Step;
+  uint32_t ExpectExhausted = 0;
+  uint32_t ExpectBad = 0;
+  uint8_t Service;
+  uint8_t i;
+  uint8_t Outstanding;
+
+  ES_PoolInit();
+  for ( Step = 0; Step < TEST_STEPS; Step++ )
+  {
+    switch ( Random(6) )
+    {
+      case 0:   // alloc and fill
+      case 1:
+        Handle = ES_PoolAlloc();
+        if ( Handle == ES_POOL_NO_BLOCK )
+        {
+          ExpectExhausted++;
+          break;
+        }
+        for ( i = 0; i < NumHeld; i++ )
+          if ( Held[i] == Handle )
+            Fail( "handle given out twice", Step );
+        memset( ES_PoolData( Handle ), (uint8_t)Step, ES_POOL_BLOCK_SIZE );
+        Held[NumHeld] = Handle;
+        HeldFill[NumHeld++] = (uint8_t)Step;
+        break;
+
+      case 2:   // post a held block
+        if ( NumHeld == 0 )
+          break;
+        i = Random( NumHeld );
+        Handle = Held[i];
+        Held[i] = Held[--NumHeld];
+        HeldFill[i] = HeldFill[NumHeld];
+        if ( !ES_PostBlock( Random(TEST_SERVICES), TEST_EVENT, Handle ) &&
+             ES_PoolData( Handle ) != 0 )
+          Fail( "failed post kept the block", Step );
+        break;
+
+      case 3:   // run a service: check, sometimes retain, then RunDone
+        Service = Random( TEST_SERVICES );
+        if ( QueueCount[Service] == 0 )
+          break;
+        ThisEvent = Queues[Service][QueueHead[Service]];
+        QueueHead[Service] = (QueueHead[Service] + 1) % TEST_QUEUE;
+        QueueCount[Service]--;
+        if ( ES_PoolData( (ES_PoolHandle_t)ThisEvent.EventParam ) == 0 )
+          Fail( "posted block lost", Step );
+        if ( Random(4) == 0 )
+        {
+          ES_PoolRetain( (ES_PoolHandle_t)ThisEvent.EventParam );
+          Retained[NumRetained++] = (ES_PoolHandle_t)ThisEvent.EventParam;
+        }
+        // a different service finishing must not free it
+        ES_PoolRunDone( (Service + 1) % TEST_SERVICES, ThisEvent );
+        if ( ES_PoolData( (ES_PoolHandle_t)ThisEvent.EventParam ) == 0 )
+          Fail( "freed by the wrong service", Step );
+        ES_PoolRunDone( Service, ThisEvent );
+        if ( (NumRetained == 0) ||
+             (Retained[NumRetained - 1] != ThisEvent.EventParam) )
+          Stale = (ES_PoolHandle_t)ThisEvent.EventParam;
+        break;
+
+      case 4:   // free a held or retained block
+        if ( NumHeld > 0 )
+        {
+          i = Random( NumHeld );
+          if ( !Filled( Held[i], HeldFill[i] ) )
+            Fail( "payload changed", Step );
+          if ( !ES_PoolFree( Held[i] ) )
+            Fail( "free of a held block refused", Step );
+          Stale = Held[i];
+          Held[i] = Held[--NumHeld];
+          HeldFill[i] = HeldFill[NumHeld];
+        }
+        if ( NumRetained > 0 )
+        {
+          i = Random( NumRetained );
+          if ( !ES_PoolFree( Retained[i] ) )
+            Fail( "free of a retained block refused", Step );
+          Stale = Retained[i];
+          Retained[i] = Retained[--NumRetained];
+        }
+        break;
+
+      default:  // a stale handle must be refused
+        if ( Stale == ES_POOL_NO_BLOCK )
+          break;
+        if ( ES_PoolFree( Stale ) )
+          Fail( "stale handle freed", Step );
+        ExpectBad++;
+        Stale = ES_POOL_NO_BLOCK;
+        break;
+    }
+
+    Outstanding = NumHeld + NumRetained;
+    for ( Service = 0; Service < TEST_SERVICES; Service++ )
+      Outstanding += QueueCount[Service];
+    ES_PoolGetStats( &Counters );
+    if ( Counters.InUse != Outstanding )
+      Fail( "InUse disagrees with the model", Step );
+  }
+
+  ES_PoolGetStats( &Counters );
+  if ( Counters.Exhausted != ExpectExhausted )
+    Fail( "exhaustion count", Step );
+  if ( Counters.BadHandles != ExpectBad )
+    Fail( "bad handle count", Step );
+  if ( Counters.Allocs - Counters.Frees != Counters.InUse )
+    Fail( "allocs - frees != in use", Step );
+  if ( Counters.HighWater != ES_POOL_NUM_BLOCKS )
+    Fail( "pool never filled", Step );
+
+  printf("ES_Pool stress: %lu steps, %lu allocs, %lu exhausted, "
+         "high water %u of %u, %u failures\r\n",
+         TEST_STEPS, (unsigned long)Counters.Allocs,
+         (unsigned long)Counters.Exhausted, Counters.HighWater,
+         ES_POOL_NUM_BLOCKS, Failures);
+  return (Failures != 0);
+}
+#endif
+/*------------------------------ End of file ------------------------------*/
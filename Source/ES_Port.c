@@ -1,275 +1,933 @@
-/****************************************************************************
- Module
-   ES_Port.c
-
- Revision
-   1.0.1
-
- Description
-   This is the sample file to demonstrate adding the hardware specific 
-   functions to the Events & Services Framework. This sample is also used
-   as the file for the port to the Freescale MC9S12C32 processor.
-
- Notes
-
- History
- When           Who     What/Why
- -------------- ---     --------
- 08/13/13 12:42 jec     moved the hardware specific aspects of the timer here
- 08/06/13 13:17 jec     Began moving the stuff from the V2 framework files
- 03/05/14 13:20	joa		Began port for TM4C123G
- 03/13/14 10:30	joa		Updated files to use with Cortex M4 processor core.
- 	 	 	 	 	 	Specifically, this was tested on a TI TM4C123G mcu.
-****************************************************************************/
-#include <stdint.h>
-#include <stdbool.h>
-#include "inc/hw_memmap.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/interrupt.h"
-#include "driverlib/uart.h"
-#include "driverlib/pin_map.h"	// Define PART_TM4C123GH6PM in project
-#include "driverlib/systick.h"
-#include "driverlib/gpio.h"
-#include "utils/uartstdio.h"
-#include "ES_Port.h"
-#include "ES_Types.h"
-#include "ES_Timers.h"
-
-#define UART_PORT 		0
-#define UART_BAUD		115200UL
-#define SRC_CLK_FREQ	16000000UL
-#define CLK_FREQ		40000000UL
-
-// TickCount is used to track the number of timer ints that have occurred
-// since the last check. It should really never be more than 1, but just to
-// be sure, we increment it in the interrupt response rather than simply 
-// setting a flag. Using this variable and checking approach we remove the
-// need to post events from the interrupt response routine. This is necessary
-// for compilers like HTC for the midrange PICs which do not produce re-entrant
-// code so cannot post directly to the queues from within the interrupt resp.
-static volatile uint8_t TickCount;
-
-// Global tick count to monitor number of SysTick Interrupts
-// make uint16_t to maintain backwards compatibility and not overly burden
-// 8 and 16 bit processors
-static volatile uint16_t SysTickCounter = 0;
-
-/****************************************************************************
- Function
-     _HW_Timer_Init
- Parameters
-     unsigned char Rate set to one of the TMR_RATE_XX values to set the
-     Tick rate
- Returns
-     None.
- Description
-     Initializes the timer module by setting up the SysTick Interrupt with the requested
-    rate
- Notes
-     modify as required to port to other timer hardware
- Author
-     J. Edward Carryer, 02/24/97 14:23
-     John Alabi, 03/05/14 13:22
-****************************************************************************/
-void _HW_Timer_Init(TimerRate_t Rate)
-{
-	SysTickPeriodSet(Rate);			/* Set the SysTick Interrupt Rate */
-	SysTickIntEnable();				/* Enable the SysTick Interrupt */
-	SysTickEnable();				/* Enable SysTick */
-	IntMasterEnable();				/* Make sure interrupts are enabled */
-
-}
-
-/****************************************************************************
- Function
-     SysTickIntHandler
- Parameters
-     none
- Returns
-     None.
- Description
-     interrupt response routine for the tick interrupt that will allow the
-     framework timers to run.
- Notes
-     As currently (8/13/13) implemented this does not actually post events
-     but simply sets a flag to indicate that the interrupt has occurred.
-     the framework response is handled below in _HW_Process_Pending_Ints
- Author
-    John Alabi, 03/05/14 13:50
-****************************************************************************/
-void SysTickIntHandler(void)
-{
-	/* Interrupt automatically cleared by hardware */
-  ++TickCount;          /* flag that it occurred and needs a response */
-	++SysTickCounter;     // keep the free running time going
-#ifdef LED_DEBUG
-	BlinkLED();
-#endif
-}
-
-/****************************************************************************
- Function
-    _HW_GetTickCount()
- Parameters
-    none
- Returns
-    uint16_t   count of number of system ticks that have occurred.
- Description
-    wrapper for access to SysTickCounter, needed to move increment of tick
-    counter to this module to keep the timer ticking during blocking code
- Notes
-     
- Author
-    Ed Carryer, 10/27/14 13:55
-****************************************************************************/
-uint16_t _HW_GetTickCount(void)
-{
-   return (SysTickCounter);
-}
-
-/****************************************************************************
- Function
-     _HW_Process_Pending_Ints
- Parameters
-     none
- Returns
-     always true.
- Description
-     processes any pending interrupts (actually the hardware interrupt already
-     occurred and simply set a flag to tell this routine to execute the non-
-     hardware response) 
- Notes
-     While this routine technically does not need a return value, we always
-     return true so that it can be used in the conditional while() loop in
-     ES_Run. This way the test for pending interrupts get processed after every
-     run function is called and even when there are no queues with events.
-     This routine could be expanded to process any other interrupt sources
-     that you would like to use to post events to the framework services.
- Author
-     J. Edward Carryer, 08/13/13 13:27
-****************************************************************************/
-bool _HW_Process_Pending_Ints( void )
-{
-   while (TickCount > 0)
-   {
-      /* call the framework tick response to actually run the timers */
-      ES_Timer_Tick_Resp();  
-      TickCount--;
-   }
-   return true; // always return true to allow loop test in ES_Run to proceed
-}
-
-/****************************************************************************
- Function
-     ConsoleInit
- Parameters
-     none
- Returns
-     none.
- Description
-	TBD
- Notes
-	TBD
- Author
-     John Alabi, 03/05/14 15:07
- ****************************************************************************/
-void ConsoleInit(void)
-{
-	// Enable designated port that will be used for the UART
-	SysCtlPeripheralEnable( SYSCTL_PERIPH_GPIOA );
-
-	// Enable the designated UART
-	SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
-
-	// Configure pins for UART including setup for alternate (UART) functionality
-	GPIOPinConfigure(GPIO_PA0_U0RX);
-	GPIOPinConfigure(GPIO_PA1_U0TX);
-	GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
-
-	// Select the clock source
-	UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
-
-	// Initialize the UART for console I/O
-	UARTStdioConfig(UART_PORT, UART_BAUD, SRC_CLK_FREQ);
-
-}
-
-
-
-#if defined(ccs)
-uint32_t CPUgetPRIMASK_cpsid(void)
-{
-    __asm("    mrs     r0, primask	;	Store PRIMASK in r0\n"
-          "    cpsid   i			;	Disable interrupts\n"
-          "    bx      lr			;	Return from function\n"
-    	  "							;	Return PRIMASK in r0\n");
-
-    /* Used to satisfy compiler. Actual return in r0 */
-	return 0;
-}
-
-void CPUsetPRIMASK(uint32_t newPRIMASK)
-{
-	// Set the PRIMASK register to passed in parameter
-	__asm("    msr    primask, r0	;	Store newPRIMASK in PRIMASK\n"
-		  "    bx     lr			;	Return from function\n");
-}
-
-uint32_t CPUgetFAULTMASK_cpsid(void)
-{
-    __asm("    mrs     r0, faultmask;	Store FAULTMASK in r0\n"
-          "    cpsid   f			;	Disable fault handlers & interrupts\n"
-          "    bx      lr			;	Return from function\n"
-    	  "							;	Return FAULTMASK in r0\n");
-
-    /* Used to satisfy compiler. Actual return in r0 */
-	return 0;
-}
-
-void CPUsetFAULTMASK(uint32_t newFAULTMASK)
-{
-	// Set the FAULTMASK register to the passed in parameter
-	__asm("    msr    faultmask, r0	;	Store newFAULTMASK in FAULTMASK\n");
-	//	  "    bx     lr			;	Return from function\n");
-}
-#endif
-
-#if defined(rvmdk) || defined(__ARMCC_VERSION)
-inline uint32_t CPUgetPRIMASK_cpsid(void)
-{
-  uint32_t r0;
-  __asm
-  {
-    mrs     r0, PRIMASK;	  // Store PRIMASK in r0
-    cpsid   i;				      // Disable interrupts
-  }
-  return r0;
-}
-
-inline void CPUsetPRIMASK(uint32_t newPRIMASK)
-{
-  __asm
-  {
-    msr     PRIMASK, newPRIMASK		  // Store newPRIMASK in PRIMASK
-  }
-}
-
-inline uint32_t CPUgetFAULTMASK_cpsid(void)
-{
-  uint32_t r0;
-  __asm
-  {
-    mrs     r0, FAULTMASK;	// Store FAULTMASK in r0
-    cpsid   i;				      // Disable interrupts
-  }
-  return r0;
-}
-
-inline void CPUsetFAULTMASK(uint32_t newFAULTMASK)
-{
-  __asm
-  {
-    msr     FAULTMASK, newFAULTMASK	  // Store newFAULTMASK in FAULTMASK
-  }
-}
-#endif
+/****************************************************************************
+ Module
+   ES_Port.c
+
+ Revision
+   1.0.1
+
+ Description
+   This is the sample file to demonstrate adding the hardware specific 
+   functions to the Events & Services Framework. This sample is also used
+   as the file for the port to the Freescale MC9S12C32 processor.
+
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16     ISR profile hooks, QueryWheelDuty and the
+                        CriticalAll pair in the SRAM benchmark
+ 10/19/26 23:58 t16     wraps counted on COUNTFLAG, safe above the ceiling
+ 10/19/26 23:55 t16     vector table to SRAM, tick path and critical
+                        regions run from SRAM, with a benchmark
+ 10/19/26 23:50 t16     CLK_FREQ from ClockConfig.h
+ 10/19/26 23:40 t16     ES_CycleCounterStart, SysTick ISR profiled
+ 10/19/26 23:00 t16     nestable BASEPRI critical regions, with profiling
+ 10/19/26 15:05 t16     added the microsecond clock built on SysTick
+ 08/13/13 12:42 jec     moved the hardware specific aspects of the timer here
+ 08/06/13 13:17 jec     Began moving the stuff from the V2 framework files
+ 03/05/14 13:20	joa		Began port for TM4C123G
+ 03/13/14 10:30	joa		Updated files to use with Cortex M4 processor core.
+ 	 	 	 	 	 	Specifically, this was tested on a TI TM4C123G mcu.
+****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "driverlib/pin_map.h"	// Define PART_TM4C123GH6PM in project
+#include "driverlib/systick.h"
+#include "driverlib/gpio.h"
+#include "utils/uartstdio.h"
+#include "ES_Configure.h"
+#include "ES_Port.h"
+#include "ES_Types.h"
+#include "ES_Timers.h"
+#include "ES_IsrProfile.h"
+
+#define UART_PORT 		0
+#define UART_BAUD		115200UL
+#define SRC_CLK_FREQ	16000000UL
+#define CLK_FREQ		CPU_CLOCK_HZ
+#define CLK_TICKS_PER_US (CLK_FREQ/1000000UL)
+
+// the priority sits in the top 3 bits of BASEPRI
+#define ES_BASEPRI_CEILING (ES_CRITICAL_CEILING << 5)
+
+// TickCount is used to track the number of timer ints that have occurred
+// since the last check. It should really never be more than 1, but just to
+// be sure, we increment it in the interrupt response rather than simply 
+// setting a flag. Using this variable and checking approach we remove the
+// need to post events from the interrupt response routine. This is necessary
+// for compilers like HTC for the midrange PICs which do not produce re-entrant
+// code so cannot post directly to the queues from within the interrupt resp.
+static volatile uint8_t TickCount;
+
+// Global tick count to monitor number of SysTick Interrupts
+// make uint16_t to maintain backwards compatibility and not overly burden
+// 8 and 16 bit processors
+static volatile uint16_t SysTickCounter = 0;
+
+// the same count at full width, along with the length of a tick, is the
+// coarse part of the microsecond clock. SysTick's own down count is the fine
+// part. 64 bits so that the uS clock never wraps
+static volatile uint64_t SysTickWraps = 0;
+static uint32_t SysTickPeriod = 0;    // SysTick clocks per tick
+static uint32_t SysTickPeriodUS = 0;  // uS per tick
+
+// when the outermost critical region of each kind was entered, and the
+// longest ones so far
+static uint32_t CeilingEnteredAt;
+static uint32_t AllEnteredAt;
+static ES_CriticalStats_t CriticalStats;
+
+/****************************************************************************
+ Function
+     _HW_Timer_Init
+ Parameters
+     unsigned char Rate set to one of the TMR_RATE_XX values to set the
+     Tick rate
+ Returns
+     None.
+ Description
+     Initializes the timer module by setting up the SysTick Interrupt with the requested
+    rate
+ Notes
+     modify as required to port to other timer hardware
+ Author
+     J. Edward Carryer, 02/24/97 14:23
+     John Alabi, 03/05/14 13:22
+****************************************************************************/
+void _HW_Timer_Init(TimerRate_t Rate)
+{
+	SysTickPeriodSet(Rate);			/* Set the SysTick Interrupt Rate */
+	// all of the rates are whole uS, so the clock needs no division per tick
+	SysTickPeriod = (uint32_t)Rate + 1;
+	SysTickPeriodUS = SysTickPeriod/CLK_TICKS_PER_US;
+	SysTickIntEnable();				/* Enable the SysTick Interrupt */
+	SysTickEnable();				/* Enable SysTick */
+	IntMasterEnable();				/* Make sure interrupts are enabled */
+
+}
+
+/****************************************************************************
+ Function
+     SysTickIntHandler
+ Parameters
+     none
+ Returns
+     None.
+ Description
+     interrupt response routine for the tick interrupt that will allow the
+     framework timers to run.
+ Notes
+     As currently (8/13/13) implemented this does not actually post events
+     but simply sets a flag to indicate that the interrupt has occurred.
+     the framework response is handled below in _HW_Process_Pending_Ints
+ Author
+    John Alabi, 03/05/14 13:50
+****************************************************************************/
+ES_RAMFUNC void SysTickIntHandler(void)
+{
+  uint32_t Saved;
+  
+  // count the wrap first, unless a safety ISR reading the clock already
+  // has (see _HW_SampleSysTick)
+  Saved = ES_EnterCriticalAll();
+  if (HWREG(NVIC_ST_CTRL) & NVIC_ST_CTRL_COUNT)
+  {
+    ++SysTickWraps;
+  }
+  ES_ExitCriticalAll(Saved);
+  ES_ISR_ENTRY(ISR_SYSTICK);
+  // SysTick counts down from the reload value after the wrap
+  ES_ISR_LATENCY(ISR_SYSTICK, SysTickPeriod - 1 - SysTickValueGet());
+	/* Interrupt automatically cleared by hardware */
+  ++TickCount;          /* flag that it occurred and needs a response */
+	++SysTickCounter;     // keep the free running time going
+#ifdef LED_DEBUG
+	BlinkLED();
+#endif
+  ES_ISR_EXIT(ISR_SYSTICK);
+}
+
+/****************************************************************************
+ Function
+    _HW_RelocateVectors
+ Description
+    moves the vector table to SRAM so the vector fetch at the start of
+    every interrupt does not wait on flash. The first IntRegister call
+    copies the flash table into driverlib's SRAM table and points VTOR at
+    it, so registering SysTick's own handler again does just that, and
+    later IntRegister calls keep using the same table
+ Notes
+    call before any interrupt is enabled. The scatter file puts the table
+    (section vtable) at the bottom of SRAM, where it is 1 KB aligned
+****************************************************************************/
+void _HW_RelocateVectors(void)
+{
+   IntRegister(FAULT_SYSTICK, SysTickIntHandler);
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTickCount()
+ Parameters
+    none
+ Returns
+    uint16_t   count of number of system ticks that have occurred.
+ Description
+    wrapper for access to SysTickCounter, needed to move increment of tick
+    counter to this module to keep the timer ticking during blocking code
+ Notes
+     
+ Author
+    Ed Carryer, 10/27/14 13:55
+****************************************************************************/
+uint16_t _HW_GetTickCount(void)
+{
+   return (SysTickCounter);
+}
+
+/****************************************************************************
+ Function
+    _HW_SampleSysTick()
+ Parameters
+    uint64_t *pWraps   : ticks counted so far
+    uint32_t *pElapsed : SysTick clocks into the current tick
+ Description
+    consistent snapshot of the two halves of the clock
+ Notes
+    SysTick's COUNTFLAG is set by the reload and cleared by reading the
+    control register, so whoever reads it first, this or the SysTick
+    handler, counts the wrap and the other sees it clear. Interrupt
+    pending state is not enough: a safety ISR can preempt the SysTick
+    handler after the pending bit has cleared but before it has counted.
+    Done with all interrupts off so the two reads cannot be split
+****************************************************************************/
+static void _HW_SampleSysTick(uint64_t *pWraps, uint32_t *pElapsed)
+{
+   uint32_t Saved;
+   uint32_t Current;
+   uint64_t Wraps;
+   
+   Saved = ES_EnterCriticalAll();
+   if (HWREG(NVIC_ST_CTRL) & NVIC_ST_CTRL_COUNT)
+   {
+      ++SysTickWraps;
+   }
+   Current = HWREG(NVIC_ST_CURRENT);
+   // a reload between the two reads belongs after this sample
+   if (HWREG(NVIC_ST_CTRL) & NVIC_ST_CTRL_COUNT)
+   {
+      ++SysTickWraps;
+      Current = HWREG(NVIC_ST_CURRENT);
+   }
+   Wraps = SysTickWraps;
+   ES_ExitCriticalAll(Saved);
+   
+   *pWraps = Wraps;
+   // SysTick counts down from Period-1
+   *pElapsed = (SysTickPeriod == 0) ? 0 : (SysTickPeriod - 1 - Current);
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTimeUS()
+ Parameters
+    none
+ Returns
+    uint64_t  uS since the framework timer was started
+ Description
+    combines the tick count with how far SysTick has counted down into the
+    current tick. If SysTick has reloaded but its handler has not counted
+    the wrap yet (we are in a critical region or an ISR above or preempting
+    it) the wrap is counted here and the fine count re-read to be sure it
+    is from after the reload.
+ Notes
+    safe to call from ISRs, including the safety ISRs above the critical
+    ceiling. Only multiplies, no 64 bit division.
+    returns 0 if the timer has not been started. Monotonic as long as
+    SysTick (at ES_ISR_PRIORITY, held off by critical regions and the
+    safety ISRs) is not held off for a whole tick
+****************************************************************************/
+uint64_t _HW_GetTimeUS(void)
+{
+   uint64_t Wraps;
+   uint32_t Elapsed;
+   
+   _HW_SampleSysTick(&Wraps, &Elapsed);
+   return ((uint64_t)Wraps*SysTickPeriodUS + Elapsed/CLK_TICKS_PER_US);
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTimeUS32()
+ Returns
+    uint32_t  the low 32 bits of _HW_GetTimeUS(), wraps every 71 minutes
+ Description
+    cheaper version for timestamps and differences over short intervals
+****************************************************************************/
+uint32_t _HW_GetTimeUS32(void)
+{
+   uint64_t Wraps;
+   uint32_t Elapsed;
+   
+   _HW_SampleSysTick(&Wraps, &Elapsed);
+   return ((uint32_t)Wraps*SysTickPeriodUS + Elapsed/CLK_TICKS_PER_US);
+}
+
+/****************************************************************************
+ Function
+     _HW_Process_Pending_Ints
+ Parameters
+     none
+ Returns
+     always true.
+ Description
+     processes any pending interrupts (actually the hardware interrupt already
+     occurred and simply set a flag to tell this routine to execute the non-
+     hardware response) 
+ Notes
+     While this routine technically does not need a return value, we always
+     return true so that it can be used in the conditional while() loop in
+     ES_Run. This way the test for pending interrupts get processed after every
+     run function is called and even when there are no queues with events.
+     This routine could be expanded to process any other interrupt sources
+     that you would like to use to post events to the framework services.
+ Author
+     J. Edward Carryer, 08/13/13 13:27
+****************************************************************************/
+ES_RAMFUNC bool _HW_Process_Pending_Ints( void )
+{
+   while (TickCount > 0)
+   {
+      /* call the framework tick response to actually run the timers */
+      ES_Timer_Tick_Resp();  
+      TickCount--;
+   }
+   return true; // always return true to allow loop test in ES_Run to proceed
+}
+
+/****************************************************************************
+ Function
+     ConsoleInit
+ Parameters
+     none
+ Returns
+     none.
+ Description
+	TBD
+ Notes
+	TBD
+ Author
+     John Alabi, 03/05/14 15:07
+ ****************************************************************************/
+void ConsoleInit(void)
+{
+	// Enable designated port that will be used for the UART
+	SysCtlPeripheralEnable( SYSCTL_PERIPH_GPIOA );
+
+	// Enable the designated UART
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
+
+	// Configure pins for UART including setup for alternate (UART) functionality
+	GPIOPinConfigure(GPIO_PA0_U0RX);
+	GPIOPinConfigure(GPIO_PA1_U0TX);
+	GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+
+	// Select the clock source
+	UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
+
+	// Initialize the UART for console I/O
+	UARTStdioConfig(UART_PORT, UART_BAUD, SRC_CLK_FREQ);
+
+}
+
+
+
+/****************************************************************************
+ Function
+    ES_EnterCritical
+ Returns
+    uint32_t the masking state to hand back to ES_ExitCritical
+ Description
+    holds off the interrupts at ES_CRITICAL_CEILING and below. With the
+    ceiling at 0 it turns every interrupt off, as EnterCritical used to
+****************************************************************************/
+ES_RAMFUNC uint32_t ES_EnterCritical(void)
+{
+   uint32_t Saved;
+
+#if ES_CRITICAL_CEILING == 0
+   Saved = CPUgetPRIMASK_cpsid();
+#else
+   Saved = CPUraiseBASEPRI(ES_BASEPRI_CEILING);
+#endif
+#if ES_CRITICAL_PROFILE
+   if (Saved == 0)
+      CeilingEnteredAt = HWREG(DWT_CYCCNT);
+#endif
+   return Saved;
+}
+
+/****************************************************************************
+ Function
+    ES_ExitCritical
+ Parameters
+    uint32_t Saved : what the matching ES_EnterCritical returned
+****************************************************************************/
+ES_RAMFUNC void ES_ExitCritical(uint32_t Saved)
+{
+#if ES_CRITICAL_PROFILE
+   uint32_t Cycles;
+
+   if (Saved == 0)
+   {
+      Cycles = HWREG(DWT_CYCCNT) - CeilingEnteredAt;
+      CriticalStats.Ceiling.Count++;
+      if (Cycles > CriticalStats.Ceiling.MaxCycles)
+         CriticalStats.Ceiling.MaxCycles = Cycles;
+   }
+#endif
+#if ES_CRITICAL_CEILING == 0
+   CPUsetPRIMASK(Saved);
+#else
+   CPUsetBASEPRI(Saved);
+#endif
+}
+
+/****************************************************************************
+ Function
+    ES_EnterCriticalAll
+ Returns
+    uint32_t the PRIMASK to hand back to ES_ExitCriticalAll
+ Description
+    every interrupt off, the safety ISRs included. Only for the handful of
+    instructions that touch what a safety ISR touches
+****************************************************************************/
+ES_RAMFUNC uint32_t ES_EnterCriticalAll(void)
+{
+   uint32_t Saved;
+
+   Saved = CPUgetPRIMASK_cpsid();
+#if ES_CRITICAL_PROFILE
+   if (Saved == 0)
+      AllEnteredAt = HWREG(DWT_CYCCNT);
+#endif
+   return Saved;
+}
+
+/****************************************************************************
+ Function
+    ES_ExitCriticalAll
+ Parameters
+    uint32_t Saved : what the matching ES_EnterCriticalAll returned
+****************************************************************************/
+ES_RAMFUNC void ES_ExitCriticalAll(uint32_t Saved)
+{
+#if ES_CRITICAL_PROFILE
+   uint32_t Cycles;
+
+   if (Saved == 0)
+   {
+      Cycles = HWREG(DWT_CYCCNT) - AllEnteredAt;
+      CriticalStats.All.Count++;
+      if (Cycles > CriticalStats.All.MaxCycles)
+         CriticalStats.All.MaxCycles = Cycles;
+   }
+#endif
+   CPUsetPRIMASK(Saved);
+}
+
+/****************************************************************************
+ Function
+    ES_GetCriticalStats
+ Parameters
+    ES_CriticalStats_t *pStats : filled with the longest regions so far
+ Description
+    the longest ES_EnterCriticalAll region is the worst delay a safety ISR
+    sees from the framework. With ES_CRITICAL_CEILING at 0 the longest
+    region of either kind is
+****************************************************************************/
+void ES_GetCriticalStats(ES_CriticalStats_t *pStats)
+{
+   uint32_t Saved;
+
+   Saved = CPUgetPRIMASK_cpsid();
+   *pStats = CriticalStats;
+   CPUsetPRIMASK(Saved);
+}
+
+void ES_ClearCriticalStats(void)
+{
+   uint32_t Saved;
+
+   Saved = CPUgetPRIMASK_cpsid();
+   CriticalStats.Ceiling.Count = 0;
+   CriticalStats.Ceiling.MaxCycles = 0;
+   CriticalStats.All.Count = 0;
+   CriticalStats.All.MaxCycles = 0;
+   CPUsetPRIMASK(Saved);
+}
+
+/****************************************************************************
+ Function
+    ES_CycleCounterStart
+ Description
+    turns on the trace block and the DWT cycle counter. Leaves the count
+    running if it already is, so it is safe to call more than once
+****************************************************************************/
+void ES_CycleCounterStart(void)
+{
+   HWREG(DEMCR) |= DEMCR_TRCENA;
+   HWREG(DWT_CTRL) |= 1;
+}
+
+#if defined(ccs)
+uint32_t CPUgetPRIMASK_cpsid(void)
+{
+    __asm("    mrs     r0, primask	;	Store PRIMASK in r0\n"
+          "    cpsid   i			;	Disable interrupts\n"
+          "    bx      lr			;	Return from function\n"
+    	  "							;	Return PRIMASK in r0\n");
+
+    /* Used to satisfy compiler. Actual return in r0 */
+	return 0;
+}
+
+void CPUsetPRIMASK(uint32_t newPRIMASK)
+{
+	// Set the PRIMASK register to passed in parameter
+	__asm("    msr    primask, r0	;	Store newPRIMASK in PRIMASK\n"
+		  "    bx     lr			;	Return from function\n");
+}
+
+uint32_t CPUraiseBASEPRI(uint32_t newBASEPRI)
+{
+    __asm("    mrs     r1, basepri	;	Store BASEPRI in r1\n"
+          "    msr     basepri_max, r0	;	Raise BASEPRI, never lower it\n"
+          "    mov     r0, r1		;	Return the old BASEPRI in r0\n"
+          "    bx      lr			;	Return from function\n");
+
+    /* Used to satisfy compiler. Actual return in r0 */
+	return 0;
+}
+
+void CPUsetBASEPRI(uint32_t newBASEPRI)
+{
+	// Set the BASEPRI register to passed in parameter
+	__asm("    msr    basepri, r0	;	Store newBASEPRI in BASEPRI\n"
+		  "    bx     lr			;	Return from function\n");
+}
+
+uint32_t CPUgetFAULTMASK_cpsid(void)
+{
+    __asm("    mrs     r0, faultmask;	Store FAULTMASK in r0\n"
+          "    cpsid   f			;	Disable fault handlers & interrupts\n"
+          "    bx      lr			;	Return from function\n"
+    	  "							;	Return FAULTMASK in r0\n");
+
+    /* Used to satisfy compiler. Actual return in r0 */
+	return 0;
+}
+
+void CPUsetFAULTMASK(uint32_t newFAULTMASK)
+{
+	// Set the FAULTMASK register to the passed in parameter
+	__asm("    msr    faultmask, r0	;	Store newFAULTMASK in FAULTMASK\n");
+	//	  "    bx     lr			;	Return from function\n");
+}
+#endif
+
+#if defined(rvmdk) || defined(__ARMCC_VERSION)
+inline uint32_t CPUgetPRIMASK_cpsid(void)
+{
+  uint32_t r0;
+  __asm
+  {
+    mrs     r0, PRIMASK;	  // Store PRIMASK in r0
+    cpsid   i;				      // Disable interrupts
+  }
+  return r0;
+}
+
+inline void CPUsetPRIMASK(uint32_t newPRIMASK)
+{
+  __asm
+  {
+    msr     PRIMASK, newPRIMASK		  // Store newPRIMASK in PRIMASK
+  }
+}
+
+inline uint32_t CPUraiseBASEPRI(uint32_t newBASEPRI)
+{
+  uint32_t r0;
+  __asm
+  {
+    mrs     r0, BASEPRI;	          // Store BASEPRI in r0
+    msr     BASEPRI_MAX, newBASEPRI;  // Raise BASEPRI, never lower it
+  }
+  return r0;
+}
+
+inline void CPUsetBASEPRI(uint32_t newBASEPRI)
+{
+  __asm
+  {
+    msr     BASEPRI, newBASEPRI		  // Store newBASEPRI in BASEPRI
+  }
+}
+
+inline uint32_t CPUgetFAULTMASK_cpsid(void)
+{
+  uint32_t r0;
+  __asm
+  {
+    mrs     r0, FAULTMASK;	// Store FAULTMASK in r0
+    cpsid   i;				      // Disable interrupts
+  }
+  return r0;
+}
+
+inline void CPUsetFAULTMASK(uint32_t newFAULTMASK)
+{
+  __asm
+  {
+    msr     FAULTMASK, newFAULTMASK	  // Store newFAULTMASK in FAULTMASK
+  }
+}
+#endif
+
+#ifdef TEST
+/* SRAM code benchmark, run on the target with ES_RAM_CODE set. Each
+   ES_RAMFUNC function that can be called on its own is timed with the DWT
+   cycle counter twice: where it runs now, in SRAM, and in the copy __main
+   loaded it from, which is still in flash at the same offset in the load
+   region. Code in ER_IRAM_CODE only branches relative to itself or through
+   veneers to absolute addresses, so the flash copy runs just as the whole
+   region would from flash. A SysTick exception round trip is timed with
+   VTOR at the flash and at the SRAM table. ES_Run never returns and the
+   capture ISRs need their timers, so for those compare the band stats and
+   ES_GetIsrStats of the full program built with ES_RAM_CODE 1 and 0. The
+   map file has the size of each function in ER_IRAM_CODE.
+*/
+#include <string.h>
+#include "ES_Queue.h"
+#include "ES_General.h"
+#include "MotionProfileModule.h"
+
+#if !ES_RAM_CODE
+#error the SRAM benchmark needs ES_RAM_CODE set
+#endif
+
+#define TEST_ROUNDS 1000
+
+extern uint32_t Image$$ER_IRAM_CODE$$Base;
+extern uint32_t Image$$ER_IRAM_CODE$$Length;
+extern uint32_t Load$$ER_IRAM_CODE$$Base;
+extern uint32_t Image$$RW_IRAM_VTABLE$$ZI$$Length;
+
+typedef uint32_t TestFunc_t(uint32_t Address);
+
+static ES_Event TestQueue[1 + 4];
+
+// the flash copy of an ES_RAMFUNC function, the Thumb bit kept
+static uint32_t FlashCopy(uint32_t Address)
+{
+  return Address - (uint32_t)&Image$$ER_IRAM_CODE$$Base +
+         (uint32_t)&Load$$ER_IRAM_CODE$$Base;
+}
+
+// each returns the cycles of TEST_ROUNDS calls to the function at Address
+static uint32_t TimeEnterCritical(uint32_t Address)
+{
+  uint32_t (*pEnter)(void) = (uint32_t (*)(void))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t Saved;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    Saved = pEnter();
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+    ES_ExitCritical(Saved);
+  }
+  return Cycles;
+}
+
+static uint32_t TimeExitCritical(uint32_t Address)
+{
+  void (*pExit)(uint32_t) = (void (*)(uint32_t))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t Saved;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Saved = ES_EnterCritical();
+    Start = HWREG(DWT_CYCCNT);
+    pExit(Saved);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+static uint32_t TimeEnterCriticalAll(uint32_t Address)
+{
+  uint32_t (*pEnter)(void) = (uint32_t (*)(void))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t Saved;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    Saved = pEnter();
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+    ES_ExitCriticalAll(Saved);
+  }
+  return Cycles;
+}
+
+static uint32_t TimeExitCriticalAll(uint32_t Address)
+{
+  void (*pExit)(uint32_t) = (void (*)(uint32_t))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t Saved;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Saved = ES_EnterCriticalAll();
+    Start = HWREG(DWT_CYCCNT);
+    pExit(Saved);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+static uint32_t TimeDeQueue(uint32_t Address)
+{
+  uint8_t (*pDeQueue)(ES_Event *, ES_Event *) =
+      (uint8_t (*)(ES_Event *, ES_Event *))Address;
+  ES_Event ThisEvent;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  ThisEvent.EventType = ES_NEW_KEY;
+  ThisEvent.EventParam = 'x';
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    ES_EnQueueFIFO(TestQueue, ThisEvent);
+    Start = HWREG(DWT_CYCCNT);
+    pDeQueue(TestQueue, &ThisEvent);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+// the ISR called as a function, each call leaves a tick pending
+static uint32_t TimeSysTick(uint32_t Address)
+{
+  void (*pHandler)(void) = (void (*)(void))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    pHandler();
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+    _HW_Process_Pending_Ints();
+  }
+  return Cycles;
+}
+
+static uint32_t TimeTickResp(uint32_t Address)
+{
+  void (*pTickResp)(void) = (void (*)(void))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    pTickResp();
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+// one pass of the scheduler loop's tick check, with a tick to process
+static uint32_t TimePendingInts(uint32_t Address)
+{
+  bool (*pPending)(void) = (bool (*)(void))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    SysTickIntHandler();
+    Start = HWREG(DWT_CYCCNT);
+    pPending();
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+// the ISR profile hooks, on an encoder's entry as the encoder ISRs use them
+static uint32_t TimeIsrEntry(uint32_t Address)
+{
+  void (*pEntry)(ES_IsrId_t) = (void (*)(ES_IsrId_t))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    pEntry(ISR_LEFT_ENCODER);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+static uint32_t TimeIsrLatency(uint32_t Address)
+{
+  void (*pLatency)(ES_IsrId_t, uint32_t) =
+      (void (*)(ES_IsrId_t, uint32_t))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    ES_IsrEntry(ISR_LEFT_ENCODER);
+    Start = HWREG(DWT_CYCCNT);
+    pLatency(ISR_LEFT_ENCODER, 100);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+static uint32_t TimeIsrExit(uint32_t Address)
+{
+  void (*pExit)(ES_IsrId_t) = (void (*)(ES_IsrId_t))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    ES_IsrEntry(ISR_LEFT_ENCODER);
+    Start = HWREG(DWT_CYCCNT);
+    pExit(ISR_LEFT_ENCODER);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+static uint32_t TimeQueryWheelDuty(uint32_t Address)
+{
+  int8_t (*pQuery)(bool) = (int8_t (*)(bool))Address;
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    pQuery(true);
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+  }
+  return Cycles;
+}
+
+// pend SysTick and count until its handler has run and returned
+static uint32_t TimeSysTickException(uint32_t VectorTable)
+{
+  uint32_t Cycles = 0;
+  uint32_t Start;
+  uint32_t i;
+
+  HWREG(NVIC_VTABLE) = VectorTable;
+  for ( i = 0; i < TEST_ROUNDS; i++ ){
+    Start = HWREG(DWT_CYCCNT);
+    HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PENDSTSET;
+    Cycles += HWREG(DWT_CYCCNT) - Start;
+    _HW_Process_Pending_Ints();
+  }
+  return Cycles;
+}
+
+typedef struct {
+  char const *Name;
+  TestFunc_t *Time;
+  uint32_t Address;
+} RamTest_t;
+
+int main( void )
+{
+  RamTest_t const Tests[] = {
+    { "ES_EnterCritical",   TimeEnterCritical, (uint32_t)ES_EnterCritical },
+    { "ES_ExitCritical",    TimeExitCritical,  (uint32_t)ES_ExitCritical },
+    { "ES_EnterCriticalAll", TimeEnterCriticalAll, (uint32_t)ES_EnterCriticalAll },
+    { "ES_ExitCriticalAll", TimeExitCriticalAll, (uint32_t)ES_ExitCriticalAll },
+    { "ES_DeQueue",         TimeDeQueue,       (uint32_t)ES_DeQueue },
+    { "SysTickIntHandler",  TimeSysTick,       (uint32_t)SysTickIntHandler },
+    { "ES_Timer_Tick_Resp", TimeTickResp,      (uint32_t)ES_Timer_Tick_Resp },
+    { "_HW_Process_Pending_Ints", TimePendingInts, (uint32_t)_HW_Process_Pending_Ints },
+    { "ES_IsrEntry",        TimeIsrEntry,      (uint32_t)ES_IsrEntry },
+    { "ES_IsrLatency",      TimeIsrLatency,    (uint32_t)ES_IsrLatency },
+    { "ES_IsrExit",         TimeIsrExit,       (uint32_t)ES_IsrExit },
+    { "QueryWheelDuty",     TimeQueryWheelDuty, (uint32_t)QueryWheelDuty }
+  };
+  uint32_t FlashVectors;
+  uint32_t RAMVectors;
+  uint32_t InSRAM;
+  uint32_t InFlash;
+  uint8_t i;
+
+  SysCtlClockSet(CPU_CLOCK_SYSCTL);
+  TERMIO_Init();
+  ES_CycleCounterStart();
+  ES_IsrProfileInit();
+  FlashVectors = HWREG(NVIC_VTABLE);
+  _HW_RelocateVectors();
+  RAMVectors = HWREG(NVIC_VTABLE);
+  ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
+  // an active timer, long enough to outlast every tick below
+  ES_Timer_InitTimer(0, 0xFFFF);
+  IntMasterEnable();
+
+  printf("\r\nSRAM code at %08lx, %lu bytes, vector table %lu bytes\r\n",
+      (unsigned long)&Image$$ER_IRAM_CODE$$Base,
+      (unsigned long)&Image$$ER_IRAM_CODE$$Length,
+      (unsigned long)&Image$$RW_IRAM_VTABLE$$ZI$$Length);
+  if (memcmp((void const *)&Load$$ER_IRAM_CODE$$Base,
+             (void const *)&Image$$ER_IRAM_CODE$$Base,
+             (uint32_t)&Image$$ER_IRAM_CODE$$Length) != 0){
+    printf("flash copy differs from SRAM, cannot compare\r\n");
+    for(;;)
+      ;
+  }
+
+  printf("cycles/call               SRAM  flash\r\n");
+  for ( i = 0; i < ARRAY_SIZE(Tests); i++ ){
+    InSRAM = Tests[i].Time(Tests[i].Address);
+    InFlash = Tests[i].Time(FlashCopy(Tests[i].Address));
+    printf("%-24s %5lu  %5lu\r\n", Tests[i].Name,
+        (unsigned long)(InSRAM/TEST_ROUNDS), (unsigned long)(InFlash/TEST_ROUNDS));
+  }
+  InSRAM = TimeSysTickException(RAMVectors);
+  InFlash = TimeSysTickException(FlashVectors);
+  HWREG(NVIC_VTABLE) = RAMVectors;
+  printf("%-24s %5lu  %5lu\r\n", "SysTick exception, VTOR",
+      (unsigned long)(InSRAM/TEST_ROUNDS), (unsigned long)(InFlash/TEST_ROUNDS));
+
+  for(;;)
+    ;
+}
+#endif
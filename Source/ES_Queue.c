@@ -1,365 +1,527 @@
-//#define TEST
-/****************************************************************************
- Module
-     ES_Queue.c
- Description
-     Implements a FIFO circular buffer of EF_Event in a block of memory
- Notes
-
- History
- When           Who     What/Why
- -------------- ---     --------
- 01/15/12 09:34 jec      converted to use the new C99 types from types.h
- 08/09/11 18:16 jec      started coding
-*****************************************************************************/
-/*----------------------------- Include Files -----------------------------*/
-#include "ES_Configure.h"
-#include "ES_Queue.h"
-#include "ES_Port.h"
-
-/*----------------------------- Module Defines ----------------------------*/
-unsigned int _PRIMASK_temp;
-//unsigned int _FAULTMASK_temp;
-// QueueSize is max number of entries in the queue
-// CurrentIndex is the 'read-from' index,
-// actually CurrentIndex + sizeof(EF_Queue_t)
-// entries are made to CurrentIndex + NumEntries + sizeof(ES_Queue_t)
-typedef struct {  uint8_t QueueSize;
-                  uint8_t CurrentIndex;
-                  uint8_t NumEntries;
-} ES_Queue_t;
-
-typedef ES_Queue_t * pQueue_t;
-
-/*---------------------------- Module Functions ---------------------------*/
-
-/*---------------------------- Module Variables ---------------------------*/
-
-/*------------------------------ Module Code ------------------------------*/
-/****************************************************************************
- Function
-   ES_InitQueue
- Parameters
-   EF_Event * pBlock : pointer to the block of memory to use for the Queue
-   unsigned char BlockSize: size of the block pointed to by pBlock
- Returns
-   max number of entries in the created queue
- Description
-   Initializes a queue structure at the beginning of the block of memory
- Notes
-   you should pass it a block that is at least sizeof(ES_Queue_t) larger than 
-   the number of entries that you want in the queue. Since the size of an 
-   ES_Event (at 4 bytes; 2 enum, 2 param) is greater than the 
-   sizeof(ES_Queue_t), you only need to declare an array of ES_Event
-   with 1 more element than you need for the actual queue.
- Author
-   J. Edward Carryer, 08/09/11, 18:40
-****************************************************************************/
-uint8_t ES_InitQueue( ES_Event * pBlock, uint8_t BlockSize )
-{
-   pQueue_t pThisQueue;
-   // initialize the Queue by setting up initial values for elements
-   pThisQueue = (pQueue_t)pBlock;
-   // use all but the structure overhead as the Queue
-   pThisQueue->QueueSize = BlockSize - 1;
-   pThisQueue->CurrentIndex = 0;
-   pThisQueue->NumEntries = 0;
-   return(pThisQueue->QueueSize);
-}
-
-/****************************************************************************
- Function
-   ES_EnQueueFIFO
- Parameters
-   ES_Event * pBlock : pointer to the block of memory in use as the Queue
-   ES_Event Event2Add : event to be added to the Queue
- Returns
-   bool : true if the add was successful, false if not
- Description
-   if it will fit, adds Event2Add to the Queue
- Notes
-
-  Author
-   J. Edward Carryer, 08/09/11, 18:59
-****************************************************************************/
-bool ES_EnQueueFIFO( ES_Event * pBlock, ES_Event Event2Add )
-{
-   pQueue_t pThisQueue;
-   pThisQueue = (pQueue_t)pBlock;
-   // index will go from 0 to QueueSize-1 so use '<' to test if there is space
-   if ( pThisQueue->NumEntries < pThisQueue->QueueSize)
-   {  // save the new event, use % to create circular buffer in block
-      // 1+ to step past the Queue struct at the beginning of the
-      // block
-      EnterCritical();   // save interrupt state, turn ints off
-      pBlock[ 1 + ((pThisQueue->CurrentIndex + pThisQueue->NumEntries)
-               % pThisQueue->QueueSize)] = Event2Add;
-      pThisQueue->NumEntries++;          // inc number of entries
-      ExitCritical();  // restore saved interrupt state
-      
-      return(true);
-   }else
-      return(false);
-}
-
-/****************************************************************************
- Function
-   ES_EnQueueLIFO
- Parameters
-   ES_Event * pBlock : pointer to the block of memory in use as the Queue
-   ES_Event Event2Add : event to be added to the Queue
- Returns
-   bool : true if the add was successful, false if not
- Description
-   if it will fit, adds Event2Add to the Queue at the extraction point, making
-   it the next event to be removed by a DeQueue operation, that is a 
-   Last In First Out operation.
- Notes
-
-  Author
-   J. Edward Carryer, 11/02/13, 14:30
-****************************************************************************/
-bool ES_EnQueueLIFO( ES_Event * pBlock, ES_Event Event2Add )
-{
-   pQueue_t pThisQueue;
-   pThisQueue = (pQueue_t)pBlock;
-   // index will go from 0 to QueueSize-1 so use '<' to test if there is space
-    if ( pThisQueue->NumEntries < pThisQueue->QueueSize){
-      EnterCritical();   // save interrupt state, turn ints off
-    // OK, there is space note that the queue now has 1 more entry
-      pThisQueue->NumEntries++;
-    // Check to see if we need to wrap around as we back up index
-      if (pThisQueue->CurrentIndex == 0){
-       pThisQueue->CurrentIndex = pThisQueue->QueueSize -1;
-      }
-      else{
-        pThisQueue->CurrentIndex--;
-      }  
-      pBlock[ 1 + pThisQueue->CurrentIndex ] = Event2Add;
-      ExitCritical();  // restore saved interrupt state      
-      return(true);
-    }else // in case no room on the queue
-      return(false);
-}
-
-
-/****************************************************************************
- Function
-   ES_DeQueue
- Parameters
-   unsigned char * pBlock : pointer to the block of memory in use as the Queue
-   ES_Event * pReturnEvent : used to return the event pulled from the queue
- Returns
-   The number of entries remaining in the Queue
- Description
-   pulls next available entry from Queue, EF_NO_EVENT if Queue was empty and
-   copies it to *pReturnEvent.
- Notes
-
- Author
-   J. Edward Carryer, 08/09/11, 19:11
-****************************************************************************/
-uint8_t ES_DeQueue( ES_Event * pBlock, ES_Event * pReturnEvent )
-{
-   pQueue_t pThisQueue;
-   uint8_t NumLeft;
-
-   pThisQueue = (pQueue_t)pBlock;
-   if ( pThisQueue->NumEntries > 0)
-   {
-      EnterCritical();   // save interrupt state, turn ints off
-      *pReturnEvent = pBlock[ 1 + pThisQueue->CurrentIndex ];
-      // inc the index
-      pThisQueue->CurrentIndex++;
-      // this way we only do the modulo operation when we really need to
-      if (pThisQueue->CurrentIndex >=  pThisQueue->QueueSize)
-         pThisQueue->CurrentIndex = (uint8_t)(pThisQueue->CurrentIndex % pThisQueue->QueueSize);
-      //dec number of elements since we took 1 out
-      NumLeft = --pThisQueue->NumEntries; 
-      ExitCritical();  // restore saved interrupt state
-   }else { // no items left in the queue
-      (*pReturnEvent).EventType = ES_NO_EVENT;
-      (*pReturnEvent).EventParam = 0;
-      NumLeft = 0;
-   }
-   return NumLeft;
-}
-
-/****************************************************************************
- Function
-   ES_IsQueueEmpty
- Parameters
-   unsigned char * pBlock : pointer to the block of memory in use as the Queue
- Returns
-   bool : true if Queue is empty
- Description
-   see above
- Notes
-
- Author
-   J. Edward Carryer, 08/10/11, 13:29
-****************************************************************************/
-bool ES_IsQueueEmpty( ES_Event * pBlock )
-{
-   pQueue_t pThisQueue;
-
-   pThisQueue = (pQueue_t)pBlock;
-   return(pThisQueue->NumEntries == 0);
-}
-
-#if 0
-/****************************************************************************
- Function
-   QueueFlushQueue
- Parameters
-   unsigned char * pBlock : pointer to the block of memory in use as the Queue
- Returns
-   nothing
- Description
-   flushes the Queue by reinitializing the indecies
- Notes
-
- Author
-   J. Edward Carryer, 08/12/06, 19:24
-****************************************************************************/
-void QueueFlushQueue( uint8_t * pBlock )
-{
-   pQueue_t pThisQueue;
-   // doing this with a Queue structure is not strictly necessary
-   // but makes it clearer what is going on.
-   pThisQueue = (pQueue_t)pBlock;
-   pThisQueue->CurrentIndex = 0;
-   pThisQueue->NumEntries = 0;
-   return;
-}
-
-
-#endif
-/***************************************************************************
- private functions
- ***************************************************************************/
-#ifdef TEST
-
-#include <stdio.h>
-#include "ES_General.h"
-
-static ES_Event TestQueue[3+1];
-volatile  uint8_t NumLeft; // for debugging visibility
-
-void main(void){
-  ES_Event MyEvent;
-  bool bReturn;
-  
-  ES_InitQueue( TestQueue, ARRAY_SIZE(TestQueue) );
-  MyEvent.EventType = 0;
-  MyEvent.EventParam = 1;
-  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
-  bReturn +=1; // keep that sily optimizer away
-  
-    // Try stuffing one on using the LIFO rule
-  MyEvent.EventType = 10;
-  MyEvent.EventParam = 11;
-  bReturn = ES_EnQueueLIFO( TestQueue, MyEvent );
-  bReturn +=1; // keep that sily optimizer away
-  
-  // at this point, the events in the queue should be 11,0
-  // so pull off the 11, leaving 1 entry
-  NumLeft = ES_DeQueue( TestQueue, &MyEvent);
-  if ( NumLeft != 1)
-    bReturn = 0;  
-
-  MyEvent.EventType = 2;
-  MyEvent.EventParam = 3;
-  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
-  bReturn +=1; // keep that sily optimizer away
-  
-  MyEvent.EventType = 4;
-  MyEvent.EventParam = 5;
-  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
-  bReturn +=1; // keep that sily optimizer away
-  
-  // queue is now full so this one should fail
-  MyEvent.EventType = 6;
-  MyEvent.EventParam = 7;
-  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
-  bReturn +=1; // keep that sily optimizer away
-  
-  // at this point, the events in the queue should be 0,2,4
-  // so pull off the 0, leaving 2 entries
-  NumLeft = ES_DeQueue( TestQueue, &MyEvent);
-  if ( NumLeft != 2)
-    bReturn = 0;  
-  // Try stuffing one on using the LIFO rule
-  MyEvent.EventType = 8;
-  MyEvent.EventParam = 9;
-  bReturn = ES_EnQueueLIFO( TestQueue, MyEvent );
-  bReturn +=1; // keep that sily optimizer away
-  
-  // at this point, the events in the queue should be 8,2,4
-  // so pull off the 8, leaving 2 entries
-  NumLeft = ES_DeQueue( TestQueue, &MyEvent);
-  NumLeft += 3; //to keep the compiler from optimizing away the last save
-  
-  while(1)
-    ;
-}
-
-#endif
-/*------------------------------- Footnotes -------------------------------*/
-/*------------------------------ End of file ------------------------------*/
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+//#define TEST
+/****************************************************************************
+ Module
+     ES_Queue.c
+ Description
+     Implements a FIFO circular buffer of EF_Event in a block of memory
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16      added ES_EnQueueLIFONoLock, LIFO capacity test
+                         now inside the critical region
+ 10/19/26 23:55 t16      ES_DeQueue runs from SRAM with ES_RAM_CODE
+ 10/19/26 23:00 t16      nestable critical regions, state saved per call
+ 10/19/26 22:30 t16      overflow count per queue, ES_SpliceToFront for
+                         recalling a whole deferral queue at once
+ 10/19/26 20:40 t16      added ES_EnQueueFIFONoLock for bulk posts
+ 10/19/26 19:40 t16      copy cost measurement in the test harness
+ 01/15/12 09:34 jec      converted to use the new C99 types from types.h
+ 08/09/11 18:16 jec      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Queue.h"
+#include "ES_Port.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+//unsigned int _FAULTMASK_temp;
+// QueueSize is max number of entries in the queue
+// CurrentIndex is the 'read-from' index,
+// actually CurrentIndex + sizeof(EF_Queue_t)
+// entries are made to CurrentIndex + NumEntries + sizeof(ES_Queue_t)
+// Overflows counts adds refused because the queue was full, it sticks at
+// 255
+typedef struct {  uint8_t QueueSize;
+                  uint8_t CurrentIndex;
+                  uint8_t NumEntries;
+                  uint8_t Overflows;
+} ES_Queue_t;
+
+typedef ES_Queue_t * pQueue_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_InitQueue
+ Parameters
+   EF_Event * pBlock : pointer to the block of memory to use for the Queue
+   unsigned char BlockSize: size of the block pointed to by pBlock
+ Returns
+   max number of entries in the created queue
+ Description
+   Initializes a queue structure at the beginning of the block of memory
+ Notes
+   you should pass it a block that is at least sizeof(ES_Queue_t) larger than 
+   the number of entries that you want in the queue. Since the size of an 
+   ES_Event (at least 4 bytes in any ES_EVENT_FORMAT) is no less than the 
+   sizeof(ES_Queue_t), you only need to declare an array of ES_Event
+   with 1 more element than you need for the actual queue.
+ Author
+   J. Edward Carryer, 08/09/11, 18:40
+****************************************************************************/
+uint8_t ES_InitQueue( ES_Event * pBlock, uint8_t BlockSize )
+{
+   pQueue_t pThisQueue;
+   // initialize the Queue by setting up initial values for elements
+   pThisQueue = (pQueue_t)pBlock;
+   // use all but the structure overhead as the Queue
+   pThisQueue->QueueSize = BlockSize - 1;
+   pThisQueue->CurrentIndex = 0;
+   pThisQueue->NumEntries = 0;
+   pThisQueue->Overflows = 0;
+   return(pThisQueue->QueueSize);
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueFIFO
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+ Returns
+   bool : true if the add was successful, false if not
+ Description
+   if it will fit, adds Event2Add to the Queue
+ Notes
+
+  Author
+   J. Edward Carryer, 08/09/11, 18:59
+****************************************************************************/
+bool ES_EnQueueFIFO( ES_Event * pBlock, ES_Event Event2Add )
+{
+   bool ReturnVal;
+   uint32_t Saved;
+   
+   Saved = ES_EnterCritical();   // save interrupt state, mask the framework ints
+   ReturnVal = ES_EnQueueFIFONoLock( pBlock, Event2Add );
+   ES_ExitCritical( Saved );  // restore saved interrupt state
+   return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueFIFONoLock
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+ Returns
+   bool : true if the add was successful, false if not
+ Description
+   ES_EnQueueFIFO without the critical region, for callers that post to
+   several queues inside one critical region of their own
+ Notes
+   call inside a critical region
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+bool ES_EnQueueFIFONoLock( ES_Event * pBlock, ES_Event Event2Add )
+{
+   pQueue_t pThisQueue;
+   pThisQueue = (pQueue_t)pBlock;
+   // index will go from 0 to QueueSize-1 so use '<' to test if there is space
+   if ( pThisQueue->NumEntries < pThisQueue->QueueSize)
+   {  // save the new event, use % to create circular buffer in block
+      // 1+ to step past the Queue struct at the beginning of the
+      // block
+      pBlock[ 1 + ((pThisQueue->CurrentIndex + pThisQueue->NumEntries)
+               % pThisQueue->QueueSize)] = Event2Add;
+      pThisQueue->NumEntries++;          // inc number of entries
+      return(true);
+   }else{
+      if ( pThisQueue->Overflows < 0xFF )
+         pThisQueue->Overflows++;
+      return(false);
+   }
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueLIFO
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+ Returns
+   bool : true if the add was successful, false if not
+ Description
+   if it will fit, adds Event2Add to the Queue at the extraction point, making
+   it the next event to be removed by a DeQueue operation, that is a 
+   Last In First Out operation.
+ Notes
+
+  Author
+   J. Edward Carryer, 11/02/13, 14:30
+****************************************************************************/
+bool ES_EnQueueLIFO( ES_Event * pBlock, ES_Event Event2Add )
+{
+   bool ReturnVal;
+   uint32_t Saved;
+   
+   Saved = ES_EnterCritical();   // save interrupt state, mask the framework ints
+   ReturnVal = ES_EnQueueLIFONoLock( pBlock, Event2Add );
+   ES_ExitCritical( Saved );  // restore saved interrupt state
+   return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueLIFONoLock
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+ Returns
+   bool : true if the add was successful, false if not
+ Description
+   ES_EnQueueLIFO without the critical region, for callers that need the
+   add and their own bookkeeping done in one critical region
+ Notes
+   call inside a critical region
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+bool ES_EnQueueLIFONoLock( ES_Event * pBlock, ES_Event Event2Add )
+{
+   pQueue_t pThisQueue;
+   pThisQueue = (pQueue_t)pBlock;
+   // index will go from 0 to QueueSize-1 so use '<' to test if there is space
+    if ( pThisQueue->NumEntries < pThisQueue->QueueSize){
+    // OK, there is space note that the queue now has 1 more entry
+      pThisQueue->NumEntries++;
+    // Check to see if we need to wrap around as we back up index
+      if (pThisQueue->CurrentIndex == 0){
+       pThisQueue->CurrentIndex = pThisQueue->QueueSize -1;
+      }
+      else{
+        pThisQueue->CurrentIndex--;
+      }  
+      pBlock[ 1 + pThisQueue->CurrentIndex ] = Event2Add;
+      return(true);
+    }else{ // in case no room on the queue
+      if ( pThisQueue->Overflows < 0xFF )
+        pThisQueue->Overflows++;
+      return(false);
+    }
+}
+
+/****************************************************************************
+ Function
+   ES_SpliceToFront
+ Parameters
+   ES_Event * pDest : the queue to put the events in
+   ES_Event * pSource : the queue to take them from
+ Returns
+   uint8_t : the number of events moved
+ Description
+   moves the events in pSource to the front of pDest, keeping their order,
+   so the oldest one in pSource is the next one out of pDest. If pDest
+   does not have room for all of them the oldest ones that fit are moved
+   and the rest stay in pSource
+ Notes
+   one pass with no critical region of its own, call it inside one if
+   either queue is shared with an ISR
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint8_t ES_SpliceToFront( ES_Event * pDest, ES_Event * pSource )
+{
+   pQueue_t pDestQueue;
+   pQueue_t pSourceQueue;
+   uint8_t NumMoved;
+   uint8_t Next;     // source index one past the next event to move
+   uint8_t i;
+
+   pDestQueue = (pQueue_t)pDest;
+   pSourceQueue = (pQueue_t)pSource;
+   NumMoved = pDestQueue->QueueSize - pDestQueue->NumEntries;
+   if ( NumMoved > pSourceQueue->NumEntries )
+      NumMoved = pSourceQueue->NumEntries;
+
+   // newest of the moved events first, backing up from the front of pDest
+   Next = (uint8_t)((pSourceQueue->CurrentIndex + NumMoved)
+                                          % pSourceQueue->QueueSize);
+   for ( i = 0; i < NumMoved; i++ )
+   {
+      Next = (Next == 0) ? pSourceQueue->QueueSize - 1 : Next - 1;
+      if (pDestQueue->CurrentIndex == 0)
+         pDestQueue->CurrentIndex = pDestQueue->QueueSize - 1;
+      else
+         pDestQueue->CurrentIndex--;
+      pDest[ 1 + pDestQueue->CurrentIndex ] = pSource[ 1 + Next ];
+   }
+   pDestQueue->NumEntries += NumMoved;
+
+   pSourceQueue->CurrentIndex = (uint8_t)((pSourceQueue->CurrentIndex + NumMoved)
+                                          % pSourceQueue->QueueSize);
+   pSourceQueue->NumEntries -= NumMoved;
+   return NumMoved;
+}
+
+/****************************************************************************
+ Function
+   ES_QueueOverflows
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   uint8_t : adds refused because the queue was full since it was
+             initialized, up to 255
+ Author
+   Team 16, 10/19/26
+****************************************************************************/
+uint8_t ES_QueueOverflows( ES_Event * pBlock )
+{
+   return ((pQueue_t)pBlock)->Overflows;
+}
+
+
+/****************************************************************************
+ Function
+   ES_DeQueue
+ Parameters
+   unsigned char * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event * pReturnEvent : used to return the event pulled from the queue
+ Returns
+   The number of entries remaining in the Queue
+ Description
+   pulls next available entry from Queue, EF_NO_EVENT if Queue was empty and
+   copies it to *pReturnEvent.
+ Notes
+
+ Author
+   J. Edward Carryer, 08/09/11, 19:11
+****************************************************************************/
+ES_RAMFUNC uint8_t ES_DeQueue( ES_Event * pBlock, ES_Event * pReturnEvent )
+{
+   pQueue_t pThisQueue;
+   uint32_t Saved;
+   uint8_t NumLeft;
+
+   pThisQueue = (pQueue_t)pBlock;
+   if ( pThisQueue->NumEntries > 0)
+   {
+      Saved = ES_EnterCritical();   // save interrupt state, mask the framework ints
+      *pReturnEvent = pBlock[ 1 + pThisQueue->CurrentIndex ];
+      // inc the index
+      pThisQueue->CurrentIndex++;
+      // this way we only do the modulo operation when we really need to
+      if (pThisQueue->CurrentIndex >=  pThisQueue->QueueSize)
+         pThisQueue->CurrentIndex = (uint8_t)(pThisQueue->CurrentIndex % pThisQueue->QueueSize);
+      //dec number of elements since we took 1 out
+      NumLeft = --pThisQueue->NumEntries; 
+      ES_ExitCritical( Saved );  // restore saved interrupt state
+   }else { // no items left in the queue
+      (*pReturnEvent).EventType = ES_NO_EVENT;
+      (*pReturnEvent).EventParam = 0;
+      ES_EventSetTime( pReturnEvent, 0 );
+      NumLeft = 0;
+   }
+   return NumLeft;
+}
+
+/****************************************************************************
+ Function
+   ES_IsQueueEmpty
+ Parameters
+   unsigned char * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   bool : true if Queue is empty
+ Description
+   see above
+ Notes
+
+ Author
+   J. Edward Carryer, 08/10/11, 13:29
+****************************************************************************/
+bool ES_IsQueueEmpty( ES_Event * pBlock )
+{
+   pQueue_t pThisQueue;
+
+   pThisQueue = (pQueue_t)pBlock;
+   return(pThisQueue->NumEntries == 0);
+}
+
+#if 0
+/****************************************************************************
+ Function
+   QueueFlushQueue
+ Parameters
+   unsigned char * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   nothing
+ Description
+   flushes the Queue by reinitializing the indecies
+ Notes
+
+ Author
+   J. Edward Carryer, 08/12/06, 19:24
+****************************************************************************/
+void QueueFlushQueue( uint8_t * pBlock )
+{
+   pQueue_t pThisQueue;
+   // doing this with a Queue structure is not strictly necessary
+   // but makes it clearer what is going on.
+   pThisQueue = (pQueue_t)pBlock;
+   pThisQueue->CurrentIndex = 0;
+   pThisQueue->NumEntries = 0;
+   return;
+}
+
+
+#endif
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+#ifdef TEST
+
+#include <stdio.h>
+#include "ES_General.h"
+#include "inc/hw_types.h"
+
+#define COPY_PAIRS 1000
+
+static ES_Event TestQueue[3+1];
+volatile  uint8_t NumLeft; // for debugging visibility
+// cost of the selected ES_EVENT_FORMAT, read these in the debugger and
+// rebuild with each format to compare
+volatile uint8_t EventBytes;
+volatile uint32_t CyclesPerEnDeQueue;
+
+void main(void){
+  ES_Event MyEvent;
+  bool bReturn;
+  
+  ES_InitQueue( TestQueue, ARRAY_SIZE(TestQueue) );
+  MyEvent.EventType = 0;
+  MyEvent.EventParam = 1;
+  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
+  bReturn +=1; // keep that sily optimizer away
+  
+    // Try stuffing one on using the LIFO rule
+  MyEvent.EventType = 10;
+  MyEvent.EventParam = 11;
+  bReturn = ES_EnQueueLIFO( TestQueue, MyEvent );
+  bReturn +=1; // keep that sily optimizer away
+  
+  // at this point, the events in the queue should be 11,0
+  // so pull off the 11, leaving 1 entry
+  NumLeft = ES_DeQueue( TestQueue, &MyEvent);
+  if ( NumLeft != 1)
+    bReturn = 0;  
+
+  MyEvent.EventType = 2;
+  MyEvent.EventParam = 3;
+  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
+  bReturn +=1; // keep that sily optimizer away
+  
+  MyEvent.EventType = 4;
+  MyEvent.EventParam = 5;
+  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
+  bReturn +=1; // keep that sily optimizer away
+  
+  // queue is now full so this one should fail
+  MyEvent.EventType = 6;
+  MyEvent.EventParam = 7;
+  bReturn = ES_EnQueueFIFO( TestQueue, MyEvent );
+  bReturn +=1; // keep that sily optimizer away
+  
+  // at this point, the events in the queue should be 0,2,4
+  // so pull off the 0, leaving 2 entries
+  NumLeft = ES_DeQueue( TestQueue, &MyEvent);
+  if ( NumLeft != 2)
+    bReturn = 0;  
+  // Try stuffing one on using the LIFO rule
+  MyEvent.EventType = 8;
+  MyEvent.EventParam = 9;
+  bReturn = ES_EnQueueLIFO( TestQueue, MyEvent );
+  bReturn +=1; // keep that sily optimizer away
+  
+  // at this point, the events in the queue should be 8,2,4
+  // so pull off the 8, leaving 2 entries
+  NumLeft = ES_DeQueue( TestQueue, &MyEvent);
+  NumLeft += 3; //to keep the compiler from optimizing away the last save
+  
+  // copy cost: one event in and out of the queue, by the DWT cycle counter
+  ES_InitQueue( TestQueue, ARRAY_SIZE(TestQueue) );
+  ES_CycleCounterStart();
+  HWREG(DWT_CYCCNT) = 0;
+  {
+    uint32_t Start;
+    uint16_t i;
+    
+    Start = HWREG(DWT_CYCCNT);
+    for ( i = 0; i < COPY_PAIRS; i++ )
+    {
+      ES_EnQueueFIFO( TestQueue, MyEvent );
+      ES_DeQueue( TestQueue, &MyEvent);
+    }
+    CyclesPerEnDeQueue = (HWREG(DWT_CYCCNT) - Start)/COPY_PAIRS;
+  }
+  EventBytes = sizeof(ES_Event);
+  
+  while(1)
+    ;
+}
+
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
@@ -1,173 +1,398 @@
-//#define DEBUG
-/****************************************************************************
- Module
-   ES_ShortTimer.c
-
- Revision
-   1.0.1
-
- Description
-   This is a library to provide for the creation of short time-outs 
-   (shorter than the resolution of the ES_Timer library). 
-
- Notes
-   This module uses the Tiva Peripheral Driver Library functions and
-   the ability that it provides to 'hook' a function into an interrupt
-   response routine without modifying the vector table directly.
-   Uses timers A & B on 16/32 bit Timer Module 5
-   
- History
- When           Who     What/Why
- -------------- ---     --------
- 10/11/15 10:30 jec     first pass
- 10/11/15 18:10 jec     converted to post events to the framework
- 
-****************************************************************************/
-// the common headers for I/O, C99 types 
-#include <stdio.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include "BITDEFS.H"
-
-// the headers to access the GPIO subsystem
-#include "inc/hw_memmap.h"
-#include "inc/hw_types.h"
-#include "inc/hw_gpio.h"
-#include "inc/hw_sysctl.h"
-#include "inc/hw_timer.h"
-#include "inc/hw_ints.h"
-
-// the headers to access the TivaWare Library
-#include "driverlib/sysctl.h"
-#include "driverlib/pin_map.h"
-#include "driverlib/gpio.h"
-#include "driverlib/timer.h"
-#include "driverlib/interrupt.h"
-
-// the header to get the timing functions
-#include "ES_ShortTimer.h"
-
-// the framework headers
-#include "ES_Framework.h"
-#include "ES_Configure.h"
-
-
-// module level functions
-
-// define for the timer pre-scaler. this sets the resolution of the
-// timing functions
-// the current values are based on a 40mHz clock rate to give 1uS resolution
-#define PRE_1uS 40
-
-void ShortTimerAHandler(void);
-void ShortTimerBHandler(void);
-
-// module level variables
-
-static uint8_t Timer_A_Priority = SHORT_TIMER_UNUSED;
-static uint8_t Timer_B_Priority = SHORT_TIMER_UNUSED;
-
-//******************************
-// ES_ShortTimerInit()
-// Initialize the timer subsystem and log the services to which the timeout
-// messages will be posted
-//******************************
-void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio){
-#ifdef DEBUG
-// set up I/O lines for debugging
-  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
-  GPIOPinTypeGPIOOutput(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1);
-// start with the lines low
-  GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1, BIT0LO & BIT1LO);  
-#endif  
-
-// enable the clock to the timer module  
-  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER5); 
-// configure as 2 16 bit timers  
-  TimerConfigure(TIMER5_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_ONE_SHOT | 
-                 TIMER_CFG_B_ONE_SHOT);
-// set prescale to get 1uS resolution  
-  TimerPrescaleSet(TIMER5_BASE, TIMER_BOTH, PRE_1uS);
-// log the service to which the timeout will be posted
-  Timer_A_Priority = TimeAPrio;
-  Timer_B_Priority = TimeAPrio;
-      
-}
-
-void ES_ShortTimerStart( uint32_t Which, uint16_t TimeoutValue){
-  if ((Which != TIMER_A) && (Which != TIMER_B))
-    return;
-  // for very short delays. just immediatly post. There is 10us of overhead
-  if( TimeoutValue < 11){
-    if(Which == TIMER_A){
-      ShortTimerAHandler();
-    }else{
-      ShortTimerBHandler();
-    }
-  }
-  TimerLoadSet(TIMER5_BASE, Which, TimeoutValue);
-  
-  if(Which == TIMER_A)
-  { // local enable
-    TimerIntEnable(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
-    // NVIC Enable
-    IntEnable(INT_TIMER5A_TM4C123);
-  }else{
-    // local enable
-    TimerIntEnable(TIMER5_BASE, TIMER_TIMB_TIMEOUT);
-    // NVIC Enable
-    IntEnable(INT_TIMER5B_TM4C123);
-  }
-  
-  TimerEnable(TIMER5_BASE, Which);
-
-#ifdef DEBUG
-// raise I/O line to show we started
-  if( Which == TIMER_A)
-    GPIOPinWrite(GPIO_PORTB_BASE, BIT0HI, BIT0HI);
-  else
-    GPIOPinWrite(GPIO_PORTB_BASE, BIT1HI, BIT1HI);    
-#endif
-  return;
-}
-
-void ShortTimerAHandler(void){
-  ES_Event ThisEvent;
-
-// start by clearing the source of the interrupt
-    TimerIntClear(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
-#ifdef DEBUG
-// lower I/O line to show we arrived
-  GPIOPinWrite(GPIO_PORTB_BASE, BIT0HI, BIT0LO);  
-#endif
- 
-// post the timeout for this timer  
-  ThisEvent.EventType = ES_SHORT_TIMEOUT;
-  ThisEvent.EventParam = TIMER_A;
-// protect against timer that was not correctly initialized  
-  if (Timer_A_Priority != SHORT_TIMER_UNUSED)
-  {
-    ES_PostToService( Timer_A_Priority, ThisEvent);
-  }
-}
-
-void ShortTimerBHandler(void){
-  ES_Event ThisEvent;
-
-// start by clearing the source of the interrupt
-    TimerIntClear(TIMER5_BASE, TIMER_TIMB_TIMEOUT);
-#ifdef DEBUG
-// lower I/O line to show we arrived
-  GPIOPinWrite(GPIO_PORTB_BASE, BIT1HI, BIT1LO);    
-#endif 
-  
-// post the timeout for this timer  
-  ThisEvent.EventType = ES_SHORT_TIMEOUT;
-  ThisEvent.EventParam = TIMER_B;
-// protect against timer that was not correctly initialized  
-  if (Timer_B_Priority != SHORT_TIMER_UNUSED)
-  {
-    ES_PostToService( Timer_B_Priority, ThisEvent);
-  }
-  
-}
+//#define DEBUG
+/****************************************************************************
+ Module
+   ES_ShortTimer.c
+
+ Revision
+   2.0.0
+
+ Description
+   This is a library to provide for the creation of short time-outs 
+   (shorter than the resolution of the ES_Timer library). 
+
+ Notes
+   Any number (NUM_SHORT_TIMERS) of microsecond one-shots are multiplexed
+   onto 16/32 bit Timer Module 5, run as a single 32 bit free running up
+   counter at the system clock. Active timers are kept on a list sorted by
+   deadline and the Timer A match register is always loaded with the
+   deadline at the head of the list, so there is one interrupt per expiry
+   no matter how many timers are running.
+   Timeouts that are already (nearly) due when they are armed pend the
+   match interrupt rather than calling the handler from the caller's
+   context.
+   Slots 0 & 1 stand in for the original TIMER_A & TIMER_B timers, so
+   ES_ShortTimerInit/ES_ShortTimerStart work as before.
+   
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:50 t16     tick rate from ClockConfig.h
+ 10/19/26 23:40 t16     match ISR profiled, latency from the deadline
+ 10/19/26 23:00 t16     critical regions save their state per call
+ 10/19/26 11:20 t16     rewrote as a pool of timers sharing one free running
+                        counter. fixed timer B posting to timer A's service
+ 10/11/15 10:30 jec     first pass
+ 10/11/15 18:10 jec     converted to post events to the framework
+ 
+****************************************************************************/
+// the common headers for I/O, C99 types 
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "BITDEFS.H"
+
+// the headers to access the GPIO subsystem
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_ints.h"
+
+// the headers to access the TivaWare Library
+#include "driverlib/sysctl.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/gpio.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
+
+// the header to get the timing functions
+#include "ES_ShortTimer.h"
+
+// the framework headers
+#include "ES_Framework.h"
+#include "ES_Configure.h"
+
+
+// module level functions
+
+// the counter runs at the system clock, there is no prescaler in 32 bit
+// mode. the rate comes from CPU_CLOCK_HZ in ClockConfig.h
+#define TICKS_PER_uS TicksPerUS
+
+// a deadline closer than this when it is armed could be passed before the
+// match register is loaded, so the interrupt is pended instead
+#define MIN_LEAD_TICKS (2*TICKS_PER_uS)
+
+// keep deadlines well inside half the counter range so that the signed
+// difference between two counts always orders them correctly
+#define MAX_TIMEOUT_uS (0x40000000UL/TICKS_PER_uS)
+
+#define END_OF_LIST 0xff
+
+// the legacy timers live in the first two slots
+#define TIMER_A_SLOT 0
+#define TIMER_B_SLOT 1
+
+typedef struct {
+  uint32_t Deadline;  // counter value at which the timer expires
+  uint16_t Param;     // EventParam of the ES_SHORT_TIMEOUT
+  uint8_t  PostTo;    // service to post to
+  uint8_t  Next;      // next slot in deadline order
+  bool     Active;
+} ShortTimerSlot_t;
+
+void ShortTimerAHandler(void);
+static void Unlink(uint8_t Slot);
+static void Insert(uint8_t Slot);
+static void ArmHead(void);
+
+// module level variables
+
+static ShortTimerSlot_t Slots[NUM_SHORT_TIMERS];
+static uint8_t Head = END_OF_LIST;
+static ES_ShortTimerStats_t Stats;
+
+//******************************
+// ES_ShortTimerInit()
+// Initialize the timer subsystem and log the services to which the timeout
+// messages for the legacy TIMER_A & TIMER_B will be posted
+//******************************
+void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio){
+  uint8_t i;
+  
+#ifdef DEBUG
+// set up I/O lines for debugging
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
+  GPIOPinTypeGPIOOutput(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+// start with the lines low
+  GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1, BIT0LO & BIT1LO);  
+#endif  
+
+// every slot starts idle, posting its own number as the parameter
+  for (i = 0; i < NUM_SHORT_TIMERS; i++){
+    Slots[i].Active = false;
+    Slots[i].Next = END_OF_LIST;
+    Slots[i].PostTo = SHORT_TIMER_UNUSED;
+    Slots[i].Param = i;
+  }
+  Head = END_OF_LIST;
+  ES_ShortTimerClearStats();
+
+// log the service to which the timeout will be posted
+  Slots[TIMER_A_SLOT].PostTo = TimeAPrio;
+  Slots[TIMER_A_SLOT].Param = TIMER_A;
+  Slots[TIMER_B_SLOT].PostTo = TimeBPrio;
+  Slots[TIMER_B_SLOT].Param = TIMER_B;
+
+// enable the clock to the timer module  
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER5); 
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER5))
+    ;
+// configure as a single 32 bit up counter that wraps at 0xffffffff
+  TimerConfigure(TIMER5_BASE, TIMER_CFG_PERIODIC_UP);
+  TimerLoadSet(TIMER5_BASE, TIMER_A, 0xffffffff);
+// the match interrupt has to be enabled in the mode register as well
+  HWREG(TIMER5_BASE + TIMER_O_TAMR) |= TIMER_TAMR_TAMIE;
+  IntEnable(INT_TIMER5A_TM4C123);
+  TimerEnable(TIMER5_BASE, TIMER_A);
+}
+
+//******************************
+// ES_ShortTimerStart()
+// legacy interface, (re)starts TIMER_A or TIMER_B for TimeoutValue uS
+//******************************
+void ES_ShortTimerStart( uint32_t Which, uint16_t TimeoutValue){
+  uint8_t Slot;
+  
+  if (Which == TIMER_A)
+    Slot = TIMER_A_SLOT;
+  else if (Which == TIMER_B)
+    Slot = TIMER_B_SLOT;
+  else
+    return;
+  
+  ES_ShortTimerStartSlot(Slot, Slots[Slot].PostTo, TimeoutValue);
+
+#ifdef DEBUG
+// raise I/O line to show we started
+  if( Which == TIMER_A)
+    GPIOPinWrite(GPIO_PORTB_BASE, BIT0HI, BIT0HI);
+  else
+    GPIOPinWrite(GPIO_PORTB_BASE, BIT1HI, BIT1HI);    
+#endif
+  return;
+}
+
+//******************************
+// ES_ShortTimerStartSlot()
+// (re)starts one of the pool timers. When it expires ES_SHORT_TIMEOUT is
+// posted to PostTo with the slot number as the parameter (TIMER_A/TIMER_B
+// for slots 0 & 1). Returns false on a bad slot or timeout
+//******************************
+bool ES_ShortTimerStartSlot( uint8_t Slot, uint8_t PostTo, uint32_t TimeoutUS){
+  uint32_t Saved;
+
+  if ((Slot >= NUM_SHORT_TIMERS) || (TimeoutUS > MAX_TIMEOUT_uS))
+    return false;
+  
+  Saved = ES_EnterCritical();
+  Unlink(Slot);
+  Slots[Slot].PostTo = PostTo;
+  Slots[Slot].Deadline = TimerValueGet(TIMER5_BASE, TIMER_A) + 
+                         TimeoutUS*TICKS_PER_uS;
+  Insert(Slot);
+  ArmHead();
+  ES_ExitCritical(Saved);
+  return true;
+}
+
+//******************************
+// ES_ShortTimerStop()
+// cancels a pool timer, no event will be posted for it
+//******************************
+void ES_ShortTimerStop( uint8_t Slot){
+  uint32_t Saved;
+
+  if (Slot >= NUM_SHORT_TIMERS)
+    return;
+  
+  Saved = ES_EnterCritical();
+  Unlink(Slot);
+  ArmHead();
+  ES_ExitCritical(Saved);
+}
+
+//******************************
+// ES_ShortTimerIsActive()
+//******************************
+bool ES_ShortTimerIsActive( uint8_t Slot){
+  return ((Slot < NUM_SHORT_TIMERS) && Slots[Slot].Active);
+}
+
+//******************************
+// ES_ShortTimerGetStats()
+// copies out the expiry lateness, measured from the deadline to the match
+// handler reading the counter, in counter ticks
+//******************************
+void ES_ShortTimerGetStats( ES_ShortTimerStats_t *pStats){
+  uint32_t Saved;
+
+  Saved = ES_EnterCritical();
+  *pStats = Stats;
+  ES_ExitCritical(Saved);
+}
+
+void ES_ShortTimerClearStats( void){
+  uint32_t Saved;
+
+  Saved = ES_EnterCritical();
+  Stats.Expired = 0;
+  Stats.MinLateTicks = 0xffffffff;
+  Stats.MaxLateTicks = 0;
+  Stats.TotalLateTicks = 0;
+  ES_ExitCritical(Saved);
+}
+
+//******************************
+// ShortTimerAHandler()
+// match interrupt: post every timer that is due, then arm the next one
+//******************************
+void ShortTimerAHandler(void){
+  ES_Event ThisEvent;
+  uint32_t Now;
+  uint32_t Late;
+  uint8_t Slot;
+
+  ES_ISR_ENTRY(ISR_SHORT_TIMER);
+
+// start by clearing the source of the interrupt
+  TimerIntClear(TIMER5_BASE, TIMER_TIMA_MATCH);
+  
+  Now = TimerValueGet(TIMER5_BASE, TIMER_A);
+// the match was on the earliest deadline, the timer counts CPU clocks
+  if (Head != END_OF_LIST)
+    ES_ISR_LATENCY(ISR_SHORT_TIMER, Now - Slots[Head].Deadline);
+  while ((Head != END_OF_LIST) && ((int32_t)(Slots[Head].Deadline - Now) <= 0)){
+    Slot = Head;
+    Unlink(Slot);
+    
+    Late = Now - Slots[Slot].Deadline;
+    Stats.Expired++;
+    Stats.TotalLateTicks += Late;
+    if (Late < Stats.MinLateTicks)
+      Stats.MinLateTicks = Late;
+    if (Late > Stats.MaxLateTicks)
+      Stats.MaxLateTicks = Late;
+#ifdef DEBUG
+// lower I/O line to show we arrived
+    if (Slot == TIMER_A_SLOT)
+      GPIOPinWrite(GPIO_PORTB_BASE, BIT0HI, BIT0LO);  
+    else if (Slot == TIMER_B_SLOT)
+      GPIOPinWrite(GPIO_PORTB_BASE, BIT1HI, BIT1LO);  
+#endif
+ 
+// post the timeout for this timer  
+    ThisEvent.EventType = ES_SHORT_TIMEOUT;
+    ThisEvent.EventParam = Slots[Slot].Param;
+// protect against timer that was not correctly initialized  
+    if (Slots[Slot].PostTo != SHORT_TIMER_UNUSED)
+    {
+      ES_PostToService( Slots[Slot].PostTo, ThisEvent);
+    }
+  }
+  ArmHead();
+  ES_ISR_EXIT(ISR_SHORT_TIMER);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+// take a slot off the deadline list, if it is on it
+static void Unlink(uint8_t Slot){
+  uint8_t *pLink = &Head;
+  
+  if (!Slots[Slot].Active)
+    return;
+  while (*pLink != END_OF_LIST){
+    if (*pLink == Slot){
+      *pLink = Slots[Slot].Next;
+      break;
+    }
+    pLink = &Slots[*pLink].Next;
+  }
+  Slots[Slot].Active = false;
+  Slots[Slot].Next = END_OF_LIST;
+}
+
+// put a slot on the list in deadline order, after any equal deadlines so
+// that timers started together expire in the order they were started
+static void Insert(uint8_t Slot){
+  uint8_t *pLink = &Head;
+  
+  while ((*pLink != END_OF_LIST) && 
+         ((int32_t)(Slots[*pLink].Deadline - Slots[Slot].Deadline) <= 0)){
+    pLink = &Slots[*pLink].Next;
+  }
+  Slots[Slot].Next = *pLink;
+  *pLink = Slot;
+  Slots[Slot].Active = true;
+}
+
+// load the match register for the earliest deadline, or turn the match
+// interrupt off when nothing is running
+static void ArmHead(void){
+  if (Head == END_OF_LIST){
+    TimerIntDisable(TIMER5_BASE, TIMER_TIMA_MATCH);
+    return;
+  }
+  TimerMatchSet(TIMER5_BASE, TIMER_A, Slots[Head].Deadline);
+  TimerIntEnable(TIMER5_BASE, TIMER_TIMA_MATCH);
+// if the counter is already at or past the deadline (or about to be) the
+// match will not happen until the counter wraps, so run the handler now
+  if ((int32_t)(Slots[Head].Deadline - TimerValueGet(TIMER5_BASE, TIMER_A)) 
+      < (int32_t)MIN_LEAD_TICKS)
+  {
+    IntPendSet(INT_TIMER5A_TM4C123);
+  }
+}
+
+#ifdef TEST
+/* test harness for the short timer pool, run on the target. Starts all of
+   the slots with pseudo random timeouts over and over and reports how late
+   the expiries were handled. Nothing is posted, all slots are left with
+   SHORT_TIMER_UNUSED as their service
+*/
+#include "termio.h"
+
+#define TEST_ROUNDS 1000
+#define TEST_MAX_TIMEOUT_uS 500
+
+int main(void){
+  ES_ShortTimerStats_t Results;
+  uint32_t Seed = 12345;
+  uint16_t Round;
+  uint8_t Slot;
+  bool Running;
+
+  SysCtlClockSet(CPU_CLOCK_SYSCTL);
+  TERMIO_Init();
+  ES_ShortTimerInit(SHORT_TIMER_UNUSED, SHORT_TIMER_UNUSED);
+  IntMasterEnable();
+  printf("\r\nES_ShortTimer jitter test, %d slots, %d rounds\r\n", 
+         NUM_SHORT_TIMERS, TEST_ROUNDS);
+
+  for (Round = 0; Round < TEST_ROUNDS; Round++){
+    for (Slot = 0; Slot < NUM_SHORT_TIMERS; Slot++){
+      Seed = Seed*1103515245 + 12345;
+      ES_ShortTimerStartSlot(Slot, SHORT_TIMER_UNUSED, 
+                             (Seed >> 16) % TEST_MAX_TIMEOUT_uS);
+    }
+    do{
+      Running = false;
+      for (Slot = 0; Slot < NUM_SHORT_TIMERS; Slot++)
+        Running |= ES_ShortTimerIsActive(Slot);
+    }while (Running);
+  }
+
+  ES_ShortTimerGetStats(&Results);
+  printf("expired %lu\r\n", (unsigned long)Results.Expired);
+  printf("late min %lu ns, avg %lu ns, max %lu ns\r\n",
+    (unsigned long)(Results.MinLateTicks*1000/TICKS_PER_uS),
+    (unsigned long)((Results.TotalLateTicks/Results.Expired)*1000/TICKS_PER_uS),
+    (unsigned long)(Results.MaxLateTicks*1000/TICKS_PER_uS));
+  for(;;)
+    ;
+}
+#endif
@@ -0,0 +1,256 @@
+/****************************************************************************
+ Module
+     ES_Urgent.c
+ Description
+     Urgent action hook. Handlers are registered by action number at init
+     and called straight from an ISR, or from PendSV, without going through
+     the service queues and ES_Run
+ Notes
+     PendSV sits at ES_CRITICAL_CEILING, the highest priority the framework
+     critical regions hold off, so a pended handler may call the framework.
+     It runs as soon as the pending ISR returns, unless a critical region
+     is open. ES_UrgentRun is the path that is never held off.
+     Safety ISRs, above the ceiling, hand their events to PendSV through
+     ES_UrgentPublish, since they must not touch the queues themselves.
+     Every call is timed from the detect (the Run or Pend call) to the end
+     of the handler with the DWT cycle counter.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 t16      stats updated with all interrupts masked
+ 10/19/26 23:40 t16      cycle counter started by ES_Initialize
+ 10/19/26 23:00 t16      PendSV moved to the critical ceiling, events from
+                         safety ISRs are published from PendSV
+ 10/19/26 21:30 t16      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Urgent.h"
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// events published by the safety ISRs and not yet passed on by PendSV
+#define RELAY_SIZE 4
+
+/*---------------------------- Module Functions ---------------------------*/
+static void RunTimed( uint8_t Action, uint32_t Start );
+
+/*---------------------------- Module Variables ---------------------------*/
+static ES_UrgentFunc_t *Handlers[NUM_URGENT_ACTIONS];
+static ES_UrgentStats_t Stats[NUM_URGENT_ACTIONS];
+
+// actions waiting for PendSV, and when each was pended
+static volatile uint32_t Pending;
+static uint32_t PendedAt[NUM_URGENT_ACTIONS];
+
+// the safety ISRs share a priority, so they never interrupt each other
+// adding to the relay, and PendSV is the only one taking from it
+static ES_Event Relay[RELAY_SIZE];
+static volatile uint8_t RelayHead;
+static volatile uint8_t RelayTail;
+static uint32_t RelayLost;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_UrgentInit
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   clears the handlers and the relay. Called from ES_Initialize before
+   the service inits. The PendSV priority is in the table in
+   InterruptPriorities.c
+****************************************************************************/
+void ES_UrgentInit( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < NUM_URGENT_ACTIONS; i++ )
+  {
+    Handlers[i] = 0;
+    Stats[i].Count = 0;
+    Stats[i].LastCycles = 0;
+    Stats[i].MaxCycles = 0;
+  }
+  Pending = 0;
+  RelayHead = 0;
+  RelayTail = 0;
+  RelayLost = 0;
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentRegister
+ Parameters
+   ES_UrgentAction_t Action : which action, from ES_Configure.h
+   ES_UrgentFunc_t *pHandler : what to do, short and ISR safe
+ Returns
+   bool : false if Action is out of range
+****************************************************************************/
+bool ES_UrgentRegister( ES_UrgentAction_t Action, ES_UrgentFunc_t *pHandler )
+{
+  if ( Action >= NUM_URGENT_ACTIONS )
+    return false;
+  Handlers[Action] = pHandler;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentRun
+ Parameters
+   ES_UrgentAction_t Action : which action
+ Returns
+   nothing
+ Description
+   runs the handler now, in the caller's context. The lowest latency path,
+   for ISRs that detect the condition themselves
+****************************************************************************/
+void ES_UrgentRun( ES_UrgentAction_t Action )
+{
+  uint32_t Start = HWREG(DWT_CYCCNT);
+
+  if ( Action < NUM_URGENT_ACTIONS )
+    RunTimed( Action, Start );
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentPend
+ Parameters
+   ES_UrgentAction_t Action : which action
+ Returns
+   nothing
+ Description
+   runs the handler from PendSV, for callers that should not do the work
+   themselves. Pending the same action twice before PendSV runs it once
+****************************************************************************/
+void ES_UrgentPend( ES_UrgentAction_t Action )
+{
+  uint32_t Start = HWREG(DWT_CYCCNT);
+  uint32_t Saved;
+
+  if ( Action >= NUM_URGENT_ACTIONS )
+    return;
+  Saved = ES_EnterCriticalAll();
+  if ( (Pending & (1UL << Action)) == 0 )
+  {
+    PendedAt[Action] = Start;
+    Pending |= (1UL << Action);
+  }
+  ES_ExitCriticalAll(Saved);
+  HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentPublish
+ Parameters
+   ES_Event ThisEvent : the event to ES_Publish
+ Returns
+   bool : false if the relay was full and the event was dropped
+ Description
+   for safety ISRs: publishes the event from PendSV, where it is safe to
+   touch the queues. Only call it from ISRs at ES_SAFETY_PRIORITY
+****************************************************************************/
+bool ES_UrgentPublish( ES_Event ThisEvent )
+{
+  uint8_t Next = (RelayHead + 1) % RELAY_SIZE;
+
+  if ( Next == RelayTail )
+  {
+    RelayLost++;
+    return false;
+  }
+  Relay[RelayHead] = ThisEvent;
+  RelayHead = Next;
+  HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentRelayLost
+ Returns
+   uint32_t : events ES_UrgentPublish dropped because the relay was full
+****************************************************************************/
+uint32_t ES_UrgentRelayLost( void )
+{
+  return RelayLost;
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentGetStats
+ Parameters
+   ES_UrgentAction_t Action : which action
+   ES_UrgentStats_t *pStats : filled with its detect to done timing
+****************************************************************************/
+void ES_UrgentGetStats( ES_UrgentAction_t Action, ES_UrgentStats_t *pStats )
+{
+  uint32_t Saved;
+
+  if ( Action >= NUM_URGENT_ACTIONS )
+    return;
+  Saved = ES_EnterCriticalAll();
+  *pStats = Stats[Action];
+  ES_ExitCriticalAll(Saved);
+}
+
+/****************************************************************************
+ Function
+   ES_UrgentPendSVHandler
+ Description
+   the PendSV vector: runs every pended action, lowest number first, then
+   publishes the relayed events in the order they came in
+****************************************************************************/
+void ES_UrgentPendSVHandler( void )
+{
+  uint32_t Saved;
+  uint32_t ToRun;
+  uint8_t Action;
+
+  Saved = ES_EnterCriticalAll();
+  ToRun = Pending;
+  Pending = 0;
+  ES_ExitCriticalAll(Saved);
+
+  for ( Action = 0; ToRun != 0; Action++, ToRun >>= 1 )
+  {
+    if ( ToRun & 1 )
+      RunTimed( Action, PendedAt[Action] );
+  }
+
+  while ( RelayTail != RelayHead )
+  {
+    ES_Publish( Relay[RelayTail] );
+    RelayTail = (RelayTail + 1) % RELAY_SIZE;
+  }
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+static void RunTimed( uint8_t Action, uint32_t Start )
+{
+  uint32_t Cycles;
+  uint32_t Saved;
+
+  if ( Handlers[Action] == 0 )
+    return;
+  Handlers[Action]();
+  Cycles = HWREG(DWT_CYCCNT) - Start;
+
+  // ES_UrgentRun callers at any priority can preempt each other here
+  Saved = ES_EnterCriticalAll();
+  Stats[Action].Count++;
+  Stats[Action].LastCycles = Cycles;
+  if ( Cycles > Stats[Action].MaxCycles )
+    Stats[Action].MaxCycles = Cycles;
+  ES_ExitCriticalAll(Saved);
+}
+/*------------------------------ End of file ------------------------------*/
@@ -2,12 +2,24 @@
 IRBeacon Module
 	Define the Initialization and ISR for the IR sensing interrupt
 	Whenever beacon is detected, post event BeaconSensed
+
+	With IR_DETECTOR set to IR_DETECT_CAPTURE_DMA, each rising edge on PC6 is a uDMA request that
+	copies the WT1A capture into one half of a ping-pong buffer instead of
+	interrupting. The only interrupt is the uDMA done, once per
+	IR_BLOCK_EDGES edges, which re-arms the half and publishes
+	IRBlockReady. ActionService hands the block back to ProcessIRBlock,
+	which measures the frequency over the whole block. The service has
+	until the other half fills (16 ms at the lab beacon frequency) to take
+	it; a half that fills again first is counted as an overrun.
  
 Events to receive:
   None
  
 Events to post:
-	TapeSensed (to ActionService)
+	IRBeaconSensed (published), carries the measured period in timer ticks
+	and the edge time
+	IRBlockReady (published), a half of the capture buffer is full
+	MOTION_DONE (to ActionService)
 ****************************************************************************/
 
 /*----------------------------- Include Files -----------------------------*/
@@ -25,18 +37,25 @@ Events to post:
 #include "ActionService.h"
 #include "TapeModule.h"
 #include "MotorActionsModule.h"
+#include "CommandOpcodes.h"
+#include "TimerManager.h"
+#include "IRBeaconModule.h"
+#include "ClockConfig.h"
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+#include "driverlib/udma.h"
+#include "DMAManager.h"
+#endif
 
 
 /*----------------------------- Module Defines ----------------------------*/
 #define ALL_BITS (0xff<<2)
-#define TicksPerMS 40000
 #define lab8BeaconFreqHz 1950
 #define BitsPerNibble 4
 #define numbNibblesShifted 6
 #define pinC6Mask 0xf0ffffff
-#define ALIGN_BEACON 0x20 
+// WT1A's uDMA channel, with its peripheral assignment
+#define IR_DMA_CHANNEL 12
 
-#define STOP 0x00
 /*---------------------------- Module Variables ---------------------------*/
 static uint32_t LastCapture;
 
@@ -50,10 +69,24 @@ static uint32_t DesiredFreqHIBoundary;
 static uint32_t MeasuredSignalPeriod;
 static uint8_t counter = 1;
 
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+// the ping-pong buffer, half 0 on the primary and half 1 on the alternate
+static uint32_t CaptureBlock[2][IR_BLOCK_EDGES];
+// IRBlockReady events per half that ProcessIRBlock has not taken yet
+static volatile uint8_t BlocksWaiting[2];
+static uint16_t BlockOverruns = 0;
+#endif
+
 //Initialize freq boundaries for IR beacon
 static uint32_t	DesiredFreqLOBoundary = lab8BeaconFreqHz - 0.2*lab8BeaconFreqHz;
 static uint32_t	DesiredFreqHIBoundary = lab8BeaconFreqHz + 0.2*lab8BeaconFreqHz;
 
+/*---------------------------- Module Functions ---------------------------*/
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+static void ArmBlocks(void);
+static void BlockFilled(uint8_t Half);
+#endif
+
 /*------------------------------ Module Code ------------------------------*/
 
 /****************************************************************************
@@ -74,28 +107,24 @@ static uint32_t	DesiredFreqHIBoundary = lab8BeaconFreqHz + 0.2*lab8BeaconFreqHz;
 ****************************************************************************/
 void InitInputCaptureForIRDetection( void )
 {
-	//Start by enabling the clock to the timer (Wide Timer 1)
-	HWREG(SYSCTL_RCGCWTIMER) |= SYSCTL_RCGCWTIMER_R1;
+	//Wide Timer 1A as a rising edge capture (interrupt 96)
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+	//with each edge a request on uDMA channel 12, encoding 3
+	if (!ClaimTimer(WT1_A, TIMER_MODE_CAPTURE_DMA, "IR beacon") ||
+	    !ClaimDMAChannel(UDMA_CH12_WTIMER1A, "IR beacon"))
+	{
+		return;
+	}
+#else
+	if (!ClaimTimer(WT1_A, TIMER_MODE_CAPTURE, "IR beacon"))
+	{
+		return;
+	}
+#endif
 	
 	//Enable the clock to Port C	
 	HWREG(SYSCTL_RCGCGPIO) |= SYSCTL_RCGCGPIO_R2;
 	
-	//Make sure that timer (Timer A) is disabled before configuring
-	HWREG(WTIMER1_BASE + TIMER_O_CTL) &= ~TIMER_CTL_TAEN;
-	
-	//Set it up in 32bit wide
-	HWREG(WTIMER1_BASE + TIMER_O_CFG) = TIMER_CFG_16_BIT;
-	
-	//Initialize the Interval Load register to 0xffff.ffff
-	HWREG(WTIMER1_BASE + TIMER_O_TAILR) = 0xffffffff;
-	
-	//Set up timer A in capture mode (TAMR=3, TAAMS = 0), for edge time (TACMR = 1) and up-counting (TACDIR = 1)
-	HWREG(WTIMER1_BASE + TIMER_O_TAMR) =
-	(HWREG(WTIMER1_BASE + TIMER_O_TAMR) & ~TIMER_TAMR_TAAMS) | (TIMER_TAMR_TACDIR | TIMER_TAMR_TACMR | TIMER_TAMR_TAMR_CAP);
-	
-	//Set the event to rising edge
-	HWREG(WTIMER1_BASE + TIMER_O_CTL) &= ~TIMER_CTL_TAEVENT_M;
-	
 	//Set up the port to do the capture  -- we will use C6 because we are using wide timer 1A
 	HWREG(GPIO_PORTC_BASE + GPIO_O_AFSEL) |= BIT6HI;
 	
@@ -108,15 +137,6 @@ void InitInputCaptureForIRDetection( void )
 	//make pin 6 on Port C into an input
 	HWREG(GPIO_PORTC_BASE + GPIO_O_DIR) &= BIT6LO;
 	
-	//Enable a local capture interrupt
-	HWREG(WTIMER1_BASE + TIMER_O_IMR) |= TIMER_IMR_CAEIM;
-	
-	//Enable the Timer A in Wide Timer 1 interrupt in the NVIC (wide timer 1A <--> interrupt 96)
-	HWREG(NVIC_EN3) |= BIT0HI;
-	
-	//Make sure interrupts are enabled globally
-	__enable_irq();
-	
 	printf("\r\nGot through IR interrupt init\r\n");
 	
 }
@@ -130,8 +150,27 @@ void InitInputCaptureForIRDetection( void )
 ****************************************************************************/
 void EnableIRInterrupt(void)
 {
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+	//Start both halves empty, whatever was left from the last search
+	ArmBlocks();
+#endif
 	//Kick timer off by enabling timer and enabling the timer to stall while stopped by the debugger
-	HWREG(WTIMER1_BASE + TIMER_O_CTL) |= (TIMER_CTL_TAEN | TIMER_CTL_TASTALL);
+	StartTimer(WT1_A);
+}
+
+/****************************************************************************
+ Function
+     DisableIRInterrupt
+
+ Description
+     No more captures until the next EnableIRInterrupt, for a search cut short
+****************************************************************************/
+void DisableIRInterrupt(void)
+{
+	StopTimer(WT1_A);
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+	DisableDMAChannel(IR_DMA_CHANNEL);
+#endif
 }
 	
 
@@ -152,13 +191,115 @@ void EnableIRInterrupt(void)
  Author
      Team 16 
 ****************************************************************************/ 
-void InputCaptureForIRDetectionResponse( void )  
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+ES_RAMFUNC void InputCaptureForIRDetectionResponse( void )  
+{
+	uint8_t Half;
+	
+	ES_ISR_ENTRY(ISR_IR_CAPTURE);
+	
+	//The uDMA done comes in on the timer's vector. Clear the capture
+	//flag as well, it is what requests the transfers
+	HWREG(WTIMER1_BASE + TIMER_O_ICR) = TIMER_ICR_CAECINT;
+	
+	for (Half = 0; Half < 2; Half++)
+	{
+		if (IsDMAHalfDone(IR_DMA_CHANNEL, Half))
+		{
+			BlockFilled(Half);
+		}
+	}
+	
+	ES_ISR_EXIT(ISR_IR_CAPTURE);
+}
+
+/****************************************************************************
+ Function
+     ProcessIRBlock
+
+ Parameters
+     uint8_t Half : the EventParam of IRBlockReady
+
+ Description
+			Called from ActionService for each IRBlockReady. The average
+			period over the block is the span of its edges over the number
+			of periods in it, which is what the per edge ISR averaged too
+****************************************************************************/
+void ProcessIRBlock(uint8_t Half)
+{
+	uint32_t const *pEdges;
+	uint32_t LastEdge;
+	uint32_t Saved;
+	ES_Event ThisEvent;
+	
+	if (Half > 1)
+	{
+		return;
+	}
+	pEdges = CaptureBlock[Half];
+	LastEdge = pEdges[IR_BLOCK_EDGES - 1];
+	MeasuredSignalPeriod = (LastEdge - pEdges[0])/(IR_BLOCK_EDGES - 1);
+	
+	//Done with the half, the ISR may report it full again from here on
+	Saved = ES_EnterCritical();
+	if (BlocksWaiting[Half] != 0)
+	{
+		BlocksWaiting[Half]--;
+	}
+	ES_ExitCritical(Saved);
+	
+	if (MeasuredSignalPeriod == 0)
+	{
+		return;
+	}
+	MeasuredSignalSpeedHz = CPU_CLOCK_HZ/MeasuredSignalPeriod;
+	AveragedMeasuredSignalSpeedHz = MeasuredSignalSpeedHz;
+	
+	if ((MeasuredSignalSpeedHz > DesiredFreqLOBoundary) && (MeasuredSignalSpeedHz < DesiredFreqHIBoundary))
+	{
+		//Found it, no more edges until the next search
+		StopTimer(WT1_A);
+		//ActionService stops the motors on the MOTION_DONE
+		PostMotionDone(DONE_ON_BEACON);
+	}
+	else
+	{
+		ThisEvent.EventType = IRBeaconSensed;
+		ThisEvent.EventParam = MeasuredSignalPeriod;
+		//The last edge on the framework clock: now, less how long ago it was
+		ES_EventSetTime(&ThisEvent, ES_Timer_GetTimeUS32() - (HWREG(WTIMER1_BASE + TIMER_O_TAV) - LastEdge)/TicksPerUS);
+		ES_Publish(ThisEvent);
+	}
+}
+
+/****************************************************************************
+ Function
+     GetIRBlockOverruns
+
+ Returns
+     uint16_t halves that filled again before ProcessIRBlock took them
+****************************************************************************/
+uint16_t GetIRBlockOverruns(void)
 {
+	return BlockOverruns;
+}
+#else
+ES_RAMFUNC void InputCaptureForIRDetectionResponse( void )  
+{
+	uint32_t EdgeTimeUS;
+	
+	ES_ISR_ENTRY(ISR_IR_CAPTURE);
+	
 	//Clear the source of the interrupt, the input capture event
 	HWREG(WTIMER1_BASE + TIMER_O_ICR) = TIMER_ICR_CAECINT;
 	
 	//Grab the captured value 
 	ThisCapture = HWREG(WTIMER1_BASE + TIMER_O_TAR);
+	ES_ISR_LATENCY(ISR_IR_CAPTURE, HWREG(WTIMER1_BASE + TIMER_O_TAV) - ThisCapture);
+	
+	//Put the edge on the framework clock: now, less how long ago it was captured
+	EdgeTimeUS = ES_Timer_GetTimeUS32() - (HWREG(WTIMER1_BASE + TIMER_O_TAV) - ThisCapture)/TicksPerUS;
+	
 	MeasuredSignalPeriod = ThisCapture - LastCapture;
 	
 	//Update LastCapture to prepare for the next edge
@@ -166,16 +307,17 @@ void InputCaptureForIRDetectionResponse( void )
 	
 	//Calculate measured signal speed 
 	//and keep count of the addition of the speeds to later calculate the average
-	MeasuredSignalSpeedHz = (1000*TicksPerMS)/MeasuredSignalPeriod;
+	MeasuredSignalSpeedHz = CPU_CLOCK_HZ/MeasuredSignalPeriod;
 	SpeedAddition += MeasuredSignalSpeedHz;
 	
 	//Check to see if we have found the beacon and if we have sent a stop event
 	if((counter>10) && (MeasuredSignalSpeedHz > DesiredFreqLOBoundary) && (MeasuredSignalSpeedHz < DesiredFreqHIBoundary)) //Post STOP event to ActionService
 	{
 		//Disable interrupt
-		HWREG(WTIMER1_BASE + TIMER_O_CTL) &= ~TIMER_CTL_TAEN;
-		//Command to stop
-		stop();
+		StopTimer(WT1_A);
+		//ActionService stops the motors on the MOTION_DONE, the ramp is
+		//not ISR safe
+		PostMotionDone(DONE_ON_BEACON);
 	}
 	else // keep looking for tape and update averaged measured signal speed
 	{
@@ -183,8 +325,275 @@ void InputCaptureForIRDetectionResponse( void )
 		SpeedAddition = 0;
 		ES_Event ThisEvent;
 		ThisEvent.EventType = IRBeaconSensed;
-		ThisEvent.EventParam = ALIGN_BEACON;
-		PostActionService(ThisEvent);
+		ThisEvent.EventParam = MeasuredSignalPeriod;
+		ES_EventSetTime(&ThisEvent, EdgeTimeUS);
+		ES_Publish(ThisEvent);
 	}
 	counter = counter + 1;
+	
+	ES_ISR_EXIT(ISR_IR_CAPTURE);
+}
+#endif
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+#if IR_DETECTOR == IR_DETECT_CAPTURE_DMA
+/****************************************************************************
+ Function
+     ArmBlocks
+
+ Description
+     Both halves armed for a full block, the primary filling first
+****************************************************************************/
+static void ArmBlocks(void)
+{
+	DisableDMAChannel(IR_DMA_CHANNEL);
+	ArmDMAFromRegister(IR_DMA_CHANNEL, false, WTIMER1_BASE + TIMER_O_TAR,
+	                   CaptureBlock[0], IR_BLOCK_EDGES);
+	ArmDMAFromRegister(IR_DMA_CHANNEL, true, WTIMER1_BASE + TIMER_O_TAR,
+	                   CaptureBlock[1], IR_BLOCK_EDGES);
+	BlocksWaiting[0] = 0;
+	BlocksWaiting[1] = 0;
+	EnableDMAChannel(IR_DMA_CHANNEL);
+}
+
+/****************************************************************************
+ Function
+     BlockFilled
+
+ Description
+     From the ISR: re-arm the half that finished, for after the other one,
+     and hand it to the service
+****************************************************************************/
+static void BlockFilled(uint8_t Half)
+{
+	ES_Event ThisEvent;
+	
+	if (BlocksWaiting[Half] != 0)
+	{
+		//The service never got to what was here before
+		BlockOverruns++;
+	}
+	BlocksWaiting[Half]++;
+	ArmDMAFromRegister(IR_DMA_CHANNEL, Half, WTIMER1_BASE + TIMER_O_TAR,
+	                   CaptureBlock[Half], IR_BLOCK_EDGES);
+	
+	ThisEvent.EventType = IRBlockReady;
+	ThisEvent.EventParam = Half;
+	ES_EventSetTime(&ThisEvent, ES_Timer_GetTimeUS32());
+	ES_Publish(ThisEvent);
+}
+#endif
+
+#if defined(TEST) && (IR_DETECTOR == IR_DETECT_CAPTURE_DMA)
+/* host simulation of the DMA capture. A beacon at a set frequency, with a
+   little jitter, drives a simulated WT1A whose captures a simulated uDMA
+   copies into the ping-pong buffer, and the real ISR is called on each
+   uDMA done. The published blocks are handed to ProcessIRBlock a set
+   delay later, standing in for ActionService. The timer registers are a
+   page of host memory mapped at WTIMER1_BASE.
+   gcc -DTEST -DIR_DETECTOR=IR_DETECT_CAPTURE_DMA -I<stubs> -IHeaders
+       Source/IRBeaconModule.c
+*/
+#include <sys/mman.h>
+#include <string.h>
+
+#define SIM_MS 2000
+#define SIM_TICKS_PER_MS TicksPerMS
+#define SIM_QUEUE 8
+
+typedef struct {
+	char const *Name;
+	uint32_t BeaconHz;
+	uint32_t ServiceDelayMS;  // from IRBlockReady to ProcessIRBlock
+	bool ExpectFound;
+	bool ExpectOverruns;
+} SimCase_t;
+
+static SimCase_t const Cases[] = {
+	{ "lab beacon",           1950,  1, true,  false },
+	{ "other beacon",         1000,  1, false, false },
+	{ "service 40 ms late",   3000, 40, false, true  },
+};
+
+// the uDMA, one descriptor per half
+static uint32_t *SimDest[2];
+static uint16_t SimLeft[2];
+static uint8_t SimActive;
+static uint32_t SimLostEdges;
+
+static bool SimTimerOn;
+static uint32_t SimNow;
+static uint32_t SimIsrCalls;
+static bool SimFound;
+static uint32_t SimBeaconEvents;
+
+// IRBlockReady events waiting for the service
+static uint8_t SimBlock[SIM_QUEUE];
+static uint32_t SimDueAt[SIM_QUEUE];
+static uint8_t SimHead;
+static uint8_t SimCount;
+static uint32_t SimDelay;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t Range)
+{
+	Seed = Seed * 1103515245UL + 12345UL;
+	return (Seed >> 8) % Range;
+}
+
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner) { return true; }
+void StartTimer(TimerChannel_t Channel) { SimTimerOn = true; }
+void StopTimer(TimerChannel_t Channel) { SimTimerOn = false; }
+bool ClaimDMAChannel(uint32_t Assignment, char const *Owner) { return true; }
+void ArmDMAFromRegister(uint8_t Channel, bool Alternate, uint32_t Register,
+                        uint32_t *pDest, uint16_t Count)
+{
+	SimDest[Alternate] = pDest;
+	SimLeft[Alternate] = Count;
+}
+bool IsDMAHalfDone(uint8_t Channel, bool Alternate) { return (SimLeft[Alternate] == 0); }
+void EnableDMAChannel(uint8_t Channel) { SimActive = 0; }
+void DisableDMAChannel(uint8_t Channel) {}
+void PostMotionDone(MotionDone_t Source) { SimFound = SimFound || (Source == DONE_ON_BEACON); }
+uint32_t ES_Timer_GetTimeUS32(void) { return SimNow/(SIM_TICKS_PER_MS/1000); }
+uint32_t ES_EnterCritical(void) { return 0; }
+void ES_ExitCritical(uint32_t Saved) {}
+void ES_IsrEntry(ES_IsrId_t Id) {}
+void ES_IsrExit(ES_IsrId_t Id) {}
+uint16_t ES_Publish(ES_Event ThisEvent)
+{
+	if (ThisEvent.EventType == IRBeaconSensed)
+	{
+		SimBeaconEvents++;
+	}
+	else if ((ThisEvent.EventType == IRBlockReady) && (SimCount < SIM_QUEUE))
+	{
+		SimBlock[(SimHead + SimCount) % SIM_QUEUE] = ThisEvent.EventParam;
+		SimDueAt[(SimHead + SimCount) % SIM_QUEUE] = SimNow + SimDelay;
+		SimCount++;
+	}
+	return 0;
+}
+
+// one rising edge: the capture, then the uDMA moving it
+static void SimEdge(uint32_t Tick)
+{
+	if (!SimTimerOn)
+	{
+		return;
+	}
+	HWREG(WTIMER1_BASE + TIMER_O_TAR) = Tick;
+	HWREG(WTIMER1_BASE + TIMER_O_TAV) = Tick;
+	if (SimLeft[SimActive] == 0)
+	{
+		// both halves full and neither re-armed, the channel has stopped
+		SimLostEdges++;
+		return;
+	}
+	*SimDest[SimActive]++ = Tick;
+	if (--SimLeft[SimActive] == 0)
+	{
+		SimActive ^= 1;
+		SimIsrCalls++;
+		InputCaptureForIRDetectionResponse();
+	}
+}
+
+// the service takes every block that is due by Tick
+static void SimService(uint32_t Tick)
+{
+	while ((SimCount != 0) && ((int32_t)(SimDueAt[SimHead] - Tick) <= 0))
+	{
+		SimNow = SimDueAt[SimHead];
+		ProcessIRBlock(SimBlock[SimHead]);
+		SimHead = (SimHead + 1) % SIM_QUEUE;
+		SimCount--;
+	}
+}
+
+static bool RunCase(SimCase_t const *pCase)
+{
+	uint32_t Period = (1000*SIM_TICKS_PER_MS)/pCase->BeaconHz;
+	uint32_t Edge = 0;
+	uint32_t Edges = 0;
+	uint32_t FoundAtEdge = 0;
+	uint16_t OverrunsBefore = GetIRBlockOverruns();
+	uint16_t Overruns;
+	bool Passed;
+
+	SimFound = false;
+	SimLostEdges = 0;
+	SimIsrCalls = 0;
+	SimBeaconEvents = 0;
+	SimHead = 0;
+	SimCount = 0;
+	SimDelay = pCase->ServiceDelayMS*SIM_TICKS_PER_MS;
+	AveragedMeasuredSignalSpeedHz = 0;
+	EnableIRInterrupt();
+
+	while (Edge < SIM_MS*SIM_TICKS_PER_MS)
+	{
+		SimService(Edge);
+		SimNow = Edge;
+		if (SimTimerOn)
+		{
+			Edges++;
+		}
+		SimEdge(Edge);
+		if (SimFound && (FoundAtEdge == 0))
+		{
+			FoundAtEdge = Edges;
+		}
+		// +-0.5% jitter on each period
+		Edge += Period - Period/200 + Random(Period/100 + 1);
+	}
+	SimService(Edge + SimDelay);
+	Overruns = GetIRBlockOverruns() - OverrunsBefore;
+
+	Passed = (SimFound == pCase->ExpectFound) && ((Overruns != 0) == pCase->ExpectOverruns);
+	if (!pCase->ExpectOverruns)
+	{
+		// within 1% of the beacon
+		Passed = Passed && (AveragedMeasuredSignalSpeedHz*100 > pCase->BeaconHz*99) &&
+		         (AveragedMeasuredSignalSpeedHz*100 < pCase->BeaconHz*101);
+	}
+	printf("%-20s %6lu %5lu %5lu %6lu Hz  %-10s %4u %5lu  %s\r\n", pCase->Name,
+	       (unsigned long)Edges, (unsigned long)SimIsrCalls,
+	       (unsigned long)(SimIsrCalls ? Edges/SimIsrCalls : 0),
+	       (unsigned long)AveragedMeasuredSignalSpeedHz,
+	       SimFound ? "found" : "not found", Overruns, (unsigned long)SimLostEdges,
+	       Passed ? "ok" : "FAILED");
+	if (SimFound)
+	{
+		printf("%20s found on edge %lu\r\n", "", (unsigned long)FoundAtEdge);
+	}
+	return Passed;
+}
+
+int main(void)
+{
+	uint8_t Failures = 0;
+	uint8_t i;
+
+	if (mmap((void *)WTIMER1_BASE, 0x1000, PROT_READ | PROT_WRITE,
+	         MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		printf("could not map the simulated timer\r\n");
+		return 1;
+	}
+	printf("\r\n%d ms per case, %d edges per block\r\n", SIM_MS, IR_BLOCK_EDGES);
+	printf("case                  edges  ints  x    measured  beacon    over  lost\r\n");
+	for (i = 0; i < sizeof(Cases)/sizeof(Cases[0]); i++)
+	{
+		if (!RunCase(&Cases[i]))
+		{
+			Failures++;
+		}
+	}
+	printf("%u failures\r\n", Failures);
+	return Failures;
 }
+#endif
@@ -0,0 +1,593 @@
+/****************************************************************************
+IR Demodulator Module
+	Tell the beacons apart by the strength of their frequencies in the
+	photodiode signal rather than by timing its edges, so several beacons
+	in view at once, or a beacon against ambient IR, are still recognised.
+
+	ADC1 sequence 3 samples the photodiode on PE5 (AIN8) at
+	IR_DEMOD_SAMPLE_HZ, triggered by Wide Timer 4B, and each result is moved
+	by uDMA into one half of a ping-pong buffer. The only interrupt is the
+	uDMA done, once a block, which re-arms the half and publishes
+	IRSamplesReady. ActionService hands the block back to ProcessIRSamples,
+	which takes out the ambient level and runs a Goertzel filter per beacon
+	frequency over it (DSPKernels).
+
+	A beacon is in view when its tone is at least MIN_AMPLITUDE counts, and
+	of those the strongest is the beacon reported. Lamp flicker at 100 or
+	120 Hz and the ambient level are many bins away from every beacon, so
+	they are not compared against: the AC level of the whole block is only
+	kept for PrintIRDemodStats, to set MIN_AMPLITUDE against.
+
+Events to receive:
+  None
+
+Events to post:
+	IRSamplesReady (published), a half of the sample buffer is full
+	IRBeaconClassified (published), when the strongest beacon changes, the
+	beacon (or BEACON_NONE) as the param
+	MOTION_DONE (to ActionService), when the search target is found
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_adc.h"
+#include "inc/hw_nvic.h"
+#include "driverlib/udma.h"
+#include "BITDEFS.H"
+
+#include "ActionService.h"
+#include "MotorActionsModule.h"
+#include "TimerManager.h"
+#include "DMAManager.h"
+#include "DSPKernels.h"
+#include "IRDemodModule.h"
+#include "ClockConfig.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#if CPU_CLOCK_HZ % IR_DEMOD_SAMPLE_HZ != 0
+#error the sample timer cannot divide CPU_CLOCK_HZ down to IR_DEMOD_SAMPLE_HZ
+#endif
+// ADC1 sequence 3's uDMA channel, with its peripheral assignment
+#define IR_ADC_DMA_CHANNEL 27
+// the photodiode input
+#define IR_ADC_CHANNEL 8
+// smallest tone amplitude taken for a beacon, in ADC counts
+#define MIN_AMPLITUDE 20
+// Q15 samples are ADC counts shifted up 3
+#define ADC_TO_Q15_SHIFT 3
+
+/*---------------------------- Module Types -------------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+static void ArmBlocks(void);
+static void BlockFilled(uint8_t Half);
+static Beacon_t Demodulate(uint32_t const *pSamples);
+
+/*---------------------------- Module Variables ---------------------------*/
+// filter frequency of each beacon, in Beacon_t order
+static uint16_t const BeaconFreqHz[NUM_BEACONS] = {
+	[BEACON_LAB]  = 1950,
+	[BEACON_909]  = 909,
+	[BEACON_1250] = 1250,
+	[BEACON_3333] = 3333,
+};
+static int32_t BeaconCoef[NUM_BEACONS];
+
+// the ping-pong buffer, half 0 on the primary and half 1 on the alternate
+static uint32_t SampleBlock[2][IR_DEMOD_BLOCK];
+// IRSamplesReady events per half that ProcessIRSamples has not taken yet
+static volatile uint8_t BlocksWaiting[2];
+static uint16_t BlockOverruns = 0;
+// the block being filtered, as Q15 pairs with the ambient level taken out
+static int32_t Pairs[IR_DEMOD_BLOCK/2];
+
+static uint16_t Amplitude[NUM_BEACONS];
+// RMS of the block with the ambient level taken out, ADC counts
+static uint16_t BlockRMS = 0;
+static Beacon_t Reported = BEACON_NONE;
+// beacon that ends the search, BEACON_NONE to only report
+static Beacon_t SearchTarget = BEACON_NONE;
+
+// filtering cost, from the DWT cycle counter
+static uint32_t BlocksDone = 0;
+static uint32_t LastCycles = 0;
+static uint32_t MaxCycles = 0;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     InitIRDemod
+
+ Description
+     ADC1 sequence 3 on AIN8, triggered by Wide Timer 4B, with its results
+     moved by uDMA channel 27. Left stopped
+****************************************************************************/
+void InitIRDemod(void)
+{
+	uint8_t i;
+
+	if (!ClaimTimer(WT4_B, TIMER_MODE_ADC_TRIGGER, "IR demod sampling") ||
+	    !ClaimDMAChannel(UDMA_CH27_ADC1_3, "IR demod"))
+	{
+		return;
+	}
+	SetTimerLoad(WT4_B, CPU_CLOCK_HZ/IR_DEMOD_SAMPLE_HZ);
+
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		BeaconCoef[i] = GoertzelCoefficient(BeaconFreqHz[i], IR_DEMOD_SAMPLE_HZ);
+	}
+
+	//PE5 as an analog input
+	HWREG(SYSCTL_RCGCGPIO) |= SYSCTL_RCGCGPIO_R4;
+	while ((HWREG(SYSCTL_PRGPIO) & SYSCTL_PRGPIO_R4) != SYSCTL_PRGPIO_R4)
+		;
+	HWREG(GPIO_PORTE_BASE + GPIO_O_DIR) &= BIT5LO;
+	HWREG(GPIO_PORTE_BASE + GPIO_O_AFSEL) |= BIT5HI;
+	HWREG(GPIO_PORTE_BASE + GPIO_O_DEN) &= BIT5LO;
+	HWREG(GPIO_PORTE_BASE + GPIO_O_AMSEL) |= BIT5HI;
+
+	//Clock ADC1
+	HWREG(SYSCTL_RCGCADC) |= SYSCTL_RCGCADC_R1;
+	while ((HWREG(SYSCTL_PRADC) & SYSCTL_PRADC_R1) != SYSCTL_PRADC_R1)
+		;
+
+	//Sequence 3 off while it is set up
+	HWREG(ADC1_BASE + ADC_O_ACTSS) &= ~ADC_ACTSS_ASEN3;
+	//Started by the timer
+	HWREG(ADC1_BASE + ADC_O_EMUX) = (HWREG(ADC1_BASE + ADC_O_EMUX) & ~ADC_EMUX_EM3_M) | ADC_EMUX_EM3_TIMER;
+	//One sample of AIN8, whose end requests the uDMA
+	HWREG(ADC1_BASE + ADC_O_SSMUX3) = IR_ADC_CHANNEL;
+	HWREG(ADC1_BASE + ADC_O_SSCTL3) = ADC_SSCTL3_IE0 | ADC_SSCTL3_END0;
+	//The interrupt only comes from the uDMA done
+	HWREG(ADC1_BASE + ADC_O_IM) |= ADC_IM_MASK3;
+	HWREG(ADC1_BASE + ADC_O_ACTSS) |= ADC_ACTSS_ASEN3;
+
+	//ADC1 sequence 3 is interrupt 51
+	HWREG(NVIC_EN1) = BIT19HI;
+
+	printf("\r\nGot through IR demodulator init\r\n");
+}
+
+/****************************************************************************
+ Function
+     StartIRDemod
+
+ Parameters
+     Beacon_t Target : beacon that stops the motors and posts MOTION_DONE
+       when it is the strongest, BEACON_NONE to only publish the beacons seen
+****************************************************************************/
+void StartIRDemod(Beacon_t Target)
+{
+	StopIRDemod();
+	Reported = BEACON_NONE;
+	SearchTarget = Target;
+	ArmBlocks();
+	StartTimer(WT4_B);
+}
+
+/****************************************************************************
+ Function
+     StopIRDemod
+****************************************************************************/
+void StopIRDemod(void)
+{
+	StopTimer(WT4_B);
+	DisableDMAChannel(IR_ADC_DMA_CHANNEL);
+}
+
+/****************************************************************************
+ Function
+     IRDemodISR
+
+ Description
+     ADC1 sequence 3 interrupt, which only comes from the uDMA done
+****************************************************************************/
+void IRDemodISR(void)
+{
+	uint8_t Half;
+
+	ES_ISR_ENTRY(ISR_IR_ADC);
+
+	HWREG(ADC1_BASE + ADC_O_ISC) = ADC_ISC_IN3;
+
+	for (Half = 0; Half < 2; Half++)
+	{
+		if (IsDMAHalfDone(IR_ADC_DMA_CHANNEL, Half))
+		{
+			BlockFilled(Half);
+		}
+	}
+
+	ES_ISR_EXIT(ISR_IR_ADC);
+}
+
+/****************************************************************************
+ Function
+     ProcessIRSamples
+
+ Parameters
+     uint8_t Half : the EventParam of IRSamplesReady
+
+ Description
+     Called from ActionService for each IRSamplesReady. The service has
+     until the other half fills, IR_DEMOD_BLOCK samples later, to take it
+****************************************************************************/
+void ProcessIRSamples(uint8_t Half)
+{
+	uint32_t Start;
+	uint32_t Saved;
+	Beacon_t Strongest;
+	ES_Event ThisEvent;
+
+	if (Half > 1)
+	{
+		return;
+	}
+	Start = HWREG(DWT_CYCCNT);
+	Strongest = Demodulate(SampleBlock[Half]);
+	LastCycles = HWREG(DWT_CYCCNT) - Start;
+	if (LastCycles > MaxCycles)
+	{
+		MaxCycles = LastCycles;
+	}
+	BlocksDone++;
+
+	//Done with the half, the ISR may report it full again from here on
+	Saved = ES_EnterCritical();
+	if (BlocksWaiting[Half] != 0)
+	{
+		BlocksWaiting[Half]--;
+	}
+	ES_ExitCritical(Saved);
+
+	if (Strongest == Reported)
+	{
+		return;
+	}
+	Reported = Strongest;
+	if ((Reported != BEACON_NONE) && (Reported == SearchTarget))
+	{
+		//Found it, nothing more to sample until the next search
+		StopIRDemod();
+		stop();
+		PostMotionDone(DONE_ON_BEACON);
+	}
+	ThisEvent.EventType = IRBeaconClassified;
+	ThisEvent.EventParam = Reported;
+	ES_EventSetTime(&ThisEvent, ES_Timer_GetTimeUS32());
+	ES_Publish(ThisEvent);
+}
+
+/****************************************************************************
+ Function
+     QueryDemodBeacon
+
+ Returns
+     Beacon_t the strongest beacon in the last block
+****************************************************************************/
+Beacon_t QueryDemodBeacon(void)
+{
+	return Reported;
+}
+
+/****************************************************************************
+ Function
+     GetBeaconAmplitudes
+
+ Parameters
+     uint16_t *pAmplitudes : NUM_BEACONS entries, in ADC counts
+****************************************************************************/
+void GetBeaconAmplitudes(uint16_t *pAmplitudes)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		pAmplitudes[i] = Amplitude[i];
+	}
+}
+
+/****************************************************************************
+ Function
+     PrintIRDemodStats
+****************************************************************************/
+void PrintIRDemodStats(void)
+{
+	uint8_t i;
+
+	printf("\r\nIR demod: %lu blocks, %u overruns, %lu cycles a block (max %lu), %lu a sample\r\n",
+	       (unsigned long)BlocksDone, BlockOverruns, (unsigned long)LastCycles,
+	       (unsigned long)MaxCycles, (unsigned long)(LastCycles/IR_DEMOD_BLOCK));
+	printf("  block rms    %4u counts\r\n", BlockRMS);
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		printf("  %-12s %4u counts\r\n", GetBeaconName((Beacon_t)i), Amplitude[i]);
+	}
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     ArmBlocks
+
+ Description
+     Both halves armed for a full block, the primary filling first
+****************************************************************************/
+static void ArmBlocks(void)
+{
+	DisableDMAChannel(IR_ADC_DMA_CHANNEL);
+	ArmDMAFromRegister(IR_ADC_DMA_CHANNEL, false, ADC1_BASE + ADC_O_SSFIFO3,
+	                   SampleBlock[0], IR_DEMOD_BLOCK);
+	ArmDMAFromRegister(IR_ADC_DMA_CHANNEL, true, ADC1_BASE + ADC_O_SSFIFO3,
+	                   SampleBlock[1], IR_DEMOD_BLOCK);
+	BlocksWaiting[0] = 0;
+	BlocksWaiting[1] = 0;
+	EnableDMAChannel(IR_ADC_DMA_CHANNEL);
+}
+
+/****************************************************************************
+ Function
+     BlockFilled
+
+ Description
+     From the ISR: re-arm the half that finished, for after the other one,
+     and hand it to the service
+****************************************************************************/
+static void BlockFilled(uint8_t Half)
+{
+	ES_Event ThisEvent;
+
+	if (BlocksWaiting[Half] != 0)
+	{
+		//The service never got to what was here before
+		BlockOverruns++;
+	}
+	BlocksWaiting[Half]++;
+	ArmDMAFromRegister(IR_ADC_DMA_CHANNEL, Half, ADC1_BASE + ADC_O_SSFIFO3,
+	                   SampleBlock[Half], IR_DEMOD_BLOCK);
+
+	ThisEvent.EventType = IRSamplesReady;
+	ThisEvent.EventParam = Half;
+	ES_EventSetTime(&ThisEvent, ES_Timer_GetTimeUS32());
+	ES_Publish(ThisEvent);
+}
+
+/****************************************************************************
+ Function
+     Demodulate
+
+ Returns
+     Beacon_t the strongest beacon in view in the block, BEACON_NONE if
+     none is
+
+ Description
+     The Goertzel power of a tone of amplitude A is (N*A/2)^2
+****************************************************************************/
+static Beacon_t Demodulate(uint32_t const *pSamples)
+{
+	uint64_t Power;
+	Beacon_t Strongest = BEACON_NONE;
+	uint16_t StrongestAmplitude = 0;
+	uint8_t i;
+
+	PackRemoveMean(pSamples, Pairs, IR_DEMOD_BLOCK);
+	BlockRMS = Sqrt64(PairEnergy(Pairs, IR_DEMOD_BLOCK/2)/IR_DEMOD_BLOCK) >> ADC_TO_Q15_SHIFT;
+
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		Power = GoertzelPower(BeaconCoef[i], Pairs, IR_DEMOD_BLOCK/2);
+		Amplitude[i] = (2*Sqrt64(Power)/IR_DEMOD_BLOCK) >> ADC_TO_Q15_SHIFT;
+		if ((Amplitude[i] >= MIN_AMPLITUDE) && (Amplitude[i] > StrongestAmplitude))
+		{
+			Strongest = (Beacon_t)i;
+			StrongestAmplitude = Amplitude[i];
+		}
+	}
+	return Strongest;
+}
+
+#ifdef TEST
+/* host simulation of the demodulator on synthetic photodiode blocks: the
+   beacons are square waves, the ambient IR is a large DC level with 120 Hz
+   lamp flicker, plus noise. Each case is a run of blocks with the beacons
+   in view changing part way, and the reports published are checked. The
+   DWT cycle counter is a page of host memory at its address.
+   gcc -c -I<stubs> -IHeaders Source/DSPKernels.c
+   gcc -DTEST -I<stubs> -IHeaders Source/IRDemodModule.c DSPKernels.o -lm
+*/
+#include <sys/mman.h>
+#include <math.h>
+
+#define MAX_PHASES 4
+#define MAX_REPORTS 8
+
+typedef struct {
+	uint16_t Blocks;
+	uint16_t BeaconHz[2];     // 0 for none
+	uint16_t BeaconCounts[2]; // square wave amplitude, ADC counts
+	uint16_t FlickerCounts;
+} SimPhase_t;
+
+typedef struct {
+	char const *Name;
+	Beacon_t Target;
+	SimPhase_t Phases[MAX_PHASES];
+	Beacon_t Expected[MAX_REPORTS];
+	uint8_t NumExpected;
+} SimCase_t;
+
+static SimCase_t const Cases[] = {
+	{ "lab beacon in flicker", BEACON_NONE,
+	  { { 3, { 0, 0 }, { 0, 0 }, 600 }, { 5, { 1950, 0 }, { 150, 0 }, 600 },
+	    { 3, { 0, 0 }, { 0, 0 }, 600 } },
+	  { BEACON_LAB, BEACON_NONE }, 2 },
+	{ "two beacons at once", BEACON_NONE,
+	  { { 4, { 909, 3333 }, { 300, 120 }, 200 }, { 4, { 909, 3333 }, { 100, 400 }, 200 },
+	    { 4, { 1250, 0 }, { 60, 0 }, 200 } },
+	  { BEACON_909, BEACON_3333, BEACON_1250 }, 3 },
+	{ "too weak", BEACON_NONE,
+	  { { 6, { 1950, 0 }, { 12, 0 }, 100 } },
+	  { BEACON_NONE }, 0 },
+	{ "stop on lab beacon", BEACON_LAB,
+	  { { 2, { 1250, 0 }, { 200, 0 }, 300 }, { 4, { 1250, 1950 }, { 200, 250 }, 300 } },
+	  { BEACON_1250, BEACON_LAB }, 2 },
+};
+
+static Beacon_t SimReports[MAX_REPORTS];
+static uint8_t SimNumReports;
+static bool SimStopped;
+static uint32_t SimSample;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t Range)
+{
+	Seed = Seed * 1103515245UL + 12345UL;
+	return (Seed >> 8) % Range;
+}
+
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner) { return true; }
+void SetTimerLoad(TimerChannel_t Channel, uint32_t Ticks) {}
+void StartTimer(TimerChannel_t Channel) {}
+void StopTimer(TimerChannel_t Channel) {}
+bool ClaimDMAChannel(uint32_t Assignment, char const *Owner) { return true; }
+void ArmDMAFromRegister(uint8_t Channel, bool Alternate, uint32_t Register,
+                        uint32_t *pDest, uint16_t Count) {}
+bool IsDMAHalfDone(uint8_t Channel, bool Alternate) { return false; }
+void EnableDMAChannel(uint8_t Channel) {}
+void DisableDMAChannel(uint8_t Channel) {}
+void stop(void) { SimStopped = true; }
+void PostMotionDone(MotionDone_t Source) {}
+char const *GetBeaconName(Beacon_t Beacon) { return "beacon"; }
+uint32_t ES_Timer_GetTimeUS32(void) { return 0; }
+uint32_t ES_EnterCritical(void) { return 0; }
+void ES_ExitCritical(uint32_t Saved) {}
+void ES_IsrEntry(ES_IsrId_t Id) {}
+void ES_IsrExit(ES_IsrId_t Id) {}
+uint16_t ES_Publish(ES_Event ThisEvent)
+{
+	if ((ThisEvent.EventType == IRBeaconClassified) && (SimNumReports < MAX_REPORTS))
+	{
+		SimReports[SimNumReports++] = (Beacon_t)ThisEvent.EventParam;
+	}
+	return 0;
+}
+
+// a square wave of amplitude Counts around 0, at Hz, at sample n
+static int32_t Square(uint32_t Hz, uint32_t Counts, uint32_t n)
+{
+	return (((2*Hz*n)/IR_DEMOD_SAMPLE_HZ) & 1) ? -(int32_t)Counts : (int32_t)Counts;
+}
+
+static void MakeBlock(SimPhase_t const *pPhase, uint32_t *pSamples)
+{
+	int32_t Sample;
+	uint16_t i;
+	uint8_t b;
+
+	for (i = 0; i < IR_DEMOD_BLOCK; i++, SimSample++)
+	{
+		// lamps flicker with the rectified 60 Hz mains
+		Sample = 1500 + (int32_t)(pPhase->FlickerCounts*
+		         fabs(sin(2*3.14159265*60*SimSample/IR_DEMOD_SAMPLE_HZ))) +
+		         (int32_t)Random(21) - 10;
+		for (b = 0; b < 2; b++)
+		{
+			if (pPhase->BeaconHz[b] != 0)
+			{
+				Sample += Square(pPhase->BeaconHz[b], pPhase->BeaconCounts[b], SimSample);
+			}
+		}
+		pSamples[i] = (Sample < 0) ? 0 : ((Sample > 0xfff) ? 0xfff : Sample);
+	}
+}
+
+static bool RunCase(SimCase_t const *pCase)
+{
+	uint16_t Amplitudes[NUM_BEACONS];
+	uint16_t Block;
+	uint8_t p;
+	uint8_t i;
+	bool Passed;
+
+	SimNumReports = 0;
+	SimStopped = false;
+	SimSample = Random(IR_DEMOD_SAMPLE_HZ);
+	StartIRDemod(pCase->Target);
+
+	for (p = 0; (p < MAX_PHASES) && (pCase->Phases[p].Blocks != 0); p++)
+	{
+		for (Block = 0; Block < pCase->Phases[p].Blocks; Block++)
+		{
+			if (SimStopped)
+			{
+				break;
+			}
+			MakeBlock(&pCase->Phases[p], SampleBlock[Block & 1]);
+			BlocksWaiting[Block & 1]++;
+			ProcessIRSamples(Block & 1);
+		}
+	}
+
+	GetBeaconAmplitudes(Amplitudes);
+	printf("%-22s %4u %4u %4u %4u  ", pCase->Name, Amplitudes[BEACON_LAB],
+	       Amplitudes[BEACON_909], Amplitudes[BEACON_1250], Amplitudes[BEACON_3333]);
+	for (i = 0; i < SimNumReports; i++)
+	{
+		printf("%s%u", i ? ", " : "", SimReports[i]);
+	}
+	Passed = (SimNumReports == pCase->NumExpected);
+	for (i = 0; Passed && (i < SimNumReports); i++)
+	{
+		Passed = (SimReports[i] == pCase->Expected[i]);
+	}
+	if (pCase->Target != BEACON_NONE)
+	{
+		Passed = Passed && SimStopped;
+		printf(SimStopped ? "  stopped" : "  not stopped");
+	}
+	printf("  %s\r\n", Passed ? "ok" : "FAILED");
+	return Passed;
+}
+
+int main(void)
+{
+	uint8_t Failures = 0;
+	uint8_t i;
+
+	if (mmap((void *)(DWT_CYCCNT & ~0xfffUL), 0x1000, PROT_READ | PROT_WRITE,
+	         MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		printf("could not map the simulated cycle counter\r\n");
+		return 1;
+	}
+	for (i = 0; i < NUM_BEACONS; i++)
+	{
+		BeaconCoef[i] = GoertzelCoefficient(BeaconFreqHz[i], IR_DEMOD_SAMPLE_HZ);
+	}
+
+	printf("\r\n%u samples at %u Hz, last block amplitudes in counts\r\n",
+	       IR_DEMOD_BLOCK, IR_DEMOD_SAMPLE_HZ);
+	printf("case                    lab  909 1250 3333  reports (Beacon_t)\r\n");
+	for (i = 0; i < sizeof(Cases)/sizeof(Cases[0]); i++)
+	{
+		if (!RunCase(&Cases[i]))
+		{
+			Failures++;
+		}
+	}
+	printf("%u failures\r\n", Failures);
+	return Failures;
+}
+#endif
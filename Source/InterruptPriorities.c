@@ -0,0 +1,178 @@
+/****************************************************************************
+Interrupt Priorities
+	Every interrupt priority in the project, in one table, so the levels the
+	framework critical regions depend on are not scattered across the init
+	functions.
+
+	Lower numbers preempt. From the top:
+	  ES_SAFETY_PRIORITY   motor safety ISRs, never masked by ES_EnterCritical
+	  ES_CRITICAL_CEILING  PendSV, runs the urgent actions that post
+	  ES_ISR_PRIORITY      the other hardware ISRs and the framework tick
+	  ES_BAND_n_PRIORITY   the software triggered scheduler bands
+	An interrupt that is not in the table stays at 0, above the ceiling, so
+	a new ISR that calls the framework must be added here.
+	PrintInterruptPriorities flags any enabled interrupt missing from it.
+
+	The table also names each ISR's ES_IsrProfile entry, so one report
+	covers priority, time in the ISR and latency from the hardware event.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_nvic.h"
+#include "driverlib/interrupt.h"
+
+#include "InterruptPriorities.h"
+#include "ClockConfig.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// the TM4C123 implements the top 3 bits of each 8 bit priority field
+#define PRIORITY_SHIFT 5
+
+// for the table entries ES_IsrProfile does not time
+#define NOT_PROFILED NUM_ES_ISRS
+
+// peripheral interrupt n is exception n + 16, enabled in NVIC_ENn
+#define FIRST_PERIPHERAL_INT 16
+#define NUM_PERIPHERAL_INTS 139
+
+/*---------------------------- Module Types -------------------------------*/
+typedef struct {
+	uint8_t Interrupt;    // exception number, as in hw_ints.h
+	uint8_t Priority;     // 0 (highest) to 7
+	ES_IsrId_t Profile;   // its ES_IsrProfile entry, or NOT_PROFILED
+	char const *Name;
+} InterruptPriority_t;
+
+/*---------------------------- Module Variables ---------------------------*/
+static InterruptPriority_t const PriorityTable[] = {
+	{ INT_WTIMER0A,  ES_SAFETY_PRIORITY,  ISR_TAPE,           "tape capture" },
+	{ INT_WTIMER0B,  ES_SAFETY_PRIORITY,  ISR_TURN_ONESHOT,   "turn one-shot" },
+	{ FAULT_PENDSV,  ES_CRITICAL_CEILING, NOT_PROFILED,       "urgent actions (PendSV)" },
+	{ INT_SSI0,      ES_ISR_PRIORITY,     ISR_SPI,            "SPI" },
+	{ INT_WTIMER1A,  ES_ISR_PRIORITY,     ISR_IR_CAPTURE,     "IR capture" },
+	{ INT_WTIMER2A,  ES_ISR_PRIORITY,     ISR_LEFT_ENCODER,   "left encoder" },
+	{ INT_WTIMER2B,  ES_ISR_PRIORITY,     ISR_RIGHT_ENCODER,  "right encoder" },
+	{ INT_WTIMER3A,  ES_ISR_PRIORITY,     ISR_MOTION_PROFILE, "motion profile" },
+	{ INT_WTIMER4A,  ES_ISR_PRIORITY,     ISR_BEACON_GATE,    "beacon gate" },
+	{ INT_ADC1SS3,   ES_ISR_PRIORITY,     ISR_IR_ADC,         "IR samples" },
+	{ INT_TIMER5A,   ES_ISR_PRIORITY,     ISR_SHORT_TIMER,    "short timer" },
+	{ FAULT_SYSTICK, ES_ISR_PRIORITY,     ISR_SYSTICK,        "framework tick" },
+	{ INT_GPIOG,     ES_BAND_1_PRIORITY,  NOT_PROFILED,       "scheduler band 1" },
+	{ INT_GPIOH,     ES_BAND_2_PRIORITY,  NOT_PROFILED,       "scheduler band 2" },
+};
+
+#define NUM_PRIORITIES (sizeof(PriorityTable)/sizeof(PriorityTable[0]))
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     ApplyInterruptPriorities
+
+ Description
+     Write the table into the NVIC and system handler priority registers.
+     Call before ES_Initialize, so nothing is enabled at the reset priority
+****************************************************************************/
+void ApplyInterruptPriorities(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUM_PRIORITIES; i++)
+	{
+		IntPrioritySet(PriorityTable[i].Interrupt,
+		               PriorityTable[i].Priority << PRIORITY_SHIFT);
+	}
+}
+
+/****************************************************************************
+ Function
+     PrintInterruptPriorities
+
+ Description
+     Dump the table as read back from the hardware, then every enabled
+     interrupt that is not in it. Call once the inits have enabled theirs
+****************************************************************************/
+void PrintInterruptPriorities(void)
+{
+	uint8_t i;
+	uint8_t Interrupt;
+
+	printf("\r\ninterrupt priorities, critical ceiling %u\r\n", ES_CRITICAL_CEILING);
+	for (i = 0; i < NUM_PRIORITIES; i++)
+	{
+		printf("  %3u %u %s\r\n", PriorityTable[i].Interrupt,
+		       (unsigned)(IntPriorityGet(PriorityTable[i].Interrupt) >> PRIORITY_SHIFT),
+		       PriorityTable[i].Name);
+	}
+	for (Interrupt = 0; Interrupt < NUM_PERIPHERAL_INTS; Interrupt++)
+	{
+		if ((HWREG(NVIC_EN0 + 4*(Interrupt/32)) & (1UL << (Interrupt % 32))) == 0)
+		{
+			continue;
+		}
+		for (i = 0; i < NUM_PRIORITIES; i++)
+		{
+			if (PriorityTable[i].Interrupt == Interrupt + FIRST_PERIPHERAL_INT)
+			{
+				break;
+			}
+		}
+		if (i == NUM_PRIORITIES)
+		{
+			printf("  %3u enabled but not in the table, left at priority %u\r\n",
+			       Interrupt + FIRST_PERIPHERAL_INT,
+			       (unsigned)(IntPriorityGet(Interrupt + FIRST_PERIPHERAL_INT) >> PRIORITY_SHIFT));
+		}
+	}
+}
+
+/****************************************************************************
+ Function
+     PrintInterruptProfile
+
+ Description
+     Count, average and worst time in each profiled ISR and its worst
+     latency from the hardware event, in CPU cycles with the worst cases
+     also in uS. A latency of - means the ISR has no hardware time to
+     measure it from
+****************************************************************************/
+void PrintInterruptProfile(void)
+{
+	ES_IsrStats_t Stats;
+	uint8_t i;
+
+	printf("\r\nISR profile, cycles      count    avg    max (  us)  latency (  us)\r\n");
+	for (i = 0; i < NUM_PRIORITIES; i++)
+	{
+		if (PriorityTable[i].Profile == NOT_PROFILED)
+		{
+			continue;
+		}
+		ES_GetIsrStats(PriorityTable[i].Profile, &Stats);
+		printf("  %-20s %7lu %6lu %6lu (%4lu)", PriorityTable[i].Name,
+		       (unsigned long)Stats.Count,
+		       (unsigned long)ES_IsrAverageCycles(&Stats),
+		       (unsigned long)Stats.MaxCycles,
+		       (unsigned long)(Stats.MaxCycles/TicksPerUS));
+		if (Stats.Latencies != 0)
+		{
+			printf("  %7lu (%4lu)\r\n", (unsigned long)Stats.MaxLatency,
+			       (unsigned long)(Stats.MaxLatency/TicksPerUS));
+		}
+		else
+		{
+			printf("        -\r\n");
+		}
+	}
+}
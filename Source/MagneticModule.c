@@ -26,11 +26,11 @@ Events to post:
 #include "TapeModule.h"
 #include "MotorActionsModule.h"
 #include "MagneticModule.h"
+#include "ClockConfig.h"
 
 
 /*----------------------------- Module Defines ----------------------------*/
 #define ALL_BITS (0xff<<2)
-#define TicksPerMS 40000
 #define BitsPerNibble 4
 //#define numbNibblesShifted 6
 //#define pinC6Mask 0xf0ffffff
@@ -108,10 +108,7 @@ int CheckWirePosition(void)
   
   // Get the voltages from the input line	
   ADC_MultiRead(CurrentADRead);
-	printf("\n--------------PE0 Voltage = %u, PE1 Voltage = %u---------------\n",CurrentADRead[0],CurrentADRead[1]);
-	
 	VoltageDifference = CurrentADRead[1] - CurrentADRead[0];
-	printf("\n--------------Voltage Difference = %u---------------\n",VoltageDifference);
 	return VoltageDifference;
 }
 	
@@ -0,0 +1,527 @@
+/****************************************************************************
+Motion Profile Module
+	Ramp the wheel duty cycles toward their targets at a fixed slew rate
+	instead of stepping them, to keep the wheels from slipping on starts,
+	stops and direction changes.
+
+	SetMotionTarget precomputes every step of the ramp as PWM register
+	images. The Wide Timer 3A periodic interrupt then only copies the next image
+	into the PWM generators, so the ISR does no arithmetic.
+
+	The urgent stop halts the profile from a safety ISR, above the framework's
+	critical ceiling, so the step variables are guarded with every interrupt
+	off (ES_EnterCriticalAll) to keep a step from being written after the stop.
+	A halt that lands while SetMotionTarget is building a ramp is counted, so
+	the interrupted call drops its ramp instead of restarting the motors.
+
+Events to receive:
+  None
+
+Events to post:
+	None directly, the profile done hook is called when a ramp finishes
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_nvic.h"
+#include "BITDEFS.H"
+
+#include "PWMmodule.h"
+#include "MotionProfileModule.h"
+#include "TimerManager.h"
+#include "ClockConfig.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define FORWARD 1
+#define BACKWARD 0
+
+#define LEFT 1
+#define RIGHT 0
+
+// worst case ramp is full reverse to full forward
+#define MAX_DUTY_SWING 200
+#define MAX_PROFILE_STEPS ((MAX_DUTY_SWING + DUTY_SLEW_PER_TICK - 1)/DUTY_SLEW_PER_TICK)
+
+/*---------------------------- Module Types -------------------------------*/
+typedef struct {
+	PWMImage_t Left;
+	PWMImage_t Right;
+} ProfileStep_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+static void InitProfileTimer(void);
+static void StartProfileTimer(void);
+static void StopProfileTimer(void);
+
+/*---------------------------- Module Variables ---------------------------*/
+// precomputed register images, one entry per profile tick
+static ProfileStep_t ProfileSteps[MAX_PROFILE_STEPS];
+// signed duty (+ forward, - backward) commanded at each step
+static int8_t LeftDutyAtStep[MAX_PROFILE_STEPS];
+static int8_t RightDutyAtStep[MAX_PROFILE_STEPS];
+
+static volatile uint8_t NumSteps = 0;
+static volatile uint8_t NextStep = 0;
+// bumped by every halt, so a ramp being built can tell it was stopped
+static volatile uint8_t HaltCount = 0;
+
+// signed duty actually on the motors, updated as steps are written
+static volatile int8_t LeftDutyNow = 0;
+static volatile int8_t RightDutyNow = 0;
+
+// who to tell when a ramp finishes, 0 for nobody
+static ProfileDoneFunc_t *pProfileDone = 0;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     InitMotionProfile
+
+ Description
+     Set up Wide Timer 3A as the profile tick. PWM must already be initialized
+****************************************************************************/
+void InitMotionProfile(void)
+{
+	NumSteps = 0;
+	NextStep = 0;
+	LeftDutyNow = 0;
+	RightDutyNow = 0;
+	InitProfileTimer();
+	printf("\r\nGot through motion profile init\r\n");
+}
+
+/****************************************************************************
+ Function
+     BuildDutyProfile
+
+ Parameters
+     int8_t LeftFrom, int8_t LeftTo, int8_t RightFrom, int8_t RightTo :
+       signed duty cycles, positive is forward
+     int8_t *pLeft, int8_t *pRight : arrays of at least MAX_PROFILE_STEPS
+
+ Returns
+     uint8_t number of steps written
+
+ Description
+     Linear (trapezoidal velocity) ramp from the current to the target duty.
+     The wheel with the larger change sets the ramp length and the other
+     wheel is scaled so that both arrive on the same tick, which keeps turns
+     symmetric. Pure computation, used by the test harness as well
+****************************************************************************/
+uint8_t BuildDutyProfile(int8_t LeftFrom, int8_t LeftTo, int8_t RightFrom,
+                         int8_t RightTo, int8_t *pLeft, int8_t *pRight)
+{
+	int16_t LeftDelta = LeftTo - LeftFrom;
+	int16_t RightDelta = RightTo - RightFrom;
+	uint16_t LargestDelta;
+	uint8_t Steps;
+	uint8_t i;
+
+	LargestDelta = (LeftDelta < 0) ? -LeftDelta : LeftDelta;
+	if (((RightDelta < 0) ? -RightDelta : RightDelta) > LargestDelta)
+	{
+		LargestDelta = (RightDelta < 0) ? -RightDelta : RightDelta;
+	}
+
+	Steps = (LargestDelta + DUTY_SLEW_PER_TICK - 1)/DUTY_SLEW_PER_TICK;
+
+	for (i = 1; i <= Steps; i++)
+	{
+		pLeft[i-1] = LeftFrom + (LeftDelta * i)/Steps;
+		pRight[i-1] = RightFrom + (RightDelta * i)/Steps;
+	}
+	return Steps;
+}
+
+/****************************************************************************
+ Function
+     SetMotionTarget
+
+ Parameters
+     int8_t LeftDuty, int8_t RightDuty : signed target duty cycles (-100..100)
+       positive drives the wheel forward
+
+ Description
+     Replaces whatever ramp is running with a new one that starts from the
+     duty currently on the motors. If the urgent stop halts the profile
+     while the ramp is being built, the ramp is dropped and the motors stay
+     stopped, and the done hook is not called
+****************************************************************************/
+void SetMotionTarget(int8_t LeftDuty, int8_t RightDuty)
+{
+	uint32_t Saved;
+	uint8_t Steps;
+	uint8_t i;
+	uint8_t HaltsBefore = HaltCount;
+	bool Halted;
+
+	// freeze the running profile so LeftDutyNow/RightDutyNow stop moving,
+	// and empty it so the ISR cannot apply a step while it is rewritten
+	StopProfileTimer();
+	Saved = ES_EnterCriticalAll();
+	NumSteps = 0;
+	NextStep = 0;
+	ES_ExitCriticalAll(Saved);
+
+	Steps = BuildDutyProfile(LeftDutyNow, LeftDuty, RightDutyNow, RightDuty,
+	                         LeftDutyAtStep, RightDutyAtStep);
+
+	// convert the duty ramp into register images for the ISR
+	for (i = 0; i < Steps; i++)
+	{
+		BuildPWMImage((LeftDutyAtStep[i] < 0) ? -LeftDutyAtStep[i] : LeftDutyAtStep[i],
+		              (LeftDutyAtStep[i] < 0) ? BACKWARD : FORWARD, LEFT, &ProfileSteps[i].Left);
+		BuildPWMImage((RightDutyAtStep[i] < 0) ? -RightDutyAtStep[i] : RightDutyAtStep[i],
+		              (RightDutyAtStep[i] < 0) ? BACKWARD : FORWARD, RIGHT, &ProfileSteps[i].Right);
+	}
+
+	// a halt can only land before or after this region, so the ramp is
+	// either dropped here or stopped by the halt once it is running
+	Saved = ES_EnterCriticalAll();
+	Halted = (HaltCount != HaltsBefore);
+	if (!Halted)
+	{
+		NumSteps = Steps;
+		NextStep = 0;
+		if (Steps > 0)
+		{
+			StartProfileTimer();
+		}
+	}
+	ES_ExitCriticalAll(Saved);
+
+	// already at the target, the ramp is over before it started
+	if (!Halted && (Steps == 0) && (pProfileDone != 0))
+	{
+		pProfileDone();
+	}
+}
+
+/****************************************************************************
+ Function
+     HaltMotionProfile
+
+ Description
+     Drop the running ramp without writing another step and record both
+     wheels as stopped. ISR safe, for the urgent stop, which then turns the
+     motors off itself
+****************************************************************************/
+void HaltMotionProfile(void)
+{
+	uint32_t Saved;
+
+	StopProfileTimer();
+	Saved = ES_EnterCriticalAll();
+	NumSteps = 0;
+	NextStep = 0;
+	LeftDutyNow = 0;
+	RightDutyNow = 0;
+	HaltCount++;
+	ES_ExitCriticalAll(Saved);
+}
+
+/****************************************************************************
+ Function
+     IsMotionProfileDone
+
+ Description
+     true once the last ramp step has been written to the motors
+****************************************************************************/
+bool IsMotionProfileDone(void)
+{
+	return (NextStep >= NumSteps);
+}
+
+/****************************************************************************
+ Function
+     QueryWheelDuty
+
+ Parameters
+     bool wheelSide : LEFT or RIGHT
+
+ Returns
+     int8_t signed duty currently on that wheel, positive is forward
+
+ Notes
+     called from the encoder ISRs, so it runs from SRAM with them
+****************************************************************************/
+ES_RAMFUNC int8_t QueryWheelDuty(bool wheelSide)
+{
+	return (wheelSide == LEFT) ? LeftDutyNow : RightDutyNow;
+}
+
+/****************************************************************************
+ Function
+     SetProfileDoneHook
+
+ Parameters
+     ProfileDoneFunc_t *pHook : called when a ramp completes, 0 to disable
+
+ Description
+     The hook runs from the profile ISR, so it should only post an event
+****************************************************************************/
+void SetProfileDoneHook(ProfileDoneFunc_t *pHook)
+{
+	pProfileDone = pHook;
+}
+
+/****************************************************************************
+ Function
+     MotionProfileISR
+
+ Description
+     Wide Timer 3A timeout: copy the next precomputed step into the PWM generators
+****************************************************************************/
+void MotionProfileISR(void)
+{
+	uint32_t Saved;
+	uint8_t ThisStep;
+	bool Finished = false;
+
+	ES_ISR_ENTRY(ISR_MOTION_PROFILE);
+
+	//Start by clearing out the source of the interrupt
+	HWREG(WTIMER3_BASE+TIMER_O_ICR) = TIMER_ICR_TATOCINT;
+	//The timer reloaded and started down again at the timeout
+	ES_ISR_LATENCY(ISR_MOTION_PROFILE,
+	               HWREG(WTIMER3_BASE+TIMER_O_TAILR) - HWREG(WTIMER3_BASE+TIMER_O_TAV));
+
+	Saved = ES_EnterCriticalAll();
+	ThisStep = NextStep;
+	if (ThisStep < NumSteps)
+	{
+		ApplyPWMImage(LEFT, &ProfileSteps[ThisStep].Left);
+		ApplyPWMImage(RIGHT, &ProfileSteps[ThisStep].Right);
+		LeftDutyNow = LeftDutyAtStep[ThisStep];
+		RightDutyNow = RightDutyAtStep[ThisStep];
+		NextStep = ThisStep + 1;
+		Finished = (NextStep >= NumSteps);
+	}
+	// nothing left to ramp, stop ticking until the next target
+	if (NextStep >= NumSteps)
+	{
+		StopProfileTimer();
+	}
+	ES_ExitCriticalAll(Saved);
+
+	// the hook posts, which does not need the safety ISRs held off
+	if (Finished && (pProfileDone != 0))
+	{
+		pProfileDone();
+	}
+
+	ES_ISR_EXIT(ISR_MOTION_PROFILE);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     InitProfileTimer
+
+ Description
+     Wide Timer 3A as a periodic timer at PROFILE_TICK_MS (interrupt 100)
+****************************************************************************/
+static void InitProfileTimer(void)
+{
+	if (ClaimTimer(WT3_A, TIMER_MODE_PERIODIC, "motion profile"))
+	{
+		//Set the tick period
+		SetTimerLoad(WT3_A, TicksPerMS*PROFILE_TICK_MS);
+	}
+}
+
+static void StartProfileTimer(void)
+{
+	StartTimer(WT3_A);
+}
+
+static void StopProfileTimer(void)
+{
+	StopTimer(WT3_A);
+	//A timeout that has already latched, in the timer or the NVIC
+	//(interrupt 100), would still run the ISR once after the stop
+	HWREG(WTIMER3_BASE+TIMER_O_ICR) = TIMER_ICR_TATOCINT;
+	HWREG(NVIC_UNPEND3) = BIT4HI;
+}
+
+// simulation harness: print the commanded ramps as an ASCII plot without
+// touching the motors, then check SetMotionTarget against a halt injected
+// part way through building the ramp. The profile timer registers are a
+// page of host memory mapped at WTIMER3_BASE, and the NVIC's the same way.
+// gcc -DTEST -I<stubs> -IHeaders Source/MotionProfileModule.c
+#ifdef TEST
+#include <sys/mman.h>
+
+#define PLOT_WIDTH 41
+// the NVIC registers' page, for the pending clear
+#define NVIC_BASE_PAGE 0xE000E000
+
+// the PWM and timer manager, just enough to see what SetMotionTarget does
+static bool SimTimerOn;
+static uint8_t SimImagesBuilt;
+static uint8_t SimHaltAtImage;   // 0 for no halt
+static uint8_t SimTickAtImage;   // 0 for no tick
+static uint8_t SimImagesApplied;
+static bool SimAppliedInBuild;
+static uint8_t SimDoneCalls;
+static uint8_t Failures;
+
+void BuildPWMImage(uint8_t DutyCycle, bool direction, bool wheelSide, PWMImage_t *pImage)
+{
+	// the urgent stop preempting the build, as the tape ISR would
+	uint8_t AppliedBefore = SimImagesApplied;
+
+	if (++SimImagesBuilt == SimHaltAtImage)
+	{
+		HaltMotionProfile();
+	}
+	// a profile tick that latched before the stop
+	if (SimImagesBuilt == SimTickAtImage)
+	{
+		MotionProfileISR();
+		SimAppliedInBuild = (SimImagesApplied != AppliedBefore);
+	}
+}
+void ApplyPWMImage(bool wheelSide, PWMImage_t const *pImage)
+{
+	SimImagesApplied++;
+}
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner) { return true; }
+void SetTimerLoad(TimerChannel_t Channel, uint32_t Ticks) {}
+void StartTimer(TimerChannel_t Channel) { SimTimerOn = true; }
+void StopTimer(TimerChannel_t Channel) { SimTimerOn = false; }
+uint32_t ES_EnterCriticalAll(void) { return 0; }
+void ES_ExitCriticalAll(uint32_t Saved) {}
+void ES_IsrEntry(ES_IsrId_t Id) {}
+void ES_IsrExit(ES_IsrId_t Id) {}
+void ES_IsrLatency(ES_IsrId_t Id, uint32_t SinceEvent) {}
+
+static void SimDoneResp(void)
+{
+	SimDoneCalls++;
+}
+
+// run the profile ISR until the ramp is written out
+static void SimRunProfile(void)
+{
+	while (SimTimerOn)
+	{
+		MotionProfileISR();
+	}
+}
+
+static void CheckTarget(char const *Name, int8_t Left, int8_t Right, uint8_t HaltAt,
+                        bool ExpectRunning, int8_t ExpectLeft, int8_t ExpectRight)
+{
+	bool Passed;
+
+	SimImagesBuilt = 0;
+	SimHaltAtImage = HaltAt;
+	SimDoneCalls = 0;
+	SetMotionTarget(Left, Right);
+	Passed = (SimTimerOn == ExpectRunning) && (IsMotionProfileDone() != ExpectRunning);
+	SimRunProfile();
+	Passed = Passed && (QueryWheelDuty(LEFT) == ExpectLeft) &&
+	         (QueryWheelDuty(RIGHT) == ExpectRight) &&
+	         (SimDoneCalls == (ExpectRunning ? 1 : 0));
+	printf("%-32s timer %s, L=%4d R=%4d, done hook %u: %s\r\n", Name,
+	       ExpectRunning ? "started" : "held", QueryWheelDuty(LEFT),
+	       QueryWheelDuty(RIGHT), SimDoneCalls, Passed ? "pass" : "FAIL");
+	if (!Passed)
+	{
+		Failures++;
+	}
+}
+
+static void PlotProfile(char const *Name, int8_t LeftFrom, int8_t LeftTo,
+                        int8_t RightFrom, int8_t RightTo)
+{
+	int8_t Left[MAX_PROFILE_STEPS];
+	int8_t Right[MAX_PROFILE_STEPS];
+	char Row[PLOT_WIDTH + 1];
+	uint8_t Steps;
+	uint8_t i;
+	uint8_t Column;
+
+	Steps = BuildDutyProfile(LeftFrom, LeftTo, RightFrom, RightTo, Left, Right);
+	printf("\r\n%s: %u steps, %u ms\r\n", Name, Steps, Steps*PROFILE_TICK_MS);
+	printf("  ms  L    R   -100%%              0              +100%%\r\n");
+	for (i = 0; i < Steps; i++)
+	{
+		for (Column = 0; Column < PLOT_WIDTH; Column++)
+		{
+			Row[Column] = (Column == PLOT_WIDTH/2) ? '|' : ' ';
+		}
+		Row[PLOT_WIDTH] = '\0';
+		Row[(Left[i] + 100)*(PLOT_WIDTH - 1)/200] = 'L';
+		Column = (Right[i] + 100)*(PLOT_WIDTH - 1)/200;
+		Row[Column] = (Row[Column] == 'L') ? '*' : 'R';
+		printf("%4u %4d %4d %s\r\n", (i + 1)*PROFILE_TICK_MS, Left[i], Right[i], Row);
+	}
+}
+
+// retarget part way up a ramp with the old ramp's tick landing mid-build
+static void CheckLatchedTick(void)
+{
+	bool Passed;
+
+	SimHaltAtImage = 0;
+	SetMotionTarget(100, 100);
+	MotionProfileISR();
+	MotionProfileISR();
+	SimImagesBuilt = 0;
+	SimTickAtImage = 5;
+	SimAppliedInBuild = false;
+	SetMotionTarget(-100, -100);
+	SimTickAtImage = 0;
+	Passed = !SimAppliedInBuild;
+	SimRunProfile();
+	Passed = Passed && (QueryWheelDuty(LEFT) == -100) && (QueryWheelDuty(RIGHT) == -100);
+	printf("%-32s %s, L=%4d R=%4d: %s\r\n", "tick latched during rebuild",
+	       SimAppliedInBuild ? "step applied" : "nothing applied",
+	       QueryWheelDuty(LEFT), QueryWheelDuty(RIGHT), Passed ? "pass" : "FAIL");
+	if (!Passed)
+	{
+		Failures++;
+	}
+}
+
+int main(void)
+{
+	PlotProfile("start forward", 0, 100, 0, 95);
+	PlotProfile("stop from forward", 100, 0, 95, 0);
+	PlotProfile("spin CW from rest", 0, 100, 0, -100);
+	PlotProfile("forward to reverse", 100, -100, 95, -95);
+
+	if ((mmap((void *)WTIMER3_BASE, 0x1000, PROT_READ | PROT_WRITE,
+	          MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED) ||
+	    (mmap((void *)NVIC_BASE_PAGE, 0x1000, PROT_READ | PROT_WRITE,
+	          MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED))
+	{
+		printf("could not map the simulated timer\r\n");
+		return 1;
+	}
+	printf("\r\n");
+	InitMotionProfile();
+	SetProfileDoneHook(SimDoneResp);
+	CheckTarget("start forward", 100, 95, 0, true, 100, 95);
+	CheckTarget("halt while building reverse", -100, -95, 5, false, 0, 0);
+	CheckTarget("halt on the first image", 50, 50, 1, false, 0, 0);
+	CheckTarget("halt on the last image", 50, 50, 2*((50 + DUTY_SLEW_PER_TICK - 1)/DUTY_SLEW_PER_TICK),
+	            false, 0, 0);
+	CheckTarget("start after the halts", 50, -50, 0, true, 50, -50);
+	CheckLatchedTick();
+	printf("\r\n%d failures\r\n", Failures);
+	return Failures;
+}
+#endif
@@ -13,6 +13,7 @@
 #include "ES_Framework.h"
 #include "MotorActionsModule.h"
 #include "PWMModule.h"
+#include "MotionProfileModule.h"
 
 #include <stdio.h>
 #include <termio.h>
@@ -52,83 +53,55 @@
    relevant to the behavior of this service*/
 
 /*---------------------------- Module Variables ---------------------------*/
-// with the introduction of Gen2, we need a module level Priority variable
-static bool wheelSide;
-static bool direction;
 
 /*------------------------------ Module Code ------------------------------*/
+// all motions go through the motion profile so the duty cycles ramp at
+// DUTY_SLEW_PER_TICK instead of stepping, positive duty is forward
 void start2rotate(bool rotationDirection)
 {
 	// pick arbitrary DutyCycle, keep for testing
-	uint8_t DutyCycle = 100;
+	int8_t DutyCycle = 100;
 	
 	if (rotationDirection == CW)
 	{
-		// pick the left wheel and rotate it forward to make robot spin CW
-		wheelSide = LEFT;
-		direction = FORWARD;
-		SetPWMDutyCycle(DutyCycle, direction, wheelSide);
-		
-		// pick the right wheel and rotate it backward to make robot spin CW
-		wheelSide = RIGHT;
-		direction = BACKWARD;
-		SetPWMDutyCycle(DutyCycle, direction, wheelSide);
+		// left wheel forward, right wheel backward to make robot spin CW
+		SetMotionTarget(DutyCycle, -DutyCycle);
 	}
 	
 	else // rotationDirection is CCW
 	{
-		// pick the left wheel and rotate it backward to make robot spin CCW
-		wheelSide = LEFT;
-		direction = BACKWARD;
-		SetPWMDutyCycle(DutyCycle, direction, wheelSide);
-		
-		// pick the right wheel and rotate it forward to make robot spin CCW
-		wheelSide = RIGHT;
-		direction = FORWARD;
-		SetPWMDutyCycle(DutyCycle, direction, wheelSide);		
+		// left wheel backward, right wheel forward to make robot spin CCW
+		SetMotionTarget(-DutyCycle, DutyCycle);
 	}
 }
 
 void rotate2beacon(void)
 {
 	// pick arbitrary DutyCycle, keep for testing
-	uint8_t DutyCycle = 60;
+	int8_t DutyCycle = 60;
 	
-	// pick the left wheel and rotate it forward to make robot spin CW
-	wheelSide = LEFT;
-	direction = FORWARD;
-	SetPWMDutyCycle(DutyCycle, direction, wheelSide);
-		
-	// pick the right wheel and rotate it backward to make robot spin CW
-	wheelSide = RIGHT;
-	direction = BACKWARD;
-	SetPWMDutyCycle(DutyCycle, direction, wheelSide);
+	// left wheel forward, right wheel backward to make robot spin CW
+	SetMotionTarget(DutyCycle, -DutyCycle);
 }
 
 void drive(uint8_t DutyCycle, bool direction)
 {
-	// drive left motor at specified DutyCycle and direction
-	wheelSide = LEFT;
-	SetPWMDutyCycle(DutyCycle, direction, wheelSide);
+	// right motor runs 5% slower to drive straight
+	int8_t LeftDuty = DutyCycle;
+	int8_t RightDuty = DutyCycle - 5;
 	
-	// drive right motor at specified DutyCycle and direction
-	wheelSide = RIGHT;
-	SetPWMDutyCycle(DutyCycle - 5, direction, wheelSide);
+	if (direction == BACKWARD)
+	{
+		LeftDuty = -LeftDuty;
+		RightDuty = -RightDuty;
+	}
+	SetMotionTarget(LeftDuty, RightDuty);
 }
 
 void stop(void)
 {
-	uint8_t DutyCycle = 0; // to stop motor
-	direction = FORWARD; // does not matter
-	
-	// stop the left motor
-	wheelSide = LEFT;
-	SetPWMDutyCycle(DutyCycle, direction, wheelSide);
-	
-	// stop the right motor
-	wheelSide = RIGHT;
-	SetPWMDutyCycle(DutyCycle, direction, wheelSide);	
-	printf("\n\rAt the end of stop function\r\n");
+	// ramp both motors down to 0
+	SetMotionTarget(0, 0);
 }
 /***************************************************************************
  private functions
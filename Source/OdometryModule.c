@@ -0,0 +1,481 @@
+/****************************************************************************
+Odometry Module
+	Count wheel encoder edges on Wide Timer 2 and integrate the robot pose
+	in fixed point inside the capture ISRs.
+	Left encoder on PD0 (WT2CCP0, Wide Timer 2A)
+	Right encoder on PD1 (WT2CCP1, Wide Timer 2B)
+
+	On the EK-TM4C123GXL, PD0 and PD1 are strapped to PB6 and PB7 (the
+	right motor PWM) through the 0 ohm resistors R9 and R10. Both must be
+	removed, or the PWM drives the encoder inputs and the counts are junk.
+
+	The encoders are single channel, so the direction of each edge is taken
+	from the duty cycle the motion profile is commanding on that wheel.
+
+	Units: position in 1/16 uM, heading as a binary angle where 2^32 is one
+	full turn (CCW positive), so heading wraps for free.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_sysctl.h"
+#include "driverlib/gpio.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_nvic.h"
+#include "BITDEFS.H"
+
+#include "MotionProfileModule.h"
+#include "OdometryModule.h"
+#include "TimerManager.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define LEFT 1
+#define RIGHT 0
+
+// robot geometry, measured
+#define WHEEL_DIAMETER_UM 69850
+#define WHEEL_BASE_UM 235000
+#define EDGES_PER_WHEEL_REV 512
+
+// distance the wheel rolls per encoder edge, in nM to keep the precision
+#define DIST_PER_EDGE_NM ((314159LL*WHEEL_DIAMETER_UM/100)/EDGES_PER_WHEEL_REV)
+// the centre of the robot moves half of that, in 1/16 uM
+#define HALF_DIST_PER_EDGE_16UM ((int32_t)((DIST_PER_EDGE_NM*16)/(2*1000)))
+
+// 2^32/(2*pi) binary angle units per radian
+#define BAM_PER_RADIAN 683565276LL
+// one wheel moving one edge turns the robot by edge distance / wheel base
+#define HEADING_PER_EDGE ((uint32_t)((DIST_PER_EDGE_NM*BAM_PER_RADIAN)/(WHEEL_BASE_UM*1000LL)))
+
+// 2^32/360 binary angle units per degree
+#define BAM_PER_DEGREE 11930465L
+
+#define BitsPerNibble 4
+#define pinD0Mask 0xfffffff0
+#define pinD1Mask 0xffffff0f
+
+/*---------------------------- Module Functions ---------------------------*/
+static void CountEdge(bool wheelSide);
+
+/*---------------------------- Module Variables ---------------------------*/
+// sin(2*pi*i/256) in Q15, cos is read 64 entries further on
+static int16_t const SinQ15[256] = {
+	     0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+	  6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+	 12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+	 18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+	 23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+	 27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+	 30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+	 32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+	 32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+	 32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+	 30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+	 27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+	 23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+	 18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+	 12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+	  6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+	     0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+	 -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+	-12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+	-18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+	-23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+	-27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+	-30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+	-32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+	-32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+	-32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+	-30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+	-27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+	-23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+	-18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+	-12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+	 -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804,
+};
+
+static volatile uint32_t Heading;
+static volatile int32_t X16um;
+static volatile int32_t Y16um;
+static volatile int32_t LeftEdges;
+static volatile int32_t RightEdges;
+
+// last capture on each wheel, for speed measurements
+static uint32_t LeftLastCapture;
+static uint32_t RightLastCapture;
+
+// wheels keep coasting the way they were last driven once the duty is 0
+static bool LeftForward = true;
+static bool RightForward = true;
+
+// measured turn in progress
+static volatile bool TurnActive = false;
+static uint32_t TurnStartHeading;
+static int32_t TurnTarget;
+static TurnDoneFunc_t *pTurnDone;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     InitOdometry
+
+ Description
+     Initialize Wide Timer 2 A and B as rising edge captures on PD0 and PD1
+****************************************************************************/
+void InitOdometry(void)
+{
+	//Wide Timer 2 A and B as rising edge captures (interrupts 98 and 99)
+	if (!ClaimTimer(WT2_A, TIMER_MODE_CAPTURE, "left encoder") ||
+	    !ClaimTimer(WT2_B, TIMER_MODE_CAPTURE, "right encoder"))
+	{
+		return;
+	}
+
+	//Enable the clock to port D
+	HWREG(SYSCTL_RCGCGPIO) |= SYSCTL_RCGCGPIO_R3;
+
+	//Set the alternate function for PD0 and PD1
+	HWREG(GPIO_PORTD_BASE+GPIO_O_AFSEL) |= (BIT0HI | BIT1HI);
+	//Map PD0 to WT2CCP0 and PD1 to WT2CCP1
+	HWREG(GPIO_PORTD_BASE+GPIO_O_PCTL) = (HWREG(GPIO_PORTD_BASE+GPIO_O_PCTL) & pinD0Mask & pinD1Mask)
+	                                     + (7 << (0*BitsPerNibble)) + (7 << (1*BitsPerNibble));
+	//Enable PD0 and PD1 as digital inputs
+	HWREG(GPIO_PORTD_BASE+GPIO_O_DEN) |= (BIT0HI | BIT1HI);
+	HWREG(GPIO_PORTD_BASE+GPIO_O_DIR) &= (BIT0LO & BIT1LO);
+
+	ResetPose();
+
+	//Kick both timers off
+	StartTimer(WT2_A);
+	StartTimer(WT2_B);
+
+	printf("\r\nGot through odometry init\r\n");
+}
+
+/****************************************************************************
+ Function
+     ResetPose
+
+ Description
+     Make the current position the origin, facing along +X
+****************************************************************************/
+void ResetPose(void)
+{
+	uint32_t Saved;
+
+	Saved = ES_EnterCritical();
+	Heading = 0;
+	X16um = 0;
+	Y16um = 0;
+	LeftEdges = 0;
+	RightEdges = 0;
+	ES_ExitCritical(Saved);
+}
+
+/****************************************************************************
+ Function
+     GetPose
+
+ Parameters
+     Pose_t *pPose : filled with a consistent snapshot of the pose
+****************************************************************************/
+void GetPose(Pose_t *pPose)
+{
+	uint32_t Saved;
+
+	Saved = ES_EnterCritical();
+	pPose->XUM = X16um/16;
+	pPose->YUM = Y16um/16;
+	pPose->Heading = Heading;
+	ES_ExitCritical(Saved);
+}
+
+/****************************************************************************
+ Function
+     GetHeadingDeg
+
+ Returns
+     int16_t heading in degrees, -180..179, CCW positive
+****************************************************************************/
+int16_t GetHeadingDeg(void)
+{
+	return (int16_t)(((int32_t)Heading)/BAM_PER_DEGREE);
+}
+
+/****************************************************************************
+ Function
+     StartMeasuredTurn
+
+ Parameters
+     int16_t Degrees : turn to make from the current heading, CCW positive,
+       must be less than 180 in magnitude
+     TurnDoneFunc_t *pDone : called from the encoder ISR once the turn has
+       been measured. It may halt the motors and post, but not ramp them,
+       SetMotionTarget is not ISR safe
+
+ Description
+     Arms the angle check; the caller starts the rotation itself
+****************************************************************************/
+void StartMeasuredTurn(int16_t Degrees, TurnDoneFunc_t *pDone)
+{
+	uint32_t Saved;
+
+	Saved = ES_EnterCritical();
+	TurnStartHeading = Heading;
+	TurnTarget = Degrees*BAM_PER_DEGREE;
+	pTurnDone = pDone;
+	TurnActive = true;
+	ES_ExitCritical(Saved);
+}
+
+/****************************************************************************
+ Function
+     CancelMeasuredTurn
+****************************************************************************/
+void CancelMeasuredTurn(void)
+{
+	TurnActive = false;
+}
+
+/****************************************************************************
+ Function
+     LeftEncoderISR / RightEncoderISR
+
+ Description
+     Capture interrupt responses for the two encoders
+****************************************************************************/
+ES_RAMFUNC void LeftEncoderISR(void)
+{
+	ES_ISR_ENTRY(ISR_LEFT_ENCODER);
+
+	//Start by clearing out the source of the interrupt
+	HWREG(WTIMER2_BASE+TIMER_O_ICR) = TIMER_ICR_CAECINT;
+
+	//Grab the captured value
+	LeftLastCapture = HWREG(WTIMER2_BASE+TIMER_O_TAR);
+	ES_ISR_LATENCY(ISR_LEFT_ENCODER, HWREG(WTIMER2_BASE+TIMER_O_TAV) - LeftLastCapture);
+
+	if (QueryWheelDuty(LEFT) != 0)
+	{
+		LeftForward = (QueryWheelDuty(LEFT) > 0);
+	}
+	CountEdge(LEFT);
+
+	ES_ISR_EXIT(ISR_LEFT_ENCODER);
+}
+
+ES_RAMFUNC void RightEncoderISR(void)
+{
+	ES_ISR_ENTRY(ISR_RIGHT_ENCODER);
+
+	//Start by clearing out the source of the interrupt
+	HWREG(WTIMER2_BASE+TIMER_O_ICR) = TIMER_ICR_CBECINT;
+
+	//Grab the captured value
+	RightLastCapture = HWREG(WTIMER2_BASE+TIMER_O_TBR);
+	ES_ISR_LATENCY(ISR_RIGHT_ENCODER, HWREG(WTIMER2_BASE+TIMER_O_TBV) - RightLastCapture);
+
+	if (QueryWheelDuty(RIGHT) != 0)
+	{
+		RightForward = (QueryWheelDuty(RIGHT) > 0);
+	}
+	CountEdge(RIGHT);
+
+	ES_ISR_EXIT(ISR_RIGHT_ENCODER);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     CountEdge
+
+ Description
+     Integrate one edge into the pose: the wheel that moved turns the robot
+     about the other wheel, and the centre moves half an edge along the
+     heading. Checks for the end of a measured turn
+****************************************************************************/
+static void CountEdge(bool wheelSide)
+{
+	bool Forward;
+	uint32_t MidHeading;
+	uint8_t Index;
+	int32_t Turned;
+
+	if (wheelSide == LEFT)
+	{
+		Forward = LeftForward;
+		LeftEdges += Forward ? 1 : -1;
+		// left wheel forward turns the robot CW
+		MidHeading = Heading + (Forward ? -(HEADING_PER_EDGE/2) : (HEADING_PER_EDGE/2));
+		Heading += Forward ? -HEADING_PER_EDGE : HEADING_PER_EDGE;
+	}
+	else
+	{
+		Forward = RightForward;
+		RightEdges += Forward ? 1 : -1;
+		// right wheel forward turns the robot CCW
+		MidHeading = Heading + (Forward ? (HEADING_PER_EDGE/2) : -(HEADING_PER_EDGE/2));
+		Heading += Forward ? HEADING_PER_EDGE : -HEADING_PER_EDGE;
+	}
+
+	// the centre moved along the heading halfway through the edge, rounded
+	// to the nearest of the 256 table entries
+	Index = (uint8_t)((MidHeading + (1UL << 23)) >> 24);
+	if (Forward)
+	{
+		X16um += (HALF_DIST_PER_EDGE_16UM*SinQ15[(uint8_t)(Index + 64)]) >> 15;
+		Y16um += (HALF_DIST_PER_EDGE_16UM*SinQ15[Index]) >> 15;
+	}
+	else
+	{
+		X16um -= (HALF_DIST_PER_EDGE_16UM*SinQ15[(uint8_t)(Index + 64)]) >> 15;
+		Y16um -= (HALF_DIST_PER_EDGE_16UM*SinQ15[Index]) >> 15;
+	}
+
+	if (TurnActive)
+	{
+		Turned = (int32_t)(Heading - TurnStartHeading);
+		if (((TurnTarget >= 0) && (Turned >= TurnTarget)) ||
+		    ((TurnTarget < 0) && (Turned <= TurnTarget)))
+		{
+			TurnActive = false;
+			if (pTurnDone != 0)
+			{
+				pTurnDone();
+			}
+		}
+	}
+}
+
+// host side harness: drive CountEdge from a simulated pair of encoders
+#ifdef TEST
+#include <stdlib.h>
+
+static bool SimTurnDone;
+
+static void SimTurnDoneResp(void)
+{
+	SimTurnDone = true;
+}
+
+// edges arrive interleaved in proportion to the two wheel speeds
+static uint32_t SimulateEdges(int8_t LeftDuty, int8_t RightDuty, uint32_t MaxEdges)
+{
+	uint32_t LeftAcc = 0;
+	uint32_t RightAcc = 0;
+	uint32_t Edges = 0;
+	uint8_t LeftRate = (LeftDuty < 0) ? -LeftDuty : LeftDuty;
+	uint8_t RightRate = (RightDuty < 0) ? -RightDuty : RightDuty;
+
+	LeftForward = (LeftDuty >= 0);
+	RightForward = (RightDuty >= 0);
+	SimTurnDone = false;
+	while ((Edges < MaxEdges) && !SimTurnDone)
+	{
+		LeftAcc += LeftRate;
+		RightAcc += RightRate;
+		if (LeftAcc >= 100)
+		{
+			LeftAcc -= 100;
+			CountEdge(LEFT);
+			Edges++;
+		}
+		if ((RightAcc >= 100) && !SimTurnDone)
+		{
+			RightAcc -= 100;
+			CountEdge(RIGHT);
+			Edges++;
+		}
+	}
+	return Edges;
+}
+
+// pose after each leg, within a couple of edges of the ideal
+#define POS_TOLERANCE_UM 2000
+#define HEADING_TOLERANCE_DEG 2
+
+static uint8_t Failures;
+
+static void CheckPose(char const *Label, int32_t XUM, int32_t YUM, int16_t Deg)
+{
+	Pose_t Pose;
+	int16_t HeadingDeg = GetHeadingDeg();
+	bool Passed;
+
+	GetPose(&Pose);
+	Passed = (labs((long)(Pose.XUM - XUM)) <= POS_TOLERANCE_UM) &&
+	         (labs((long)(Pose.YUM - YUM)) <= POS_TOLERANCE_UM) &&
+	         (abs(HeadingDeg - Deg) <= HEADING_TOLERANCE_DEG);
+	printf("%-28s x=%7ld uM  y=%7ld uM  heading=%4d deg  %s\r\n", Label,
+	       (long)Pose.XUM, (long)Pose.YUM, HeadingDeg, Passed ? "pass" : "FAIL");
+	if (!Passed)
+	{
+		Failures++;
+	}
+}
+
+// the TEST build links without the timer manager and the motion profile
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner) { return true; }
+void StartTimer(TimerChannel_t Channel) {}
+int8_t QueryWheelDuty(bool wheelSide) { return 0; }
+uint32_t ES_EnterCritical(void) { return 0; }
+void ES_ExitCritical(uint32_t Saved) {}
+void ES_IsrEntry(ES_IsrId_t Id) {}
+void ES_IsrExit(ES_IsrId_t Id) {}
+void ES_IsrLatency(ES_IsrId_t Id, uint32_t SinceEvent) {}
+
+int main(void)
+{
+	uint32_t Edges;
+
+	printf("\r\nodometry test: %lu nM/edge, %lu BAM/edge\r\n",
+	       (unsigned long)DIST_PER_EDGE_NM, (unsigned long)HEADING_PER_EDGE);
+	ResetPose();
+
+	// one metre straight ahead
+	SimulateEdges(100, 100, 2*(1000000000LL/DIST_PER_EDGE_NM));
+	CheckPose("after 1 m forward:", 1000000, 0, 0);
+
+	// measured CW 90 on the spot
+	StartMeasuredTurn(-90, SimTurnDoneResp);
+	Edges = SimulateEdges(100, -100, 100000);
+	printf("CW 90 ended after %lu edges, done=%d\r\n", (unsigned long)Edges, SimTurnDone);
+	if (!SimTurnDone)
+	{
+		Failures++;
+	}
+	CheckPose("after CW 90:", 1000000, 0, -90);
+
+	// half a metre on the new heading, should move along -Y
+	SimulateEdges(100, 100, 1000000000LL/DIST_PER_EDGE_NM);
+	CheckPose("after 0.5 m forward:", 1000000, -500000, -90);
+
+	// measured CCW 45
+	StartMeasuredTurn(45, SimTurnDoneResp);
+	Edges = SimulateEdges(-100, 100, 100000);
+	printf("CCW 45 ended after %lu edges, done=%d\r\n", (unsigned long)Edges, SimTurnDone);
+	if (!SimTurnDone)
+	{
+		Failures++;
+	}
+	CheckPose("after CCW 45:", 1000000, -500000, -45);
+
+	printf("\r\n%d failures\r\n", Failures);
+	return Failures;
+}
+#endif
@@ -14,6 +14,9 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26 23:59 t16      the end of the run empties the lookahead FIFO
+ 10/19/26 19:10 t16      prefetch new commands into a lookahead FIFO
+ 10/19/26 17:30 t16      query states now run on the ES_HSM tables
  11/02/13 17:21 jec      added exercise of the event deferral/recall module
  08/05/13 20:33 jec      converted to test harness service
  01/16/12 09:58 jec      began conversion from TemplateFSM.c
@@ -24,6 +27,7 @@
 //#define TEST
 #include "ES_Configure.h"
 #include "ES_Framework.h"
+#include "ES_HSM.h"
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_gpio.h"
@@ -36,6 +40,7 @@
 #include "inc/hw_ssi.h"
 #include "SPIService.h"
 #include "ActionService.h"
+#include "CommandOpcodes.h"
 
 // to print comments to the terminal
 #include <stdio.h>
@@ -54,12 +59,19 @@
 #define SSIModule BIT0HI
 #define SSI_NVIC_HI BIT7HI
 
-// CPSR divisor for SSI clock rate (2)
-#define CPSDVSR 0x18
+// SSI bit clock the command generator was tuned to, CPU_CLOCK_HZ/48
+// at the 40 MHz this was first written for
+#define SSI_BIT_RATE_HZ 833333UL
 
-// SCR divisor for SSI clock rate (24)
+// SCR divisor for SSI clock rate (2)
 #define SCR 0x01
 
+// CPSR divisor for SSI clock rate, whatever is left after SCR
+#define CPSDVSR (CPU_CLOCK_HZ/(SSI_BIT_RATE_HZ*(1 + SCR)))
+#if (CPSDVSR & 1) || CPSDVSR < 2 || CPSDVSR > 254
+#error CPSDVSR must be even and 2 to 254, change SCR for this CPU_CLOCK_HZ
+#endif
+
 // querry to Command Generator
 #define QueryBits 0xAA
 
@@ -74,19 +86,39 @@
 
 #define BitsPerNibble 4
 
+// commands fetched ahead of the one ActionService is running
+#define LOOKAHEAD_DEPTH 4
+
 
 /*---------------------------- Module Functions ---------------------------*/
 /* prototypes for private functions for this service.They should be functions
    relevant to the behavior of this service
 */
 static void InitSerialHardware(void);
+static void RestartPoll( ES_Event ThisEvent );
+static void ParseResponse( ES_Event ThisEvent );
 void QuerySPI( void );
 
+// query state machine: every SPIPeriod poll the command generator, unless
+// the last query has not been answered yet. Busy's entry sends the query
+#define SPI_STATES(STATE) \
+	STATE(SPITop,  ES_HSM_NO_PARENT, 0,        0) \
+	STATE(Idling,  SPITop,           0,        0) \
+	STATE(Busy,    SPITop,           QuerySPI, 0)
+
+#define SPI_TRANSITIONS(TRANS) \
+	TRANS(SPITop,  ES_TIMEOUT,   RestartPoll,   ES_HSM_INTERNAL) \
+	TRANS(Idling,  ES_TIMEOUT,   RestartPoll,   Busy) \
+	TRANS(Busy,    SPI_RESPONSE, ParseResponse, Idling)
+
+ES_HSM_STATES(SPI, SPI_STATES)
+ES_HSM_TABLES(SPI, SPI_STATES, SPI_TRANSITIONS)
+
 /*---------------------------- Module Variables ---------------------------*/
 static uint8_t MyPriority;
 
-// current state of SPI state machine
-static SPIState_t CurrentState;
+// SPI state machine, runs the tables above
+static ES_HSM_t SPIHSM = ES_HSM_INIT(SPI);
 
 // received data from data register
 static uint8_t ReceivedData;
@@ -99,6 +131,17 @@ static ES_Event ISREvent;
 
 static ES_Event LastEvent;
 
+// the generator sends READY4NEXTCOMMAND, then repeats the new command until
+// it has another one. Armed is set between the two
+static bool Armed = false;
+// set once the run has ended, nothing more is queued for ActionService
+static bool PrefetchStopped = false;
+
+// lookahead FIFO of commands ActionService has not started yet
+static uint8_t Lookahead[LOOKAHEAD_DEPTH];
+static uint8_t LookaheadHead = 0;
+static volatile uint8_t LookaheadCount = 0;
+
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -128,6 +171,12 @@ bool InitSPIService ( uint8_t Priority )
 	 
 	// Initialize shorttimer 
 	ES_Timer_InitTimer(SPI_TIMER,SPIPeriod);
+	
+	Armed = false;
+	PrefetchStopped = false;
+	LookaheadHead = 0;
+	LookaheadCount = 0;
+	ES_HSM_Start(&SPIHSM, Idling);
 
 	printf("\r\nGot through SPI init\r\n");
 	
@@ -159,22 +208,7 @@ ES_Event RunSPIService ( ES_Event ThisEvent )
   ReturnEvent.EventType = ES_NO_EVENT; // assume no errors
 	//printf("\r\n SPI Run \r\n");
 	
-	//if(ThisEvent.EventType == NEXT_COMMAND)
-	if(ThisEvent.EventType == ES_TIMEOUT)
-	{		
-		// Initialize shorttimer 
-		ES_Timer_InitTimer(SPI_TIMER,SPIPeriod);
-		
-		// Idling State
-		if(CurrentState == Idling)
-		{		
-			// change state to Busy
-			CurrentState = Busy;
-			
-			// query the Command Generator
-			QuerySPI();
-		} 
-	}
+	ES_HSM_Dispatch(&SPIHSM, ThisEvent);
 	return ReturnEvent;
 }
 
@@ -201,6 +235,59 @@ bool PostSPIService( ES_Event ThisEvent )
 }
 
 
+/****************************************************************************
+ Function
+     GetNextCommand
+
+ Parameters
+     uint8_t *pOpcode : where to put the oldest prefetched command
+
+ Returns
+     bool, false if nothing has been prefetched
+
+ Description
+     Called by ActionService when it is ready for its next motion. This
+     service runs in a higher band than ActionService and can fill the
+     FIFO in the middle of the pop, so interrupts are off around it
+****************************************************************************/
+bool GetNextCommand( uint8_t *pOpcode )
+{
+	uint32_t Saved;
+	bool Got = false;
+
+	Saved = ES_EnterCritical();
+	if (LookaheadCount != 0)
+	{
+		*pOpcode = Lookahead[LookaheadHead];
+		LookaheadHead = (LookaheadHead + 1) % LOOKAHEAD_DEPTH;
+		LookaheadCount--;
+		Got = true;
+	}
+	ES_ExitCritical(Saved);
+	return Got;
+}
+
+/****************************************************************************
+ Function
+     StopCommandPrefetch
+
+ Description
+     Called by ActionService at the end of the run. Drops the commands
+     prefetched but not started, and queues no more, so nothing moves the
+     robot after the run has ended
+****************************************************************************/
+void StopCommandPrefetch( void )
+{
+	uint32_t Saved;
+
+	Saved = ES_EnterCritical();
+	PrefetchStopped = true;
+	Armed = false;
+	LookaheadHead = 0;
+	LookaheadCount = 0;
+	ES_ExitCritical(Saved);
+}
+
 /****************************************************************************
  Function
      SPI_InterruptResponse
@@ -219,19 +306,21 @@ bool PostSPIService( ES_Event ThisEvent )
 ****************************************************************************/
 void SPI_InterruptResponse( void )
 {	
+	ES_ISR_ENTRY(ISR_SPI);
+	
 	// clear interrupt
 	HWREG(SSI0_BASE + SSI_O_IM) &= (~SSI_IM_TXIM);
 
 	// read command 
 	ReceivedData = HWREG(SSI0_BASE+SSI_O_DR);	
 	
-	// post command to action service
-	ISREvent.EventType = ISR_COMMAND;
+	// let the state machine know the query was answered, it decides
+	// whether the byte is a new command
+	ISREvent.EventType = SPI_RESPONSE;
 	ISREvent.EventParam = ReceivedData;
-	PostActionService(ISREvent);
+	PostSPIService(ISREvent);
 	
-	// set current state to idling
-	CurrentState = Idling;
+	ES_ISR_EXIT(ISR_SPI);
 }
 
 /****************************************************************************
@@ -262,6 +351,52 @@ void QuerySPI( void )
 /*----------------------------------------------------------------------------
 private functions
 -----------------------------------------------------------------------------*/
+/****************************************************************************
+ Function
+     RestartPoll
+
+ Description
+     state machine action: time the next poll of the command generator
+****************************************************************************/
+static void RestartPoll( ES_Event ThisEvent )
+{
+	ES_Timer_InitTimer(SPI_TIMER,SPIPeriod);
+}
+
+/****************************************************************************
+ Function
+     ParseResponse
+
+ Description
+     state machine action: the first byte after a READY4NEXTCOMMAND is a new
+     command, queue it and tell ActionService. With the FIFO full the byte is
+     left for a later poll, the generator keeps repeating it. Once the run
+     has ended nothing is queued
+****************************************************************************/
+static void ParseResponse( ES_Event ThisEvent )
+{
+	ES_Event CommandEvent;
+
+	if (PrefetchStopped)
+	{
+		return;
+	}
+	if (ThisEvent.EventParam == READY4NEXTCOMMAND)
+	{
+		Armed = true;
+	}
+	else if (Armed && (LookaheadCount < LOOKAHEAD_DEPTH))
+	{
+		Armed = false;
+		Lookahead[(LookaheadHead + LookaheadCount) % LOOKAHEAD_DEPTH] = (uint8_t)ThisEvent.EventParam;
+		LookaheadCount++;
+
+		CommandEvent.EventType = NEXT_COMMAND;
+		CommandEvent.EventParam = ThisEvent.EventParam;
+		PostActionService(CommandEvent);
+	}
+}
+
 /****************************************************************************
  Function
      InitSerialHardware
@@ -360,8 +495,7 @@ static void InitSerialHardware(void)
 #ifdef TEST
 int main(void)
 {
-	SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
-			| SYSCTL_XTAL_16MHZ);
+	SysCtlClockSet(CPU_CLOCK_SYSCTL);
 	TERMIO_Init();
 	clrScrn();
 	printf("\r\n Starting SPI Test \r\n");
@@ -1,13 +1,16 @@
 /****************************************************************************
 Tape Module
 	Define the Initialization and ISR for the tape sensing interrupt
-	Whenever tape is detected, post event TapeSensed
+	Whenever tape is detected, stop the motors through the urgent stop and
+	publish TapeSensed. The ISR runs at ES_SAFETY_PRIORITY, so it is never
+	held off by a framework critical region
  
 Events to receive:
   None
  
 Events to post:
-	TapeSensed (to ActionService)
+	TapeSensed (published), the param is the raw capture and the
+	event time is the edge on the framework uS clock
 ****************************************************************************/
 
 /*----------------------------- Include Files -----------------------------*/
@@ -24,16 +27,16 @@ Events to post:
 
 #include "ActionService.h"
 #include "TapeModule.h"
+#include "CommandOpcodes.h"
+#include "TimerManager.h"
+#include "ES_Urgent.h"
+#include "ClockConfig.h"
 
 
 /*----------------------------- Module Defines ----------------------------*/
 #define ONE_SEC 976 //assume a 1.000mS/tick timing
 #define ALL_BITS (0xff<<2)
 
-#define STOP 0x00
-/*---------------------------- Module Variables ---------------------------*/
-static uint32_t LastCapture;
-
 /*------------------------------ Module Code ------------------------------*/
 
 /****************************************************************************
@@ -45,27 +48,15 @@ static uint32_t LastCapture;
 ****************************************************************************/
 void InitTapeInterrupt (void){
 	
-	//Enable the clock to Wider Timer 0
-	HWREG(SYSCTL_RCGCWTIMER) |= SYSCTL_RCGCWTIMER_R0;
+	//Wide Timer 0A as a rising edge capture
+	if (!ClaimTimer(WT0_A, TIMER_MODE_CAPTURE, "tape"))
+	{
+		return;
+	}
 	
 	//Enable the clock to port C
 	HWREG(SYSCTL_RCGCGPIO) |= SYSCTL_RCGCGPIO_R2;
 	
-	//Make sure Timer A is disabled before configuring
-	HWREG(WTIMER0_BASE+TIMER_O_CTL) &= ~TIMER_CTL_TAEN;
-	
-	//Set it up to 32 bit wide, individual mode
-	HWREG(WTIMER0_BASE+TIMER_O_CFG) = TIMER_CFG_16_BIT;
-	
-	//Initialize the Interval Load register to 0xFFFFFFFF
-	HWREG(WTIMER0_BASE+TIMER_O_TAILR) = 0xffffffff;
-	
-	//Set up Timer A in capture mode, for edge time, up-counting
-	HWREG(WTIMER0_BASE+TIMER_O_TAMR) = (HWREG(WTIMER0_BASE+TIMER_O_TAMR) & ~TIMER_TAMR_TAAMS)|(TIMER_TAMR_TACDIR | TIMER_TAMR_TACMR | TIMER_TAMR_TAMR_CAP);
-	
-	//Set event to rising edge
-	HWREG(WTIMER0_BASE+TIMER_O_CTL) &= ~TIMER_CTL_TAEVENT_M;
-	
 	//Set up the port to do the capture
 	//Set the alternate function for PC4
 	HWREG(GPIO_PORTC_BASE+GPIO_O_AFSEL) |= BIT4HI;
@@ -74,15 +65,6 @@ void InitTapeInterrupt (void){
 	//Enable PC4 to be digital input
 	HWREG(GPIO_PORTC_BASE+GPIO_O_DEN) |= BIT4HI;
 	HWREG(GPIO_PORTC_BASE+GPIO_O_DIR) &= BIT4LO;
-	
-	//Enable a local capture interrupt
-	HWREG(WTIMER0_BASE+TIMER_O_IMR) |= TIMER_IMR_CAEIM;
-	
-	//Enable Timer A in Wide Timer 0 interrupt in the NVIC
-	HWREG(NVIC_EN2) |= BIT30HI;
-	
-	//Enable interrupts globally
-	__enable_irq();
 
 		printf("\r\nGot through tape interrupt init\r\n");
 }
@@ -97,7 +79,7 @@ void InitTapeInterrupt (void){
 void EnableTapeInterrupt(void)
 {
  //Kick the timer off and enable it to stall while stopped by the debugger
-	HWREG(WTIMER0_BASE+TIMER_O_CTL) |= (TIMER_CTL_TAEN | TIMER_CTL_TASTALL);
+	StartTimer(WT0_A);
 }
 
 /****************************************************************************
@@ -110,23 +92,28 @@ void EnableTapeInterrupt(void)
 void TapeInterruptResponse(void){
 	
 	uint32_t ThisCapture;
+	ES_Event ThisEvent;
+	
+	ES_ISR_ENTRY(ISR_TAPE);
 	
 	//Start by clearing out the source of the interrupt
 	HWREG(WTIMER0_BASE+TIMER_O_ICR) = TIMER_ICR_CAECINT;
 	
+	//Motors off first, the services hear about it from the event below
+	ES_UrgentRun(URGENT_STOP);
+	
 	//Get the captured value 
 	ThisCapture = HWREG(WTIMER0_BASE+TIMER_O_TAR);
+	ES_ISR_LATENCY(ISR_TAPE, HWREG(WTIMER0_BASE+TIMER_O_TAV) - ThisCapture);
 	
-	//Post event to ActionService
-	ES_Event ThisEvent;
+	//Publish the event with the capture, and the edge put on the
+	//framework clock: now, less how long ago it was captured.
+	//This ISR is above the critical ceiling, so PendSV does the publish
 	ThisEvent.EventType = TapeSensed;
-	ThisEvent.EventParam = END_RUN;
-	PostActionService(ThisEvent);
+	ThisEvent.EventParam = ThisCapture;
+	ES_EventSetTime(&ThisEvent, ES_Timer_GetTimeUS32() - (HWREG(WTIMER0_BASE+TIMER_O_TAV) - ThisCapture)/TicksPerUS);
+	ES_UrgentPublish(ThisEvent);
 	
-	LastCapture = ThisCapture;
-}
-
-uint32_t GetTapeSensedTime(void){
-	return LastCapture;
+	ES_ISR_EXIT(ISR_TAPE);
 }
 
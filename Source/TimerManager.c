@@ -0,0 +1,270 @@
+/****************************************************************************
+Timer Manager
+	Hands out the halves of the 32/64 bit wide timers and owns the registers
+	the two halves share (RCGC, CFG and CTL), so modules no longer configure
+	a timer block behind each other's back.
+
+	A module claims a channel for one mode at init; a second claim on the
+	same channel is refused and reported as a conflict. Channel ISRs still
+	clear their own interrupt and read their own TnR directly, since those
+	registers are not shared.
+
+	The 16/32 bit timers are not handed out here: TIMER5 belongs to
+	ES_ShortTimer.
+
+Events to receive:
+  None
+
+Events to post:
+	None
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdio.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_nvic.h"
+#include "BITDEFS.H"
+
+#include "TimerManager.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define NUM_TIMER_BLOCKS (NUM_TIMER_CHANNELS/2)
+
+// the B half of the mode, load, control and mask registers mirrors A
+#define B_REG_OFFSET 4
+#define B_BIT_SHIFT 8
+
+// first wide timer interrupt number, channels follow in order (A, B, A, ...)
+#define WTIMER0A_IRQ 94
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint32_t const BlockBase[NUM_TIMER_BLOCKS] = {
+	WTIMER0_BASE, WTIMER1_BASE, WTIMER2_BASE,
+	WTIMER3_BASE, WTIMER4_BASE, WTIMER5_BASE
+};
+
+static char const *ChannelOwner[NUM_TIMER_CHANNELS];
+static TimerMode_t ChannelMode[NUM_TIMER_CHANNELS];
+static uint8_t BlockConfigured = 0;
+static uint8_t Conflicts = 0;
+
+/*------------------------------ Module Code ------------------------------*/
+
+/****************************************************************************
+ Function
+     ClaimTimer
+
+ Parameters
+     TimerChannel_t Channel : timer half wanted
+     TimerMode_t Mode : how it will be used
+     char const *Owner : name reported in conflicts and allocation dumps
+
+ Returns
+     bool, false if the channel is already owned
+
+ Description
+     Clocks the block, configures the half for the mode, enables its local
+     and NVIC interrupt and leaves it stopped. Capture and edge count
+     channels also need their pin muxed by the caller
+****************************************************************************/
+bool ClaimTimer(TimerChannel_t Channel, TimerMode_t Mode, char const *Owner)
+{
+	uint8_t Block = Channel/2;
+	bool IsB = (Channel & 1);
+	uint32_t Base;
+	uint32_t RegOffset = IsB ? B_REG_OFFSET : 0;
+	uint8_t BitShift = IsB ? B_BIT_SHIFT : 0;
+	uint8_t IRQ = WTIMER0A_IRQ + Channel;
+	uint32_t Saved;
+
+	if (Channel >= NUM_TIMER_CHANNELS)
+	{
+		printf("\r\nTimer claim for invalid channel %d by %s\r\n", Channel, Owner);
+		Conflicts++;
+		return false;
+	}
+	if (ChannelOwner[Channel] != 0)
+	{
+		printf("\r\nTimer conflict: WT%d%c wanted by %s, owned by %s\r\n",
+		       Block, IsB ? 'B' : 'A', Owner, ChannelOwner[Channel]);
+		Conflicts++;
+		return false;
+	}
+	ChannelOwner[Channel] = Owner;
+	ChannelMode[Channel] = Mode;
+	Base = BlockBase[Block];
+
+	if ((BlockConfigured & (1 << Block)) == 0)
+	{
+		//Enable the clock to the wide timer
+		HWREG(SYSCTL_RCGCWTIMER) |= (1u << Block);
+
+		//Kill a few cycles to let the clock get going
+		while((HWREG(SYSCTL_PRWTIMER) & (1u << Block)) != (1u << Block)){}
+
+		//Both halves off while the shared configuration is written
+		HWREG(Base+TIMER_O_CTL) &= ~(TIMER_CTL_TAEN | TIMER_CTL_TBEN);
+
+		//Set it up to 32 bit wide, individual mode, the only split we hand out
+		HWREG(Base+TIMER_O_CFG) = TIMER_CFG_16_BIT;
+		BlockConfigured |= (1 << Block);
+	}
+
+	//Make sure this half is disabled before configuring, the other half may be running
+	Saved = ES_EnterCriticalAll();
+	HWREG(Base+TIMER_O_CTL) &= ~(TIMER_CTL_TAEN << BitShift);
+	ES_ExitCriticalAll(Saved);
+
+	switch (Mode)
+	{
+		case TIMER_MODE_CAPTURE:
+		case TIMER_MODE_CAPTURE_DMA:
+			//Initialize the Interval Load register to 0xFFFFFFFF
+			HWREG(Base+TIMER_O_TAILR+RegOffset) = 0xffffffff;
+			//Capture mode, for edge time, up-counting
+			HWREG(Base+TIMER_O_TAMR+RegOffset) = (HWREG(Base+TIMER_O_TAMR+RegOffset) & ~TIMER_TAMR_TAAMS)
+			                                     | (TIMER_TAMR_TACDIR | TIMER_TAMR_TACMR | TIMER_TAMR_TAMR_CAP);
+			//Set event to rising edge
+			Saved = ES_EnterCriticalAll();
+			HWREG(Base+TIMER_O_CTL) &= ~(TIMER_CTL_TAEVENT_M << BitShift);
+			ES_ExitCriticalAll(Saved);
+			//Enable a local capture interrupt. A DMA capture leaves it masked:
+			//the raw capture event still requests the transfer, and the
+			//channel interrupt only comes from the uDMA done
+			if (Mode == TIMER_MODE_CAPTURE)
+			{
+				HWREG(Base+TIMER_O_IMR) |= (TIMER_IMR_CAEIM << BitShift);
+			}
+			break;
+
+		case TIMER_MODE_EDGE_COUNT:
+			//Count up from 0. An edge count stops at the match value, so put
+			//it where the count would take days to reach at beacon rates
+			HWREG(Base+TIMER_O_TAILR+RegOffset) = 0xffffffff;
+			HWREG(Base+TIMER_O_TAMATCHR+RegOffset) = 0xffffffff;
+			//Capture mode without TACMR is edge count
+			HWREG(Base+TIMER_O_TAMR+RegOffset) = (HWREG(Base+TIMER_O_TAMR+RegOffset) & ~(TIMER_TAMR_TAAMS | TIMER_TAMR_TACMR))
+			                                     | (TIMER_TAMR_TACDIR | TIMER_TAMR_TAMR_CAP);
+			//Count rising edges
+			Saved = ES_EnterCriticalAll();
+			HWREG(Base+TIMER_O_CTL) &= ~(TIMER_CTL_TAEVENT_M << BitShift);
+			ES_ExitCriticalAll(Saved);
+			//The owner reads the count when it wants it, nothing to interrupt for
+			break;
+
+		case TIMER_MODE_ONE_SHOT:
+			HWREG(Base+TIMER_O_TAMR+RegOffset) = (HWREG(Base+TIMER_O_TAMR+RegOffset) & ~TIMER_TAMR_TAMR_M) | TIMER_TAMR_TAMR_1_SHOT;
+			//Enable a local timeout interrupt
+			HWREG(Base+TIMER_O_IMR) |= (TIMER_IMR_TATOIM << BitShift);
+			break;
+
+		case TIMER_MODE_PERIODIC:
+			HWREG(Base+TIMER_O_TAMR+RegOffset) = (HWREG(Base+TIMER_O_TAMR+RegOffset) & ~TIMER_TAMR_TAMR_M) | TIMER_TAMR_TAMR_PERIOD;
+			//Enable a local timeout interrupt
+			HWREG(Base+TIMER_O_IMR) |= (TIMER_IMR_TATOIM << BitShift);
+			break;
+
+		case TIMER_MODE_ADC_TRIGGER:
+			HWREG(Base+TIMER_O_TAMR+RegOffset) = (HWREG(Base+TIMER_O_TAMR+RegOffset) & ~TIMER_TAMR_TAMR_M) | TIMER_TAMR_TAMR_PERIOD;
+			//Each timeout starts the ADC sequences set for a timer trigger
+			Saved = ES_EnterCriticalAll();
+			HWREG(Base+TIMER_O_CTL) |= (TIMER_CTL_TAOTE << BitShift);
+			ES_ExitCriticalAll(Saved);
+			break;
+	}
+
+	//Enable the channel interrupt in the NVIC, for the modes that have one
+	if ((Mode != TIMER_MODE_EDGE_COUNT) && (Mode != TIMER_MODE_ADC_TRIGGER))
+	{
+		HWREG(NVIC_EN0 + (IRQ/32)*4) |= (1u << (IRQ % 32));
+	}
+
+	//Enable interrupts globally
+	__enable_irq();
+
+	return true;
+}
+
+/****************************************************************************
+ Function
+     SetTimerLoad
+
+ Description
+     Interval for one-shot and periodic channels, used on the next start
+****************************************************************************/
+void SetTimerLoad(TimerChannel_t Channel, uint32_t Ticks)
+{
+	HWREG(BlockBase[Channel/2]+TIMER_O_TAILR+((Channel & 1) ? B_REG_OFFSET : 0)) = Ticks;
+}
+
+/****************************************************************************
+ Function
+     StartTimer
+
+ Description
+     Kick the channel off and let it stall while stopped by the debugger.
+     CTL is shared with the other half, which may be changing it from an
+     ISR, so the read-modify-write is done with interrupts off. All of
+     them: the urgent stop stops a channel from a safety ISR
+****************************************************************************/
+void StartTimer(TimerChannel_t Channel)
+{
+	uint32_t Saved;
+	uint8_t BitShift = (Channel & 1) ? B_BIT_SHIFT : 0;
+
+	Saved = ES_EnterCriticalAll();
+	HWREG(BlockBase[Channel/2]+TIMER_O_CTL) |= ((TIMER_CTL_TAEN | TIMER_CTL_TASTALL) << BitShift);
+	ES_ExitCriticalAll(Saved);
+}
+
+/****************************************************************************
+ Function
+     StopTimer
+****************************************************************************/
+void StopTimer(TimerChannel_t Channel)
+{
+	uint32_t Saved;
+	uint8_t BitShift = (Channel & 1) ? B_BIT_SHIFT : 0;
+
+	Saved = ES_EnterCriticalAll();
+	HWREG(BlockBase[Channel/2]+TIMER_O_CTL) &= ~(TIMER_CTL_TAEN << BitShift);
+	ES_ExitCriticalAll(Saved);
+}
+
+/****************************************************************************
+ Function
+     GetTimerConflicts
+
+ Returns
+     uint8_t number of refused claims since reset, 0 on a healthy build
+****************************************************************************/
+uint8_t GetTimerConflicts(void)
+{
+	return Conflicts;
+}
+
+/****************************************************************************
+ Function
+     PrintTimerAllocations
+****************************************************************************/
+void PrintTimerAllocations(void)
+{
+	static char const *ModeName[] = {"capture", "capture DMA", "edge count", "one-shot", "periodic",
+	                                     "ADC trigger"};
+	uint8_t Channel;
+
+	printf("\r\nWide timer allocations (%d conflicts)\r\n", Conflicts);
+	for (Channel = 0; Channel < NUM_TIMER_CHANNELS; Channel++)
+	{
+		if (ChannelOwner[Channel] != 0)
+		{
+			printf("  WT%d%c %-11s %s\r\n", Channel/2, (Channel & 1) ? 'B' : 'A',
+			       ModeName[ChannelMode[Channel]], ChannelOwner[Channel]);
+		}
+	}
+}